@@ -233,6 +233,8 @@ void Document::clear()
 	scriptsData.clear();
 
 	basis.clear();
+	validator.invalidate();
+	vertmod.invalidateIndex();
 
 	// TODO: other modules
 	Clipboard_ClearLocals();
@@ -71,14 +71,17 @@ public:
 	VertexModule vertmod;
 	SectorModule secmod;
 	ObjectsModule objects;
+	LiveValidator validator;
 
 	explicit Document(Instance &inst) : inst(inst),
 	behaviorData(EMPTY_ACS_BINARY, EMPTY_ACS_BINARY + sizeof(EMPTY_ACS_BINARY)), basis(*this),
-	checks(*this), hover(*this), linemod(*this), vertmod(*this), secmod(*this), objects(*this)
+	checks(*this), hover(*this), linemod(*this), vertmod(*this), secmod(*this), objects(*this),
+	validator(*this)
 	{
 	}
 
-	Document(Document &&other) noexcept : inst(other.inst), basis(*this), checks(*this), hover(*this), linemod(*this), vertmod(*this), secmod(*this), objects(*this)
+	Document(Document &&other) noexcept : inst(other.inst), basis(*this), checks(*this), hover(*this), linemod(*this), vertmod(*this), secmod(*this), objects(*this),
+	validator(*this)
 	{
 		*this = std::move(other);
 	}
@@ -98,6 +101,8 @@ public:
 		mMadeChanges = other.mMadeChanges;
 		// TODO: basis
 		basis = std::move(other.basis);
+		validator.invalidate();
+		vertmod.invalidateIndex();
 		return *this;
 	}
 
@@ -0,0 +1,237 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 Ioan Chera
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "ImageMap.h"
+
+#include "w_rawdef.h"
+
+#include <algorithm>
+#include <ctype.h>
+
+//
+// Keeps the table at most 3/4 full
+//
+void HashSlots::insert(uint64_t key, int index, size_t count)
+{
+	if ((count + 1) * 4 > slots.size() * 3)
+		rehash(std::max<size_t>(64, slots.size() * 2));
+
+	size_t pos = start(key);
+	while (slots[pos].index != EMPTY)
+		pos = next(pos);
+
+	slots[pos].key = key;
+	slots[pos].index = index;
+}
+
+
+void HashSlots::rehash(size_t new_size)
+{
+	std::vector<Slot> old_slots;
+	old_slots.swap(slots);
+
+	slots.resize(new_size);
+
+	shift = 64;
+	for (size_t n = new_size; n > 1; n >>= 1)
+		shift--;
+
+	for (const Slot &slot : old_slots)
+	{
+		if (slot.index == EMPTY)
+			continue;
+
+		size_t pos = start(slot.key);
+		while (slots[pos].index != EMPTY)
+			pos = next(pos);
+
+		slots[pos] = slot;
+	}
+}
+
+
+//------------------------------------------------------------------------
+
+static inline char NormalizeChar(char ch)
+{
+	// same as NormalizeTex()
+	return ch == '"' ? '_' : static_cast<char>(toupper(ch));
+}
+
+
+//
+// Whether 'stored' is what NormalizeTex() makes of 'name'
+//
+static bool MatchesNormalized(const SString &stored, const SString &name)
+{
+	size_t len = std::min(name.length(), static_cast<size_t>(WAD_TEX_NAME));
+
+	if (stored.length() != len || len == 0)
+		return false;
+
+	for (size_t i = 0; i < len; i++)
+		if (stored[i] != NormalizeChar(name[i]))
+			return false;
+
+	return true;
+}
+
+
+//
+// Like Lump_c::getName8, but uppercase, so that all spellings of a name
+// share a key
+//
+uint64_t ImageMap::nameKey(const SString &name) noexcept
+{
+	uint64_t key = 0;
+
+	for (size_t i = 0; i < WAD_TEX_NAME && i < name.length(); i++)
+		key |= static_cast<uint64_t>(static_cast<unsigned char>(NormalizeChar(name[i]))) << (i * 8);
+
+	return key;
+}
+
+
+const ImageMap::Entry *ImageMap::findExact(uint64_t key, const SString &name) const noexcept
+{
+	if (hash.empty())
+		return nullptr;
+
+	for (size_t pos = hash.start(key); hash[pos].index != HashSlots::EMPTY; pos = hash.next(pos))
+	{
+		if (hash[pos].key != key)
+			continue;
+
+		const Entry &entry = entries[hash[pos].index];
+		if (entry.name == name)
+			return &entry;
+	}
+
+	return nullptr;
+}
+
+
+Img_c &ImageMap::set(const SString &name, Img_c &&img)
+{
+	uint64_t key = nameKey(name);
+
+	const Entry *existing = findExact(key, name);
+	if (existing)
+	{
+		Img_c &target = const_cast<Entry *>(existing)->img;
+		target = std::move(img);
+		return target;
+	}
+
+	hash.insert(key, static_cast<int>(entries.size()), entries.size());
+	entries.push_back({ name, std::move(img) });
+
+	return entries.back().img;
+}
+
+
+const Img_c *ImageMap::find(const SString &name, bool try_uppercase) const noexcept
+{
+	if (hash.empty())
+		return nullptr;
+
+	uint64_t key = nameKey(name);
+	const Entry *normalized = nullptr;
+
+	for (size_t pos = hash.start(key); hash[pos].index != HashSlots::EMPTY; pos = hash.next(pos))
+	{
+		if (hash[pos].key != key)
+			continue;
+
+		const Entry &entry = entries[hash[pos].index];
+
+		if (entry.name == name)
+			return &entry.img;
+
+		if (try_uppercase && ! normalized && MatchesNormalized(entry.name, name))
+			normalized = &entry;
+	}
+
+	return normalized ? &normalized->img : nullptr;
+}
+
+
+void ImageMap::clear()
+{
+	entries.clear();
+	hash.clear();
+	sorted_entries.clear();
+}
+
+
+const std::vector<const ImageMap::Entry *> &ImageMap::sorted() const
+{
+	if (sorted_entries.size() != entries.size())
+	{
+		sorted_entries.clear();
+		sorted_entries.reserve(entries.size());
+
+		for (const Entry &entry : entries)
+			sorted_entries.push_back(&entry);
+
+		std::sort(sorted_entries.begin(), sorted_entries.end(),
+				  [](const Entry *a, const Entry *b)
+				  {
+					  return a->name < b->name;
+				  });
+	}
+
+	return sorted_entries;
+}
+
+
+//------------------------------------------------------------------------
+
+const std::vector<Img_c> *SpriteMap::find(int type) const noexcept
+{
+	if (hash.empty())
+		return nullptr;
+
+	uint64_t key = static_cast<uint32_t>(type);
+
+	for (size_t pos = hash.start(key); hash[pos].index != HashSlots::EMPTY; pos = hash.next(pos))
+		if (hash[pos].key == key)
+			return &sprites[hash[pos].index];
+
+	return nullptr;
+}
+
+
+std::vector<Img_c> &SpriteMap::set(int type, std::vector<Img_c> &&images)
+{
+	const std::vector<Img_c> *existing = find(type);
+	if (existing)
+	{
+		std::vector<Img_c> &target = const_cast<std::vector<Img_c> &>(*existing);
+		target = std::move(images);
+		return target;
+	}
+
+	hash.insert(static_cast<uint32_t>(type), static_cast<int>(sprites.size()), sprites.size());
+	sprites.push_back(std::move(images));
+
+	return sprites.back();
+}
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
@@ -0,0 +1,194 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 Ioan Chera
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#ifndef ImageMap_h
+#define ImageMap_h
+
+#include "im_img.h"
+#include "m_strings.h"
+
+#include <deque>
+#include <stdint.h>
+#include <vector>
+
+//
+// Open-addressing index from 64-bit keys to positions in a container.
+// Several positions may share a key, lookups walk the probe sequence until
+// an empty slot.
+//
+class HashSlots
+{
+public:
+	static constexpr int EMPTY = -1;
+
+	struct Slot
+	{
+		uint64_t key = 0;
+		int index = EMPTY;
+	};
+
+	// 'count' is the number of positions already in the index
+	void insert(uint64_t key, int index, size_t count);
+
+	void clear()
+	{
+		slots.clear();
+		shift = 64;
+	}
+
+	bool empty() const noexcept
+	{
+		return slots.empty();
+	}
+
+	size_t start(uint64_t key) const noexcept
+	{
+		// Fibonacci hashing, the top bits are the best mixed
+		return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> shift);
+	}
+
+	size_t next(size_t pos) const noexcept
+	{
+		return (pos + 1) & (slots.size() - 1);
+	}
+
+	const Slot &operator[](size_t pos) const noexcept
+	{
+		return slots[pos];
+	}
+
+private:
+	void rehash(size_t new_size);
+
+	std::vector<Slot> slots;	// size is a power of two
+	int shift = 64;
+};
+
+//
+// Images by lump name. The hash key is the name uppercased and packed into
+// 64 bits, so the exact name and its NormalizeTex() form are found with a
+// single probe. Images live in a deque, so pointers to them stay valid as
+// more get added.
+//
+class ImageMap
+{
+public:
+	struct Entry
+	{
+		SString name;
+		Img_c img;
+	};
+
+	ImageMap() = default;
+	ImageMap(const ImageMap &other) : entries(other.entries), hash(other.hash)
+	{
+	}
+	ImageMap(ImageMap &&other) = default;
+	ImageMap &operator = (const ImageMap &other)
+	{
+		entries = other.entries;
+		hash = other.hash;
+		sorted_entries.clear();
+		return *this;
+	}
+	ImageMap &operator = (ImageMap &&other) = default;
+
+	// replaces any image with the same name
+	Img_c &set(const SString &name, Img_c &&img);
+
+	// when try_uppercase is set, also accepts NormalizeTex(name)
+	const Img_c *find(const SString &name, bool try_uppercase = false) const noexcept;
+
+	void clear();
+
+	size_t size() const noexcept
+	{
+		return entries.size();
+	}
+
+	// insertion order
+	std::deque<Entry>::iterator begin()
+	{
+		return entries.begin();
+	}
+	std::deque<Entry>::iterator end()
+	{
+		return entries.end();
+	}
+	std::deque<Entry>::const_iterator begin() const
+	{
+		return entries.begin();
+	}
+	std::deque<Entry>::const_iterator end() const
+	{
+		return entries.end();
+	}
+
+	// sorted by name, for the browser
+	const std::vector<const Entry *> &sorted() const;
+
+	static uint64_t nameKey(const SString &name) noexcept;
+
+private:
+	const Entry *findExact(uint64_t key, const SString &name) const noexcept;
+
+	std::deque<Entry> entries;
+	HashSlots hash;
+
+	// rebuilt when its size no longer matches, since entries are never
+	// removed one by one
+	mutable std::vector<const Entry *> sorted_entries;
+};
+
+//
+// Sprite images by thing type, one or eight (for each rotation). An empty
+// list means the sprite wasn't found.
+//
+class SpriteMap
+{
+public:
+	const std::vector<Img_c> *find(int type) const noexcept;
+
+	// replaces any sprite of the same type
+	std::vector<Img_c> &set(int type, std::vector<Img_c> &&images);
+
+	void clear()
+	{
+		sprites.clear();
+		hash.clear();
+	}
+
+	std::deque<std::vector<Img_c>>::iterator begin()
+	{
+		return sprites.begin();
+	}
+	std::deque<std::vector<Img_c>>::iterator end()
+	{
+		return sprites.end();
+	}
+
+private:
+	// the hash key is the type itself
+	std::deque<std::vector<Img_c>> sprites;
+	HashSlots hash;
+};
+
+#endif
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
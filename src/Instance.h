@@ -288,7 +288,7 @@ public:
 	bool ExecuteKey(keycode_t key, KeyContext context);
 
 	// M_LOADSAVE
-	NewDocument openDocument(const LoadingData &inLoading, const Wad_file &wad, int level);
+	NewDocument openDocument(const LoadingData &inLoading, const Wad_file &wad, int level, bool saveSnapshot = true);
 	void LoadLevel(const Wad_file *wad, const SString &level) noexcept(false);
 	void LoadLevelNum(const Wad_file *wad, int lev_num) noexcept(false);
 	bool MissingIWAD_Dialog();
@@ -502,6 +502,8 @@ public:	// will be private when we encapsulate everything
 	int moved_vertex_count = 0;
 	int new_vertex_minimum = 0;
 	bool recalc_map_bounds = false;
+	// bumped whenever the map (or what it is drawn with) changes
+	unsigned map_revision = 0;
 	// the containers for the textures (etc)
 	Recently_used recent_flats{ *this };
 	Recently_used recent_textures{ *this };
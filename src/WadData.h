@@ -21,6 +21,7 @@
 
 #include "im_color.h"
 #include "im_img.h"
+#include "ImageMap.h"
 #include "m_strings.h"
 #include "sys_type.h"
 
@@ -41,8 +42,51 @@ struct ConfigData;
 struct LoadingData;
 struct SpriteLumpRef;
 
-// maps type number to an image
-typedef std::map<int, std::vector<Img_c>> sprite_map_t;	// can have one or eight images
+//
+// How a texture or flat name was resolved for drawing
+//
+enum class ImageResolve
+{
+	unresolved,
+	found,
+	sky,		// sky flat, no image
+	missing,	// "-" texture, img is the missing texture
+	special,	// "#xxxx" texture, img is the special texture
+	unknown		// not found, img is the unknown texture or flat
+};
+
+struct ResolvedImage
+{
+	Img_c *img = nullptr;
+	ImageResolve how = ImageResolve::unresolved;
+};
+
+//
+// Renderer lookups indexed by StringID. The pointers are only valid for the
+// ImageSet which filled it, so copies start out empty.
+//
+class ImageResolveCache
+{
+public:
+	ImageResolveCache() = default;
+	ImageResolveCache(const ImageResolveCache &)
+	{
+	}
+	ImageResolveCache &operator = (const ImageResolveCache &)
+	{
+		clear();
+		return *this;
+	}
+
+	void clear()
+	{
+		flats.clear();
+		textures.clear();
+	}
+
+	std::vector<ResolvedImage> flats;
+	std::vector<ResolvedImage> textures;
+};
 
 //
 // Wad image set
@@ -88,7 +132,7 @@ public:
 	bool W_TextureCausesMedusa(const SString &name) const;
 	bool W_TextureIsKnown(const ConfigData &config, const SString &name) const;
 	void W_ClearTextures();
-	const std::map<SString, Img_c> &getTextures() const
+	const ImageMap &getTextures() const
 	{
 		return textures;
 	}
@@ -101,7 +145,7 @@ public:
 	}
 	bool W_FlatIsKnown(const ConfigData &config, const SString &name) const;
 	void W_ClearFlats();
-	const std::map<SString, Img_c> &getFlats() const
+	const ImageMap &getFlats() const
 	{
 		return flats;
 	}
@@ -110,15 +154,23 @@ public:
 
 	void W_UnloadAllTextures();
 
+	ResolvedImage resolveTexture(const ConfigData &config, const Palette &palette, StringID name);
+	ResolvedImage resolveFlat(const ConfigData &config, StringID name);
+	bool isSkyFlat(const ConfigData &config, StringID name)
+	{
+		return resolveFlat(config, name).how == ImageResolve::sky;
+	}
+
 public: // TODO: make private
-	sprite_map_t sprites;
+	SpriteMap sprites;
 
 private:	
-	std::map<SString, Img_c> textures;
+	ImageMap textures;
 	// textures which can cause the Medusa Effect in vanilla/chocolate DOOM
 	std::map<SString, int> medusa_textures;
-	std::map<SString, Img_c> flats;
-	
+	ImageMap flats;
+
+	ImageResolveCache resolved;
 
 	int missing_tex_color = 0;
 	std::optional<Img_c> missing_tex_image;
@@ -696,7 +696,9 @@ void Basis::EditUnit::rawChange(Basis &basis)
 	basis.mDidMakeChanges = true;
 
 	basis.inst.MapStuff_NotifyChange(objtype, objnum, field);
-	Render3D_NotifyChange(objtype, objnum, field);
+	basis.doc.validator.notifyChange(objtype, objnum);
+	basis.doc.vertmod.notifyChange(objtype, objnum);
+	Render3D_NotifyChange(basis.inst, objtype, objnum, field);
 	basis.inst.ObjectBox_NotifyChange(objtype, objnum);
 }
 
@@ -711,7 +713,9 @@ void Basis::EditUnit::rawDelete(Basis &basis)
 	Clipboard_NotifyDelete(objtype, objnum);
 	basis.inst.Selection_NotifyDelete(objtype, objnum);
 	basis.inst.MapStuff_NotifyDelete(objtype, objnum);
-	Render3D_NotifyDelete(basis.doc, objtype, objnum);
+	basis.doc.validator.notifyDelete(objtype, objnum);
+	basis.doc.vertmod.notifyDelete(objtype, objnum);
+	Render3D_NotifyDelete(basis.inst, objtype, objnum);
 	basis.inst.ObjectBox_NotifyDelete(objtype, objnum);
 
 	switch(objtype)
@@ -863,7 +867,9 @@ void Basis::EditUnit::rawInsert(Basis &basis)
 	Clipboard_NotifyInsert(basis.doc, objtype, objnum);
 	basis.inst.Selection_NotifyInsert(objtype, objnum);
 	basis.inst.MapStuff_NotifyInsert(objtype, objnum);
-	Render3D_NotifyInsert(objtype, objnum);
+	basis.doc.validator.notifyInsert(objtype, objnum);
+	basis.doc.vertmod.notifyInsert(objtype, objnum);
+	Render3D_NotifyInsert(basis.inst, objtype, objnum);
 	basis.inst.ObjectBox_NotifyInsert(objtype, objnum);
 
 	switch(objtype)
@@ -1088,6 +1094,8 @@ void Basis::doClearChangeStatus()
 //
 void Basis::doProcessChangeStatus() const
 {
+	doc.validator.notifyEnd();
+
 	if(mDidMakeChanges)
 	{
 		// TODO: the other modules
@@ -29,6 +29,10 @@
 #include "main.h"
 
 #include <algorithm>
+#include <chrono>
+#include <functional>
+#include <numeric>
+#include <unordered_set>
 
 #include "e_checks.h"
 #include "e_cutpaste.h"
@@ -36,6 +40,7 @@
 #include "e_main.h"
 #include "e_path.h"
 #include "e_vertex.h"
+#include "lib_parallel.h"
 #include "LineDef.h"
 #include "m_game.h"
 #include "e_objects.h"
@@ -56,6 +61,151 @@
 
 //------------------------------------------------------------------------
 
+//
+// What a single find-pass produced. Not all fields are used by every pass.
+//
+struct CheckFinding
+{
+	selection_c sel;
+	selection_c other;
+
+	std::map<int, int> types;
+	std::map<SString, int> names;
+
+	int value = 0;
+	int extra = 0;
+
+	int severity = 0;	// of the pass, when it finds anything
+	double millis = 0;	// how long the pass took
+};
+
+//
+// The find-passes of one or more check categories. They only read the level,
+// so they are run concurrently, then the dialogs take the findings in the
+// same order the passes were added.
+//
+class CheckPassList
+{
+public:
+	typedef std::function<void(CheckFinding &finding)> Pass;
+
+	// mainThread: for passes which may log or otherwise touch global state
+	void add(const char *name, int severity, Pass &&pass, bool mainThread = false)
+	{
+		entries.push_back({ name, severity, std::move(pass), mainThread, CheckFinding() });
+	}
+
+	void run()
+	{
+		runAll({ this });
+	}
+
+	static void runAll(const std::vector<CheckPassList *> &lists);
+
+	const CheckFinding &next()
+	{
+		SYS_ASSERT(cursor < entries.size());
+		return entries[cursor++].finding;
+	}
+
+	void visit(const std::function<void(const char *name, const CheckFinding &finding)> &func) const
+	{
+		for (const Entry &entry : entries)
+			func(entry.name, entry.finding);
+	}
+
+	double totalMillis() const
+	{
+		return millis;
+	}
+
+	// the user fixed something while looking at these findings
+	void markMapChanged()
+	{
+		mapChanged = true;
+	}
+
+	bool hasMapChanged() const
+	{
+		return mapChanged;
+	}
+
+private:
+	struct Entry
+	{
+		const char *name;
+		int severity;
+		Pass pass;
+		bool mainThread;
+		CheckFinding finding;
+	};
+
+	std::vector<Entry> entries;
+	size_t cursor = 0;
+
+	double millis = 0;	// wall time of the run
+	bool mapChanged = false;
+};
+
+
+void CheckPassList::runAll(const std::vector<CheckPassList *> &lists)
+{
+	typedef std::chrono::steady_clock clock;
+
+	std::vector<Entry *> parallel;
+	std::vector<Entry *> serial;
+
+	for (CheckPassList *list : lists)
+	{
+		list->cursor = 0;
+
+		for (Entry &entry : list->entries)
+		{
+			entry.finding = CheckFinding();
+			entry.finding.severity = entry.severity;
+
+			if (entry.mainThread)
+				serial.push_back(&entry);
+			else
+				parallel.push_back(&entry);
+		}
+	}
+
+	auto timePass = [](Entry &entry)
+	{
+		clock::time_point start = clock::now();
+
+		entry.pass(entry.finding);
+
+		entry.finding.millis = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+	};
+
+	clock::time_point start = clock::now();
+
+	ParallelFor((int)parallel.size(), [&](int index)
+	{
+		timePass(*parallel[index]);
+	});
+
+	for (Entry *entry : serial)
+		timePass(*entry);
+
+	double total = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+	for (CheckPassList *list : lists)
+	{
+		list->millis = total;
+
+		for (const Entry &entry : list->entries)
+			gLog.debugPrintf("Check '%s' took %.2f ms\n", entry.name, entry.finding.millis);
+	}
+
+	gLog.debugPrintf("Ran %d check passes in %.2f ms on %d threads\n",
+					 (int)(parallel.size() + serial.size()), total, ParallelThreadCount());
+}
+
+//------------------------------------------------------------------------
+
 class UI_Check_base : public UI_Escapable_Window
 {
 protected:
@@ -68,6 +218,9 @@ protected:
 	int cy;
 	int worst_severity;
 
+	Fl_Box *time_box;
+	double line_millis;		// time of the pass behind the next line
+
 private:
 	static void close_callback(Fl_Widget *, void *);
 
@@ -85,6 +238,9 @@ public:
 		const char *button2 = NULL, Fl_Callback *cb2 = NULL,
 		const char *button3 = NULL, Fl_Callback *cb3 = NULL);
 
+	const CheckFinding &TakeFinding(CheckPassList &passes);
+	void ShowTiming(const CheckPassList &passes);
+
 	CheckResult  Run();
 
 	int WorstSeverity() const { return worst_severity; }
@@ -107,7 +263,7 @@ UI_Check_base::UI_Check_base(int W, int H, bool all_mode,
                              const char *L, const char *header_txt) :
 	UI_Escapable_Window(W, H, L),
 	want_close(false), user_action(CheckResult::ok),
-	worst_severity(0)
+	worst_severity(0), line_millis(-1)
 {
 	cy = 10;
 
@@ -132,6 +288,10 @@ UI_Check_base::UI_Check_base(int W, int H, bool all_mode,
 
 	  int but_W = all_mode ? 110 : 70;
 
+	  time_box = new Fl_Box(FL_NO_BOX, 10, ey + 18, w()/2 - but_W/2 - 20, 34, NULL);
+	  time_box->align(FL_ALIGN_LEFT | FL_ALIGN_INSIDE);
+	  time_box->labelsize(FL_NORMAL_SIZE - 2);
+
 	  { Fl_Button *ok_but;
 
 	    ok_but = new Fl_Button(w()/2 - but_W/2, ey + 18, but_W, 34,
@@ -195,6 +355,12 @@ void UI_Check_base::AddLine(
 		box->labelfont(FL_HELVETICA_BOLD);
 	}
 
+	if (line_millis >= 0)
+	{
+		box->copy_tooltip(SString::printf("Found in %.1f ms", line_millis).c_str());
+		line_millis = -1;
+	}
+
 	line_group->add(box);
 
 	cx += W;
@@ -234,6 +400,25 @@ void UI_Check_base::AddLine(
 }
 
 
+//
+// Get the next finding, remembering its time for the next AddLine
+//
+const CheckFinding &UI_Check_base::TakeFinding(CheckPassList &passes)
+{
+	const CheckFinding &finding = passes.next();
+
+	line_millis = finding.millis;
+
+	return finding;
+}
+
+
+void UI_Check_base::ShowTiming(const CheckPassList &passes)
+{
+	time_box->copy_label(SString::printf("Checked in %.1f ms", passes.totalMillis()).c_str());
+}
+
+
 CheckResult UI_Check_base::Run()
 {
 	set_modal();
@@ -306,114 +491,68 @@ static void Vertex_ShowDanglers(Instance &inst)
 }
 
 
-struct vertex_X_CMP_pred
-{
-	const Document &doc;
-	explicit vertex_X_CMP_pred(const Document &doc) : doc(doc)
-	{
-	}
-
-	inline bool operator() (int A, int B) const
-	{
-		const auto V1 = doc.vertices[A];
-		const auto V2 = doc.vertices[B];
-
-		return V1->xf < V2->xf;
-	}
-};
-
-
-void Vertex_FindOverlaps(selection_c& sel, const Document &doc)
+//
+// Finds the vertices sitting on the same spot as an earlier vertex.
+// When given, 'bases' receives the lowest numbered vertex at each spot.
+//
+void Vertex_FindOverlaps(selection_c& sel, const Document &doc, std::vector<int> *bases)
 {
 	// NOTE: when two or more vertices share the same coordinates,
 	//       only the second and subsequent ones are stored in 'sel'.
 
 	sel.change_type(ObjType::vertices);
 
+	if (bases)
+		bases->assign(doc.numVertices(), -1);
+
 	if (doc.numVertices() < 2)
 		return;
 
-	// sort the vertices into order of the 'X' value.
-	// hence any overlapping vertices will be near each other.
-
-	std::vector<int> sorted_list(doc.numVertices(), 0);
-
-	for (int i = 0 ; i < doc.numVertices(); i++)
-		sorted_list[i] = i;
-
-	std::sort(sorted_list.begin(), sorted_list.end(), vertex_X_CMP_pred(doc));
+	VertexCoordIndex index;
 
-#define VERT_K  doc.vertices[sorted_list[k]]
-#define VERT_N  doc.vertices[sorted_list[n]]
-
-	for (int k = 0 ; k < doc.numVertices(); k++)
-	{
-		for (int n = k + 1 ; n < doc.numVertices() && VERT_N->xf == VERT_K->xf ; n++)
-		{
-			if (VERT_N->yf == VERT_K->yf)
-			{
-				sel.set(sorted_list[k]);
-			}
-		}
-	}
-
-#undef VERT_K
-#undef VERT_N
-}
-
-
-static void Vertex_MergeOne(EditOperation &op, int idx, selection_c& merge_verts, Document &doc)
-{
-	const auto V = doc.vertices[idx];
-
-	// find the base vertex (the one V is sitting on)
 	for (int n = 0 ; n < doc.numVertices(); n++)
 	{
-		if (n == idx)
-			continue;
-
-		// skip any in the merge list
-		if (merge_verts.get(n))
-			continue;
-
-		const auto N = doc.vertices[n];
-
-		if (*N != *V)
-			continue;
+		v2double_t pos = doc.vertices[n]->xy();
 
-		// Ok, found it, so update linedefs
+		int base = index.find(pos);
 
-		for (int ld = 0 ; ld < doc.numLinedefs(); ld++)
+		if (base < 0)
 		{
-			const auto L = doc.linedefs[ld];
-
-			if (L->start == idx)
-				op.changeLinedef(ld, &LineDef::start, n);
-
-			if (L->end == idx)
-				op.changeLinedef(ld, &LineDef::end, n);
+			index.add(n, pos);
+			continue;
 		}
 
-		return;
-	}
+		sel.set(n);
 
-	// SHOULD NOT GET HERE
-	gLog.printf("VERTEX MERGE FAILURE.\n");
+		if (bases)
+			(*bases)[n] = base;
+	}
 }
 
 
 static void Vertex_MergeOverlaps(Instance &inst)
 {
+	const Document &doc = inst.level;
+
 	selection_c verts;
-	Vertex_FindOverlaps(verts, inst.level);
+	std::vector<int> bases;
+
+	Vertex_FindOverlaps(verts, doc, &bases);
 
 	{
 		EditOperation op(inst.level.basis);
 		op.setMessage("merged overlapping vertices");
 
-		for (sel_iter_c it(verts) ; !it.done() ; it.next())
+		// move the linedefs onto the base vertex of each spot
+		for (int ld = 0 ; ld < doc.numLinedefs(); ld++)
 		{
-			Vertex_MergeOne(op, *it, verts, inst.level);
+			const auto L = doc.linedefs[ld];
+
+			if (bases[L->start] >= 0)
+				op.changeLinedef(ld, &LineDef::start, bases[L->start]);
+
+			if (bases[L->end] >= 0)
+				op.changeLinedef(ld, &LineDef::end, bases[L->end]);
 		}
 
 		// nothing should reference these vertices now
@@ -525,52 +664,82 @@ private:
 };
 
 
-CheckResult ChecksModule::checkVertices(int min_severity) const
+void ChecksModule::addVertexPasses(CheckPassList &passes) const
+{
+	const Document &doc = this->doc;
+
+	passes.add("overlapping vertices", 2, [&doc](CheckFinding &found)
+	{
+		Vertex_FindOverlaps(found.sel, doc);
+	});
+	passes.add("dangling vertices", 2, [&doc](CheckFinding &found)
+	{
+		Vertex_FindDanglers(found.sel, doc);
+	});
+	passes.add("unused vertices", 1, [&doc](CheckFinding &found)
+	{
+		Vertex_FindUnused(found.sel, doc);
+	});
+}
+
+
+CheckResult ChecksModule::checkVertices(int min_severity, CheckPassList *ready) const
 {
 	UI_Check_Vertices *dialog = new UI_Check_Vertices(min_severity > 0, inst);
 
-	selection_c  sel;
+	const CheckFinding *found;
 
 	SString check_message;
 
 	for (;;)
 	{
-		Vertex_FindOverlaps(sel, doc);
+		CheckPassList fresh;
+		if (! ready)
+		{
+			addVertexPasses(fresh);
+			fresh.run();
+		}
+		CheckPassList &passes = ready ? *ready : fresh;
 
-		if (sel.empty())
+		dialog->ShowTiming(passes);
+
+
+		found = &dialog->TakeFinding(passes);
+
+		if (found->sel.empty())
 			dialog->AddLine("No overlapping vertices");
 		else
 		{
-			check_message = SString::printf("%d overlapping vertices", sel.count_obj());
+			check_message = SString::printf("%d overlapping vertices", found->sel.count_obj());
 
-			dialog->AddLine(check_message.c_str(), 2, 210,
+			dialog->AddLine(check_message.c_str(), found->severity, 210,
 			                "Show",  &UI_Check_Vertices::action_highlight,
 			                "Merge", &UI_Check_Vertices::action_merge);
 		}
 
 
-		Vertex_FindDanglers(sel, doc);
+		found = &dialog->TakeFinding(passes);
 
-		if (sel.empty())
+		if (found->sel.empty())
 			dialog->AddLine("No dangling vertices");
 		else
 		{
-			check_message = SString::printf("%d dangling vertices", sel.count_obj());
+			check_message = SString::printf("%d dangling vertices", found->sel.count_obj());
 
-			dialog->AddLine(check_message, 2, 210,
+			dialog->AddLine(check_message, found->severity, 210,
 			                "Show",  &UI_Check_Vertices::action_show_danglers);
 		}
 
 
-		Vertex_FindUnused(sel, doc);
+		found = &dialog->TakeFinding(passes);
 
-		if (sel.empty())
+		if (found->sel.empty())
 			dialog->AddLine("No unused vertices");
 		else
 		{
-			check_message = SString::printf("%d unused vertices", sel.count_obj());
+			check_message = SString::printf("%d unused vertices", found->sel.count_obj());
 
-			dialog->AddLine(check_message, 1, 210,
+			dialog->AddLine(check_message, found->severity, 210,
 			                "Show",   &UI_Check_Vertices::action_show_unused,
 			                "Remove", &UI_Check_Vertices::action_remove);
 		}
@@ -588,6 +757,13 @@ CheckResult ChecksModule::checkVertices(int min_severity) const
 
 		if (result == CheckResult::tookAction)
 		{
+			if (ready)
+			{
+				// later categories of checkAll need a re-run too
+				ready->markMapChanged();
+				ready = nullptr;
+			}
+
 			// repeat the tests
 			dialog->Reset();
 			continue;
@@ -676,7 +852,7 @@ static void Sectors_ShowUnclosed(ObjType what, Instance &inst)
 }
 
 
-static void Sectors_FindMismatches(selection_c& secs, selection_c& lines, Instance &inst)
+static void Sectors_FindMismatches(selection_c& secs, selection_c& lines, const Document &doc)
 {
 	//
 	// Note from RQ:
@@ -696,13 +872,11 @@ static void Sectors_FindMismatches(selection_c& secs, selection_c& lines, Instan
 
 	 secs.change_type(ObjType::sectors);
 	lines.change_type(ObjType::linedefs);
-	
-	Document &doc = inst.level;
 
 	if (doc.numLinedefs() == 0 || doc.numSectors() == 0)
 		return;
 
-	FastOppositeTree tree(inst);
+	FastOppositeTree tree(doc);
 
 	for (int n = 0 ; n < doc.numLinedefs(); n++)
 	{
@@ -741,9 +915,9 @@ static void Sectors_ShowMismatches(ObjType what, Instance &inst)
 	selection_c other;
 
 	if (what == ObjType::sectors)
-		Sectors_FindMismatches(*inst.edit.Selected, other, inst);
+		Sectors_FindMismatches(*inst.edit.Selected, other, inst.level);
 	else
-		Sectors_FindMismatches(other, *inst.edit.Selected, inst);
+		Sectors_FindMismatches(other, *inst.edit.Selected, inst.level);
 
 	inst.GoToErrors();
 }
@@ -760,6 +934,26 @@ static void bump_unknown_type(std::map<int, int>& t_map, int type)
 }
 
 
+//
+// Checks a sector type. When unknown, type_num gets the number to report.
+//
+static bool SEC_is_unknown_type(const Instance &inst, int max_type, int &type_num)
+{
+	// always ignore type #0
+	if (type_num == 0)
+		return false;
+
+	if (type_num < 0 || type_num > max_type)
+		return true;
+
+	// Boom and ZDoom generalized sectors
+	type_num &= M_CalcSectorTypeMask(inst.conf);
+
+	const sectortype_t &info = inst.M_GetSectorType(type_num);
+
+	return info.desc.startsWith("UNKNOWN");
+}
+
 static void Sectors_FindUnknown(selection_c& list, std::map<int, int>& types, const Instance &inst)
 {
 	types.clear();
@@ -772,23 +966,7 @@ static void Sectors_FindUnknown(selection_c& list, std::map<int, int>& types, co
 	{
 		int type_num = inst.level.sectors[n]->type;
 
-		// always ignore type #0
-		if (type_num == 0)
-			continue;
-
-		if (type_num < 0 || type_num > max_type)
-		{
-			bump_unknown_type(types, type_num);
-			list.set(n);
-			continue;
-		}
-
-		// Boom and ZDoom generalized sectors
-		type_num &= M_CalcSectorTypeMask(inst.conf);
-
-		const sectortype_t &info = inst.M_GetSectorType(type_num);
-
-		if (info.desc.startsWith("UNKNOWN"))
+		if (SEC_is_unknown_type(inst, max_type, type_num))
 		{
 			bump_unknown_type(types, type_num);
 			list.set(n);
@@ -1197,54 +1375,100 @@ private:
 };
 
 
-CheckResult ChecksModule::checkSectors(int min_severity) const
+void ChecksModule::addSectorPasses(CheckPassList &passes) const
+{
+	const Document &doc = this->doc;
+	const Instance &inst = this->inst;
+
+	passes.add("unclosed sectors", 2, [&doc](CheckFinding &found)
+	{
+		Sectors_FindUnclosed(found.sel, found.other, doc);
+	});
+	passes.add("mismatched sectors", 2, [&doc](CheckFinding &found)
+	{
+		Sectors_FindMismatches(found.sel, found.other, doc);
+	});
+	passes.add("sectors with ceil < floor", 2, [&doc](CheckFinding &found)
+	{
+		Sectors_FindBadCeil(found.sel, doc);
+	});
+	passes.add("unknown sector types", 2, [&inst](CheckFinding &found)
+	{
+		Sectors_FindUnknown(found.sel, found.types, inst);
+	});
+	passes.add("shared sidedefs", 1, [&doc](CheckFinding &found)
+	{
+		SideDefs_FindPacking(found.sel, found.other, doc);
+	});
+	passes.add("unused sectors", 1, [&doc](CheckFinding &found)
+	{
+		Sectors_FindUnused(found.sel, doc);
+	});
+	passes.add("unused sidedefs", 1, [&doc](CheckFinding &found)
+	{
+		SideDefs_FindUnused(found.sel, doc);
+	});
+}
+
+
+CheckResult ChecksModule::checkSectors(int min_severity, CheckPassList *ready) const
 {
 	UI_Check_Sectors *dialog = new UI_Check_Sectors(min_severity > 0, inst);
 
-	selection_c  sel, other;
+	const CheckFinding *found;
 
-	std::map<int, int> types;
 	SString check_message;
 
 	for (;;)
 	{
-		Sectors_FindUnclosed(sel, other, doc);
+		CheckPassList fresh;
+		if (! ready)
+		{
+			addSectorPasses(fresh);
+			fresh.run();
+		}
+		CheckPassList &passes = ready ? *ready : fresh;
+
+		dialog->ShowTiming(passes);
 
-		if (sel.empty())
+
+		found = &dialog->TakeFinding(passes);
+
+		if (found->sel.empty())
 			dialog->AddLine("No unclosed sectors");
 		else
 		{
-			check_message = SString::printf("%d unclosed sectors", sel.count_obj());
+			check_message = SString::printf("%d unclosed sectors", found->sel.count_obj());
 
-			dialog->AddLine(check_message, 2, 220,
+			dialog->AddLine(check_message, found->severity, 220,
 			                "Show",  &UI_Check_Sectors::action_show_unclosed,
 			                "Verts", &UI_Check_Sectors::action_show_un_verts);
 		}
 
 
-		Sectors_FindMismatches(sel, other, inst);
+		found = &dialog->TakeFinding(passes);
 
-		if (sel.empty())
+		if (found->sel.empty())
 			dialog->AddLine("No mismatched sectors");
 		else
 		{
-			check_message = SString::printf("%d mismatched sectors", sel.count_obj());
+			check_message = SString::printf("%d mismatched sectors", found->sel.count_obj());
 
-			dialog->AddLine(check_message, 2, 220,
+			dialog->AddLine(check_message, found->severity, 220,
 			                "Show",  &UI_Check_Sectors::action_show_mismatch,
 			                "Lines", &UI_Check_Sectors::action_show_mis_lines);
 		}
 
 
-		Sectors_FindBadCeil(sel, doc);
+		found = &dialog->TakeFinding(passes);
 
-		if (sel.empty())
+		if (found->sel.empty())
 			dialog->AddLine("No sectors with ceil < floor");
 		else
 		{
-			check_message = SString::printf("%d sectors with ceil < floor", sel.count_obj());
+			check_message = SString::printf("%d sectors with ceil < floor", found->sel.count_obj());
 
-			dialog->AddLine(check_message, 2, 220,
+			dialog->AddLine(check_message, found->severity, 220,
 			                "Show", &UI_Check_Sectors::action_show_ceil,
 			                "Fix",  &UI_Check_Sectors::action_fix_ceil);
 		}
@@ -1252,59 +1476,59 @@ CheckResult ChecksModule::checkSectors(int min_severity) const
 		dialog->AddGap(10);
 
 
-		Sectors_FindUnknown(sel, types, inst);
+		found = &dialog->TakeFinding(passes);
 
-		if (sel.empty())
+		if (found->sel.empty())
 			dialog->AddLine("No unknown sector types");
 		else
 		{
-			check_message = SString::printf("%d unknown sector types", (int)types.size());
+			check_message = SString::printf("%d unknown sector types", (int)found->types.size());
 
-			dialog->AddLine(check_message, 2, 220,
+			dialog->AddLine(check_message, found->severity, 220,
 			                "Show",   &UI_Check_Sectors::action_show_unknown,
 			                "Log",    &UI_Check_Sectors::action_log_unknown,
 			                "Clear",  &UI_Check_Sectors::action_clear_unknown);
 		}
 
 
-		SideDefs_FindPacking(sel, other, doc);
+		found = &dialog->TakeFinding(passes);
 
-		if (sel.empty())
+		if (found->sel.empty())
 			dialog->AddLine("No shared sidedefs");
 		else
 		{
-			int approx_num = sel.count_obj();
+			int approx_num = found->sel.count_obj();
 
 			check_message = SString::printf("%d shared sidedefs", approx_num);
 
-			dialog->AddLine(check_message, 1, 200,
+			dialog->AddLine(check_message, found->severity, 200,
 			                "Show",   &UI_Check_Sectors::action_show_packed,
 			                "Unpack", &UI_Check_Sectors::action_unpack);
 		}
 
 
-		Sectors_FindUnused(sel, doc);
+		found = &dialog->TakeFinding(passes);
 
-		if (sel.empty())
+		if (found->sel.empty())
 			dialog->AddLine("No unused sectors");
 		else
 		{
-			check_message = SString::printf("%d unused sectors", sel.count_obj());
+			check_message = SString::printf("%d unused sectors", found->sel.count_obj());
 
-			dialog->AddLine(check_message, 1, 170,
+			dialog->AddLine(check_message, found->severity, 170,
 			                "Remove", &UI_Check_Sectors::action_remove);
 		}
 
 
-		SideDefs_FindUnused(sel, doc);
+		found = &dialog->TakeFinding(passes);
 
-		if (sel.empty())
+		if (found->sel.empty())
 			dialog->AddLine("No unused sidedefs");
 		else
 		{
-			check_message = SString::printf("%d unused sidedefs", sel.count_obj());
+			check_message = SString::printf("%d unused sidedefs", found->sel.count_obj());
 
-			dialog->AddLine(check_message, 1, 170,
+			dialog->AddLine(check_message, found->severity, 170,
 			                "Remove", &UI_Check_Sectors::action_remove_sidedefs);
 		}
 
@@ -1321,6 +1545,13 @@ CheckResult ChecksModule::checkSectors(int min_severity) const
 
 		if (result == CheckResult::tookAction)
 		{
+			if (ready)
+			{
+				// later categories of checkAll need a re-run too
+				ready->markMapChanged();
+				ready = nullptr;
+			}
+
 			// repeat the tests
 			dialog->Reset();
 			continue;
@@ -1335,6 +1566,13 @@ CheckResult ChecksModule::checkSectors(int min_severity) const
 
 //------------------------------------------------------------------------
 
+static bool TH_is_unknown_type(const Instance &inst, int type)
+{
+	const thingtype_t &info = inst.conf.getThingType(type);
+
+	return info.desc.startsWith("UNKNOWN");
+}
+
 void Things_FindUnknown(selection_c& list, std::map<int, int>& types, const Instance &inst)
 {
 	types.clear();
@@ -1343,9 +1581,7 @@ void Things_FindUnknown(selection_c& list, std::map<int, int>& types, const Inst
 
 	for (int n = 0 ; n < inst.level.numThings() ; n++)
 	{
-		const thingtype_t &info = inst.conf.getThingType(inst.level.things[n]->type);
-
-		if (info.desc.startsWith("UNKNOWN"))
+		if (TH_is_unknown_type(inst, inst.level.things[n]->type))
 		{
 			bump_unknown_type(types, inst.level.things[n]->type);
 
@@ -1431,6 +1667,68 @@ static int Things_FindStarts(int *dm_num, const Document &doc)
 }
 
 
+//
+// Describe the player starts (as found by Things_FindStarts) in two lines,
+// one for the normal starts and one for the deathmatch starts.
+// Returns false if the game doesn't need any.
+//
+static bool Things_DescribeStarts(const ConfigData &conf, int mask, int dm_num,
+								  SString messages[2], int severities[2])
+{
+	if (conf.features.no_need_players)
+		return false;
+
+	severities[0] = 0;
+
+	if (! (mask & 1))
+	{
+		messages[0] = "Player 1 start is missing!";
+		severities[0] = 2;
+	}
+	else if (! (mask & 2))
+	{
+		messages[0] = "Player 2 start is missing";
+		severities[0] = 1;
+	}
+	else if (! (mask & 4))
+	{
+		messages[0] = "Player 3 start is missing";
+		severities[0] = 1;
+	}
+	else if (! (mask & 8))
+	{
+		messages[0] = "Player 4 start is missing";
+		severities[0] = 1;
+	}
+	else
+		messages[0] = "Found all 4 player starts";
+
+	severities[1] = 0;
+
+	if (dm_num == 0)
+	{
+		messages[1] = "Map is missing deathmatch starts";
+		severities[1] = 1;
+	}
+	else if (dm_num < conf.miscInfo.min_dm_starts)
+	{
+		messages[1] = SString::printf("Found %d deathmatch starts -- need at least %d", dm_num,
+			conf.miscInfo.min_dm_starts);
+		severities[1] = 1;
+	}
+	else if (dm_num > conf.miscInfo.max_dm_starts)
+	{
+		messages[1] = SString::printf("Found %d deathmatch starts -- maximum is %d", dm_num,
+			conf.miscInfo.max_dm_starts);
+		severities[1] = 2;
+	}
+	else
+		messages[1] = SString::printf("Found %d deathmatch starts -- OK", dm_num);
+
+	return true;
+}
+
+
 static void Things_FindInVoid(selection_c& list, const Instance &inst)
 {
 	list.change_type(ObjType::things);
@@ -1668,6 +1966,10 @@ static void CollectBlockingThings(std::vector<int>& list,
 */
 #define MONSTER_STEP_DIST  8
 
+// largest cell size of the stuck-thing grid, before growing it to keep
+// the number of cells bounded.
+#define STUCK_GRID_MAX_SIZE  256
+
 
 static bool ThingStuckInThing(const Instance &inst, const Thing *T1, const thingtype_t *info1,
 							  const Thing *T2, const thingtype_t *info2)
@@ -1759,40 +2061,232 @@ static inline bool LD_is_blocking(const LineDef *L, const Document &doc)
 }
 
 
-static bool ThingStuckInWall(const Thing *T, int r, char group, const Document &doc)
+//
+// A uniform grid of buckets over the area covered by the blocking things,
+// used as the broad phase of Things_FindStuckies.  Every blocking thing and
+// every blocking linedef is stored in each cell its bounding box overlaps,
+// hence only objects sharing a cell need the precise tests.
+//
+class stuck_grid_c
 {
-	// only check players and monsters
-	if (! (group == 'p' || group == 'm'))
-		return false;
+private:
+	double min_x = 0;
+	double min_y = 0;
+	double cell_size = 0;
 
-	if (group == 'm')
-		r = std::max(4, r - MONSTER_STEP_DIST);
+	int cols = 0;
+	int rows = 0;
 
-	// shrink a tiny bit, because we need to find lines which CROSS the
-	// bounding box, not just touch it.
-	r = r - 1;
+	std::vector<std::vector<int>> thing_cells;
+	std::vector<std::vector<int>> line_cells;
 
-	double x1 = T->x() - r;
-	double y1 = T->y() - r;
-	double x2 = T->x() + r;
-	double y2 = T->y() + r;
+	// stamps to visit an object only once when it spans several cells
+	std::vector<unsigned> thing_marks;
+	std::vector<unsigned> line_marks;
+	unsigned cur_mark = 0;
 
-	for (int n = 0 ; n < doc.numLinedefs(); n++)
+public:
+	stuck_grid_c(const std::vector<int>& blockers, const std::vector<int>& sizes,
+				 const Document &doc);
+
+	//
+	// Calls func() on each thing (index into the blockers list) or linedef
+	// bucketed near the given box, stopping as soon as it returns true.
+	//
+	template<typename F>
+	bool anyThing(double x1, double y1, double x2, double y2, F &&func)
+	{
+		return visit(thing_cells, thing_marks, x1, y1, x2, y2, func);
+	}
+
+	template<typename F>
+	bool anyLine(double x1, double y1, double x2, double y2, F &&func)
+	{
+		return visit(line_cells, line_marks, x1, y1, x2, y2, func);
+	}
+
+private:
+	bool cellRange(double x1, double y1, double x2, double y2,
+				   int &cx1, int &cy1, int &cx2, int &cy2) const;
+
+	template<typename F>
+	bool visit(const std::vector<std::vector<int>>& cells, std::vector<unsigned>& marks,
+			   double x1, double y1, double x2, double y2, F &func)
+	{
+		int cx1, cy1, cx2, cy2;
+
+		if (! cellRange(x1, y1, x2, y2, cx1, cy1, cx2, cy2))
+			return false;
+
+		cur_mark++;
+
+		for (int cy = cy1 ; cy <= cy2 ; cy++)
+		for (int cx = cx1 ; cx <= cx2 ; cx++)
+		{
+			for (int obj : cells[cy * cols + cx])
+			{
+				if (marks[obj] == cur_mark)
+					continue;
+
+				marks[obj] = cur_mark;
+
+				if (func(obj))
+					return true;
+			}
+		}
+
+		return false;
+	}
+};
+
+
+stuck_grid_c::stuck_grid_c(const std::vector<int>& blockers, const std::vector<int>& sizes,
+						   const Document &doc)
+{
+	SYS_ASSERT(! blockers.empty());
+
+	min_x = min_y =  1e30;
+	double max_x  = -1e30;
+	double max_y  = -1e30;
+
+	double total_size = 0;
+
+	for (int n = 0 ; n < (int)blockers.size() ; n++)
+	{
+		const auto T = doc.things[blockers[n]];
+
+		min_x = std::min(min_x, T->x() - sizes[n]);
+		min_y = std::min(min_y, T->y() - sizes[n]);
+		max_x = std::max(max_x, T->x() + sizes[n]);
+		max_y = std::max(max_y, T->y() + sizes[n]);
+
+		total_size += 2 * sizes[n];
+	}
+
+	// the cells are sized after the average thing diameter, but grow
+	// when things are spread so far apart that the grid would be huge.
+	cell_size = 32;
+
+	while (cell_size < STUCK_GRID_MAX_SIZE && cell_size < total_size / blockers.size())
+		cell_size *= 2;
+
+	double max_cells = std::max(4096.0, 4.0 * blockers.size());
+
+	for (;;)
+	{
+		cols = static_cast<int>((max_x - min_x) / cell_size) + 1;
+		rows = static_cast<int>((max_y - min_y) / cell_size) + 1;
+
+		if ((double)cols * rows <= max_cells)
+			break;
+
+		cell_size *= 2;
+	}
+
+	thing_cells.resize(cols * rows);
+	 line_cells.resize(cols * rows);
+
+	thing_marks.assign(blockers.size(), 0);
+	 line_marks.assign(doc.numLinedefs(), 0);
+
+	int cx1, cy1, cx2, cy2;
+
+	for (int n = 0 ; n < (int)blockers.size() ; n++)
+	{
+		const auto T = doc.things[blockers[n]];
+		double r = sizes[n];
+
+		if (! cellRange(T->x() - r, T->y() - r, T->x() + r, T->y() + r, cx1, cy1, cx2, cy2))
+			continue;
+
+		for (int cy = cy1 ; cy <= cy2 ; cy++)
+		for (int cx = cx1 ; cx <= cx2 ; cx++)
+			thing_cells[cy * cols + cx].push_back(n);
+	}
+
+	for (int n = 0 ; n < doc.numLinedefs() ; n++)
 	{
 		const auto L = doc.linedefs[n];
 
 		if (! LD_is_blocking(L.get(), doc))
 			continue;
 
-		if (doc.objects.lineTouchesBox(n, x1, y1, x2, y2))
-			return true;
+		const Vertex &V1 = doc.getStart(*L);
+		const Vertex &V2 = doc.getEnd(*L);
+
+		if (! cellRange(std::min(V1.x(), V2.x()), std::min(V1.y(), V2.y()),
+						std::max(V1.x(), V2.x()), std::max(V1.y(), V2.y()),
+						cx1, cy1, cx2, cy2))
+			continue;
+
+		bool straight = (cx1 == cx2 || cy1 == cy2);
+
+		for (int cy = cy1 ; cy <= cy2 ; cy++)
+		for (int cx = cx1 ; cx <= cx2 ; cx++)
+		{
+			// diagonal lines only go in the cells they actually cross
+			if (! straight)
+			{
+				double bx = min_x + cx * cell_size;
+				double by = min_y + cy * cell_size;
+
+				if (! doc.objects.lineTouchesBox(n, bx, by, bx + cell_size, by + cell_size))
+					continue;
+			}
+
+			line_cells[cy * cols + cx].push_back(n);
+		}
 	}
+}
 
-	return false;
+
+bool stuck_grid_c::cellRange(double x1, double y1, double x2, double y2,
+							 int &cx1, int &cy1, int &cx2, int &cy2) const
+{
+	x1 = (x1 - min_x) / cell_size;
+	y1 = (y1 - min_y) / cell_size;
+	x2 = (x2 - min_x) / cell_size;
+	y2 = (y2 - min_y) / cell_size;
+
+	if (x2 < 0 || y2 < 0 || x1 >= cols || y1 >= rows)
+		return false;
+
+	cx1 = std::max(0, static_cast<int>(x1));
+	cy1 = std::max(0, static_cast<int>(y1));
+	cx2 = std::min(cols - 1, static_cast<int>(x2));
+	cy2 = std::min(rows - 1, static_cast<int>(y2));
+
+	return true;
+}
+
+
+static bool ThingStuckInWall(const Thing *T, int r, char group, const Document &doc,
+							 stuck_grid_c &grid)
+{
+	// only check players and monsters
+	if (! (group == 'p' || group == 'm'))
+		return false;
+
+	if (group == 'm')
+		r = std::max(4, r - MONSTER_STEP_DIST);
+
+	// shrink a tiny bit, because we need to find lines which CROSS the
+	// bounding box, not just touch it.
+	r = r - 1;
+
+	double x1 = T->x() - r;
+	double y1 = T->y() - r;
+	double x2 = T->x() + r;
+	double y2 = T->y() + r;
+
+	return grid.anyLine(x1, y1, x2, y2, [&](int ld)
+	{
+		return doc.objects.lineTouchesBox(ld, x1, y1, x2, y2);
+	});
 }
 
 
-static void Things_FindStuckies(selection_c& list, const Instance &inst)
+void Things_FindStuckies(selection_c& list, const Instance &inst)
 {
 	list.change_type(ObjType::things);
 
@@ -1801,24 +2295,44 @@ static void Things_FindStuckies(selection_c& list, const Instance &inst)
 
 	CollectBlockingThings(blockers, sizes, inst);
 
+	if (blockers.empty())
+		return;
+
+	const Document &doc = inst.level;
+
+	stuck_grid_c grid(blockers, sizes, doc);
+
 	for (int n = 0 ; n < (int)blockers.size() ; n++)
 	{
-		const auto T = inst.level.things[blockers[n]];
+		const auto T = doc.things[blockers[n]];
 
 		const thingtype_t &info = inst.conf.getThingType(T->type);
 
-		if (ThingStuckInWall(T.get(), info.radius, info.group, inst.level))
+		if (ThingStuckInWall(T.get(), info.radius, info.group, doc, grid))
+		{
 			list.set(blockers[n]);
+			continue;
+		}
 
-		for (int n2 = n + 1 ; n2 < (int)blockers.size() ; n2++)
+		// only things sharing a grid cell can overlap.  As before, a pair
+		// only marks its earlier thing, so just look at later ones.
+		double r = sizes[n];
+
+		bool stuck = grid.anyThing(T->x() - r, T->y() - r, T->x() + r, T->y() + r,
+								   [&](int n2)
 		{
-			const auto T2 = inst.level.things[blockers[n2]];
+			if (n2 <= n)
+				return false;
+
+			const auto T2 = doc.things[blockers[n2]];
 
 			const thingtype_t &info2 = inst.conf.getThingType(T2->type);
 
-			if (ThingStuckInThing(inst, T.get(), &info, T2.get(), &info2))
-				list.set(blockers[n]);
-		}
+			return ThingStuckInThing(inst, T.get(), &info, T2.get(), &info2);
+		});
+
+		if (stuck)
+			list.set(blockers[n]);
 	}
 }
 
@@ -1907,67 +2421,105 @@ private:
 };
 
 
-CheckResult ChecksModule::checkThings(int min_severity) const
+void ChecksModule::addThingPasses(CheckPassList &passes) const
+{
+	const Document &doc = this->doc;
+	const Instance &inst = this->inst;
+
+	passes.add("unknown thing types", 2, [&inst](CheckFinding &found)
+	{
+		Things_FindUnknown(found.sel, found.types, inst);
+	});
+	passes.add("stuck actors", 2, [&inst](CheckFinding &found)
+	{
+		Things_FindStuckies(found.sel, inst);
+	});
+	passes.add("things in the void", 1, [&inst](CheckFinding &found)
+	{
+		Things_FindInVoid(found.sel, inst);
+	});
+	passes.add("unspawnable things", 1, [&inst](CheckFinding &found)
+	{
+		Things_FindDuds(inst, found.sel);
+	});
+	passes.add("player starts", 0, [&doc](CheckFinding &found)
+	{
+		found.value = Things_FindStarts(&found.extra, doc);
+	});
+}
+
+
+CheckResult ChecksModule::checkThings(int min_severity, CheckPassList *ready) const
 {
 	UI_Check_Things *dialog = new UI_Check_Things(min_severity > 0, inst);
 
-	selection_c  sel;
+	const CheckFinding *found;
 
-	std::map<int, int> types;
 	SString check_message;
 
 	for (;;)
 	{
-		Things_FindUnknown(sel, types, inst);
+		CheckPassList fresh;
+		if (! ready)
+		{
+			addThingPasses(fresh);
+			fresh.run();
+		}
+		CheckPassList &passes = ready ? *ready : fresh;
+
+		dialog->ShowTiming(passes);
+
+
+		found = &dialog->TakeFinding(passes);
 
-		if (sel.empty())
+		if (found->sel.empty())
 			dialog->AddLine("No unknown thing types");
 		else
 		{
-			check_message = SString::printf("%d unknown things", (int)types.size());
+			check_message = SString::printf("%d unknown things", (int)found->types.size());
 
-			dialog->AddLine(check_message, 2, 200,
+			dialog->AddLine(check_message, found->severity, 200,
 			                "Show",   &UI_Check_Things::action_show_unknown,
 			                "Log",    &UI_Check_Things::action_log_unknown,
 			                "Remove", &UI_Check_Things::action_remove_unknown);
 		}
 
 
-		Things_FindStuckies(sel, inst);
+		found = &dialog->TakeFinding(passes);
 
-		if (sel.empty())
+		if (found->sel.empty())
 			dialog->AddLine("No stuck actors");
 		else
 		{
-			check_message = SString::printf("%d stuck actors", sel.count_obj());
+			check_message = SString::printf("%d stuck actors", found->sel.count_obj());
 
-			dialog->AddLine(check_message, 2, 200,
+			dialog->AddLine(check_message, found->severity, 200,
 			                "Show",  &UI_Check_Things::action_show_stuck);
 		}
 
 
-		Things_FindInVoid(sel, inst);
+		found = &dialog->TakeFinding(passes);
 
-		if (sel.empty())
+		if (found->sel.empty())
 			dialog->AddLine("No things in the void");
 		else
 		{
-			check_message = SString::printf("%d things in the void", sel.count_obj());
+			check_message = SString::printf("%d things in the void", found->sel.count_obj());
 
-			dialog->AddLine(check_message, 1, 200,
+			dialog->AddLine(check_message, found->severity, 200,
 			                "Show",   &UI_Check_Things::action_show_void,
 			                "Remove", &UI_Check_Things::action_remove_void);
 		}
 
 
-		Things_FindDuds(inst, sel);
+		found = &dialog->TakeFinding(passes);
 
-		if (sel.empty())
+		if (found->sel.empty())
 			dialog->AddLine("No unspawnable things -- skill flags are OK");
 		else
 		{
-			check_message = SString::printf("%d unspawnable things", sel.count_obj());
-			dialog->AddLine(check_message, 1, 200,
+			check_message = SString::printf("%d unspawnable things", found->sel.count_obj());
+			dialog->AddLine(check_message, found->severity, 200,
 			                "Show", &UI_Check_Things::action_show_duds,
 			                "Fix",  &UI_Check_Things::action_fix_duds);
 		}
@@ -1976,47 +2528,21 @@ CheckResult ChecksModule::checkThings(int min_severity) const
 		dialog->AddGap(10);
 
 
-		int dm_num, mask;
+		found = &dialog->TakeFinding(passes);
 
-		mask = Things_FindStarts(&dm_num, doc);
+		SString start_messages[2];
+		int start_severities[2];
 
-		if (inst.conf.features.no_need_players)
-			dialog->AddLine("Player starts not needed, no check done");
-		else if (! (mask & 1))
-			dialog->AddLine("Player 1 start is missing!", 2);
-		else if (! (mask & 2))
-			dialog->AddLine("Player 2 start is missing", 1);
-		else if (! (mask & 4))
-			dialog->AddLine("Player 3 start is missing", 1);
-		else if (! (mask & 8))
-			dialog->AddLine("Player 4 start is missing", 1);
-		else
-			dialog->AddLine("Found all 4 player starts");
-
-		if (inst.conf.features.no_need_players)
-		{
-			// leave a blank space
-		}
-		else if (dm_num == 0)
-		{
-			dialog->AddLine("Map is missing deathmatch starts", 1);
-		}
-		else if (dm_num < inst.conf.miscInfo.min_dm_starts)
-		{
-			check_message = SString::printf("Found %d deathmatch starts -- need at least %d", dm_num,
-				inst.conf.miscInfo.min_dm_starts);
-			dialog->AddLine(check_message, 1);
-		}
-		else if (dm_num > inst.conf.miscInfo.max_dm_starts)
+		if (! Things_DescribeStarts(inst.conf, found->value, found->extra,
+									start_messages, start_severities))
 		{
-			check_message = SString::printf("Found %d deathmatch starts -- maximum is %d", dm_num,
-				inst.conf.miscInfo.max_dm_starts);
-			dialog->AddLine(check_message, 2);
+			// the second line is left blank
+			dialog->AddLine("Player starts not needed, no check done");
 		}
 		else
 		{
-			check_message = SString::printf("Found %d deathmatch starts -- OK", dm_num);
-			dialog->AddLine(check_message);
+			dialog->AddLine(start_messages[0], start_severities[0]);
+			dialog->AddLine(start_messages[1], start_severities[1]);
 		}
 
 
@@ -2032,6 +2558,13 @@ CheckResult ChecksModule::checkThings(int min_severity) const
 
 		if (result == CheckResult::tookAction)
 		{
+			if (ready)
+			{
+				// later categories of checkAll need a re-run too
+				ready->markMapChanged();
+				ready = nullptr;
+			}
+
 			// repeat the tests
 			dialog->Reset();
 			continue;
@@ -2175,15 +2708,18 @@ static void LineDefs_FixManualDoors(Instance &inst)
 }
 
 
+static bool LD_lacks_impass(const LineDef &L)
+{
+	return L.OneSided() && (L.flags & MLF_Blocking) == 0;
+}
+
 static void LineDefs_FindLackImpass(selection_c& lines, const Document &doc)
 {
 	lines.change_type(ObjType::linedefs);
 
 	for (int n = 0 ; n < doc.numLinedefs(); n++)
 	{
-		const auto L = doc.linedefs[n];
-
-		if (L->OneSided() && (L->flags & MLF_Blocking) == 0)
+		if (LD_lacks_impass(*doc.linedefs[n]))
 			lines.set(n);
 	}
 }
@@ -2219,18 +2755,21 @@ static void LineDefs_FixLackImpass(Document &doc)
 }
 
 
+static bool LD_has_bad_2s_flag(const LineDef &L)
+{
+	if (L.OneSided() && (L.flags & MLF_TwoSided))
+		return true;
+
+	return L.TwoSided() && ! (L.flags & MLF_TwoSided);
+}
+
 static void LineDefs_FindBad2SFlag(selection_c& lines, const Document &doc)
 {
 	lines.change_type(ObjType::linedefs);
 
 	for (int n = 0 ; n < doc.numLinedefs(); n++)
 	{
-		const auto L = doc.linedefs[n];
-
-		if (L->OneSided() && (L->flags & MLF_TwoSided))
-			lines.set(n);
-
-		if (L->TwoSided() && ! (L->flags & MLF_TwoSided))
+		if (LD_has_bad_2s_flag(*doc.linedefs[n]))
 			lines.set(n);
 	}
 }
@@ -2276,6 +2815,21 @@ static void bung_unknown_type(std::map<int, int>& t_map, int type)
 }
 
 
+static bool LD_is_unknown_type(const Instance &inst, int type_num)
+{
+	// always ignore type #0
+	if (type_num == 0)
+		return false;
+
+	const linetype_t &info = inst.conf.getLineType(type_num);
+
+	// Boom generalized line type?
+	if (inst.conf.features.gen_types && is_genline(type_num))
+		return false;
+
+	return info.desc.startsWith("UNKNOWN");
+}
+
 static void LineDefs_FindUnknown(selection_c& list, std::map<int, int>& types, const Instance &inst)
 {
 	types.clear();
@@ -2286,17 +2840,7 @@ static void LineDefs_FindUnknown(selection_c& list, std::map<int, int>& types, c
 	{
 		int type_num = inst.level.linedefs[n]->type;
 
-		// always ignore type #0
-		if (type_num == 0)
-			continue;
-
-		const linetype_t &info = inst.conf.getLineType(type_num);
-
-		// Boom generalized line type?
-		if (inst.conf.features.gen_types && is_genline(type_num))
-			continue;
-
-		if (info.desc.startsWith("UNKNOWN"))
+		if (LD_is_unknown_type(inst, type_num))
 		{
 			bung_unknown_type(types, type_num);
 
@@ -2359,55 +2903,51 @@ static void LineDefs_ClearUnknown(Instance &inst)
 //------------------------------------------------------------------------
 
 
-static int linedef_pos_cmp(int A, int B, const Document &doc)
+//
+// Position of a linedef for finding overlaps: the integer coordinates of
+// its ends, ordered so that either direction gives the same position.
+//
+struct linedef_pos_t
 {
-	const auto AL = doc.linedefs[A];
-	const auto BL = doc.linedefs[B];
+	int x1, y1, x2, y2;
 
-	int A_x1 = static_cast<int>(doc.getStart(*AL).x());
-	int A_y1 = static_cast<int>(doc.getStart(*AL).y());
-	int A_x2 = static_cast<int>(doc.getEnd(*AL).x());
-	int A_y2 = static_cast<int>(doc.getEnd(*AL).y());
-
-	int B_x1 = static_cast<int>(doc.getStart(*BL).x());
-	int B_y1 = static_cast<int>(doc.getStart(*BL).y());
-	int B_x2 = static_cast<int>(doc.getEnd(*BL).x());
-	int B_y2 = static_cast<int>(doc.getEnd(*BL).y());
-
-	if (A_x1 > A_x2 || (A_x1 == A_x2 && A_y1 > A_y2))
+	bool operator == (const linedef_pos_t &other) const
 	{
-		std::swap(A_x1, A_x2);
-		std::swap(A_y1, A_y2);
+		return x1 == other.x1 && y1 == other.y1 && x2 == other.x2 && y2 == other.y2;
 	}
+};
 
-	if (B_x1 > B_x2 || (B_x1 == B_x2 && B_y1 > B_y2))
+struct linedef_pos_hash_t
+{
+	size_t operator() (const linedef_pos_t &pos) const noexcept
 	{
-		std::swap(B_x1, B_x2);
-		std::swap(B_y1, B_y2);
-	}
-
-	// the "normalized" X1 coordinates is the most significant thing in
-	// this comparison function.
+		size_t h = 0;
 
-	if (A_x1 != B_x1) return A_x1 - B_x1;
-	if (A_y1 != B_y1) return A_y1 - B_y1;
+		for (int coord : { pos.x1, pos.y1, pos.x2, pos.y2 })
+			h = h * 0x100000001b3ULL + (unsigned)coord;
 
-	if (A_x2 != B_x2) return A_x2 - B_x2;
-	if (A_y2 != B_y2) return A_y2 - B_y2;
-
-	return 0;  // equal : lines are overlapping
-}
+		return h ^ (h >> 29);
+	}
+};
 
 
-struct linedef_pos_CMP_pred
+static linedef_pos_t linedef_position(const LineDef &L, const Document &doc)
 {
-	const Document &doc;
+	linedef_pos_t pos;
 
-	inline bool operator() (int A, int B) const
+	pos.x1 = static_cast<int>(doc.getStart(L).x());
+	pos.y1 = static_cast<int>(doc.getStart(L).y());
+	pos.x2 = static_cast<int>(doc.getEnd(L).x());
+	pos.y2 = static_cast<int>(doc.getEnd(L).y());
+
+	if (pos.x1 > pos.x2 || (pos.x1 == pos.x2 && pos.y1 > pos.y2))
 	{
-		return linedef_pos_cmp(A, B, doc) < 0;
+		std::swap(pos.x1, pos.x2);
+		std::swap(pos.y1, pos.y2);
 	}
-};
+
+	return pos;
+}
 
 
 struct linedef_minx_CMP_pred
@@ -2427,7 +2967,7 @@ struct linedef_minx_CMP_pred
 };
 
 
-static void LineDefs_FindOverlaps(selection_c& lines, const Document &doc)
+void LineDefs_FindOverlaps(selection_c& lines, const Document &doc)
 {
 	// we only find directly overlapping linedefs here
 
@@ -2436,29 +2976,20 @@ static void LineDefs_FindOverlaps(selection_c& lines, const Document &doc)
 	if (doc.numLinedefs() < 2)
 		return;
 
-	int n;
-
-	// sort linedefs by their position.  overlapping lines will end up
-	// adjacent to each other after the sort.
-	std::vector<int> sorted_list(doc.numLinedefs(), 0);
-
-	for (n = 0 ; n < doc.numLinedefs(); n++)
-		sorted_list[n] = n;
+	std::unordered_set<linedef_pos_t, linedef_pos_hash_t> seen;
 
-	std::sort(sorted_list.begin(), sorted_list.end(), linedef_pos_CMP_pred{ doc });
+	seen.reserve(doc.numLinedefs());
 
-	for (n = 0 ; n < doc.numLinedefs() - 1 ; n++)
+	for (int n = 0 ; n < doc.numLinedefs(); n++)
 	{
-		int ld1 = sorted_list[n];
-		int ld2 = sorted_list[n + 1];
+		const LineDef &L = *doc.linedefs[n];
 
-		// ignore zero-length lines
-		if (doc.isZeroLength(*doc.linedefs[ld2]))
-			continue;
+		bool is_new = seen.insert(linedef_position(L, doc)).second;
 
-		// only the second (or third, etc) linedef is stored
-		if (linedef_pos_cmp(ld1, ld2, doc) == 0)
-			lines.set(ld2);
+		// ignore zero-length lines.
+		// only the second (or third, etc) linedef is stored.
+		if (! is_new && ! doc.isZeroLength(L))
+			lines.set(n);
 	}
 }
 
@@ -2512,7 +3043,7 @@ static int CheckLinesCross(int A, int B, const Document &doc)
 		return 0;
 
 	// ignore directly overlapping here
-	if (linedef_pos_cmp(A, B, doc) == 0)
+	if (linedef_position(*AL, doc) == linedef_position(*BL, doc))
 		return 0;
 
 
@@ -2798,126 +3329,175 @@ private:
 };
 
 
-CheckResult ChecksModule::checkLinedefs(int min_severity) const
+void ChecksModule::addLinedefPasses(CheckPassList &passes) const
 {
-	UI_Check_LineDefs *dialog = new UI_Check_LineDefs(min_severity > 0, inst);
+	const Document &doc = this->doc;
+	const Instance &inst = this->inst;
+
+	passes.add("zero-length linedefs", 2, [&doc](CheckFinding &found)
+	{
+		LineDefs_FindZeroLen(found.sel, doc);
+	});
+	passes.add("overlapping linedefs", 2, [&doc](CheckFinding &found)
+	{
+		LineDefs_FindOverlaps(found.sel, doc);
+	});
+	passes.add("criss-crossing linedefs", 2, [&doc](CheckFinding &found)
+	{
+		LineDefs_FindCrossings(found.sel, doc);
+	});
+	passes.add("unknown line types", 1, [&inst](CheckFinding &found)
+	{
+		LineDefs_FindUnknown(found.sel, found.types, inst);
+	});
+	passes.add("linedefs without right side", 2, [&doc](CheckFinding &found)
+	{
+		LineDefs_FindMissingRight(found.sel, doc);
+	});
+	passes.add("manual doors on 1S linedefs", 2, [&inst](CheckFinding &found)
+	{
+		LineDefs_FindManualDoors(found.sel, inst);
+	});
+	passes.add("non-blocking one-sided linedefs", 1, [&doc](CheckFinding &found)
+	{
+		LineDefs_FindLackImpass(found.sel, doc);
+	});
+	passes.add("linedefs with wrong 2S flag", 1, [&doc](CheckFinding &found)
+	{
+		LineDefs_FindBad2SFlag(found.sel, doc);
+	});
+}
 
-	selection_c  sel, other;
 
-	std::map<int, int> types;
+CheckResult ChecksModule::checkLinedefs(int min_severity, CheckPassList *ready) const
+{
+	UI_Check_LineDefs *dialog = new UI_Check_LineDefs(min_severity > 0, inst);
+
+	const CheckFinding *found;
 
 	SString check_buffer;
 
 	for (;;)
 	{
-		LineDefs_FindZeroLen(sel, doc);
+		CheckPassList fresh;
+		if (! ready)
+		{
+			addLinedefPasses(fresh);
+			fresh.run();
+		}
+		CheckPassList &passes = ready ? *ready : fresh;
+
+		dialog->ShowTiming(passes);
+
 
-		if (sel.empty())
+		found = &dialog->TakeFinding(passes);
+
+		if (found->sel.empty())
 			dialog->AddLine("No zero-length linedefs");
 		else
 		{
-			check_buffer = SString::printf("%d zero-length linedefs", sel.count_obj());
+			check_buffer = SString::printf("%d zero-length linedefs", found->sel.count_obj());
 
-			dialog->AddLine(check_buffer, 2, 220,
+			dialog->AddLine(check_buffer, found->severity, 220,
 			                "Show",   &UI_Check_LineDefs::action_show_zero,
 			                "Remove", &UI_Check_LineDefs::action_remove_zero);
 		}
 
 
-		LineDefs_FindOverlaps(sel, doc);
+		found = &dialog->TakeFinding(passes);
 
-		if (sel.empty())
+		if (found->sel.empty())
 			dialog->AddLine("No overlapping linedefs");
 		else
 		{
-			check_buffer = SString::printf("%d overlapping linedefs", sel.count_obj());
+			check_buffer = SString::printf("%d overlapping linedefs", found->sel.count_obj());
 
-			dialog->AddLine(check_buffer, 2, 220,
+			dialog->AddLine(check_buffer, found->severity, 220,
 			                "Show",   &UI_Check_LineDefs::action_show_overlap,
 			                "Remove", &UI_Check_LineDefs::action_remove_overlap);
 		}
 
 
-		LineDefs_FindCrossings(sel, doc);
+		found = &dialog->TakeFinding(passes);
 
-		if (sel.empty())
+		if (found->sel.empty())
 			dialog->AddLine("No criss-crossing linedefs");
 		else
 		{
-			check_buffer = SString::printf("%d criss-crossing linedefs", sel.count_obj());
+			check_buffer = SString::printf("%d criss-crossing linedefs", found->sel.count_obj());
 
-			dialog->AddLine(check_buffer, 2, 220,
+			dialog->AddLine(check_buffer, found->severity, 220,
 			                "Show", &UI_Check_LineDefs::action_show_crossing);
 		}
 
 		dialog->AddGap(10);
 
 
-		LineDefs_FindUnknown(sel, types, inst);
+		found = &dialog->TakeFinding(passes);
 
-		if (sel.empty())
+		if (found->sel.empty())
 			dialog->AddLine("No unknown line types");
 		else
 		{
-			check_buffer = SString::printf("%d unknown line types", (int)types.size());
+			check_buffer = SString::printf("%d unknown line types", (int)found->types.size());
 
-			dialog->AddLine(check_buffer, 1, 210,
+			dialog->AddLine(check_buffer, found->severity, 210,
 			                "Show",   &UI_Check_LineDefs::action_show_unknown,
 			                "Log",    &UI_Check_LineDefs::action_log_unknown,
 			                "Clear",  &UI_Check_LineDefs::action_clear_unknown);
 		}
 
 
-		LineDefs_FindMissingRight(sel, doc);
+		found = &dialog->TakeFinding(passes);
 
-		if (sel.empty())
+		if (found->sel.empty())
 			dialog->AddLine("No linedefs without a right side");
 		else
 		{
-			check_buffer = SString::printf("%d linedefs without right side", sel.count_obj());
+			check_buffer = SString::printf("%d linedefs without right side", found->sel.count_obj());
 
-			dialog->AddLine(check_buffer, 2, 300,
+			dialog->AddLine(check_buffer, found->severity, 300,
 			                "Show", &UI_Check_LineDefs::action_show_mis_right);
 		}
 
 
-		LineDefs_FindManualDoors(sel, inst);
+		found = &dialog->TakeFinding(passes);
 
-		if (sel.empty())
+		if (found->sel.empty())
 			dialog->AddLine("No manual doors on 1S linedefs");
 		else
 		{
-			check_buffer = SString::printf("%d manual doors on 1S linedefs", sel.count_obj());
+			check_buffer = SString::printf("%d manual doors on 1S linedefs", found->sel.count_obj());
 
-			dialog->AddLine(check_buffer, 2, 300,
+			dialog->AddLine(check_buffer, found->severity, 300,
 			                "Show", &UI_Check_LineDefs::action_show_manual_doors,
 			                "Fix",  &UI_Check_LineDefs::action_fix_manual_doors);
 		}
 
 
-		LineDefs_FindLackImpass(sel, doc);
+		found = &dialog->TakeFinding(passes);
 
-		if (sel.empty())
+		if (found->sel.empty())
 			dialog->AddLine("No non-blocking one-sided linedefs");
 		else
 		{
-			check_buffer = SString::printf("%d non-blocking one-sided linedefs", sel.count_obj());
+			check_buffer = SString::printf("%d non-blocking one-sided linedefs", found->sel.count_obj());
 
-			dialog->AddLine(check_buffer, 1, 300,
+			dialog->AddLine(check_buffer, found->severity, 300,
 			                "Show", &UI_Check_LineDefs::action_show_lack_impass,
 			                "Fix",  &UI_Check_LineDefs::action_fix_lack_impass);
 		}
 
 
-		LineDefs_FindBad2SFlag(sel, doc);
+		found = &dialog->TakeFinding(passes);
 
-		if (sel.empty())
+		if (found->sel.empty())
 			dialog->AddLine("No linedefs with wrong 2S flag");
 		else
 		{
-			check_buffer = SString::printf("%d linedefs with wrong 2S flag", sel.count_obj());
+			check_buffer = SString::printf("%d linedefs with wrong 2S flag", found->sel.count_obj());
 
-			dialog->AddLine(check_buffer, 1, 300,
+			dialog->AddLine(check_buffer, found->severity, 300,
 			                "Show", &UI_Check_LineDefs::action_show_bad_2s_flag,
 			                "Fix",  &UI_Check_LineDefs::action_fix_bad_2s_flag);
 		}
@@ -2935,6 +3515,13 @@ CheckResult ChecksModule::checkLinedefs(int min_severity) const
 
 		if (result == CheckResult::tookAction)
 		{
+			if (ready)
+			{
+				// later categories of checkAll need a re-run too
+				ready->markMapChanged();
+				ready = nullptr;
+			}
+
 			// repeat the tests
 			dialog->Reset();
 			continue;
@@ -3447,72 +4034,114 @@ private:
 };
 
 
-CheckResult ChecksModule::checkTags(int min_severity) const
+void ChecksModule::addTagPasses(CheckPassList &passes) const
+{
+	const Document &doc = this->doc;
+	const Instance &inst = this->inst;
+
+	// this one may log warnings about the game config
+	passes.add("linedefs missing a needed tag", 2, [&inst](CheckFinding &found)
+	{
+		Tags_FindMissingTags(found.sel, inst);
+	}, true);
+	passes.add("action linedefs w/o a matching target", 2, [&doc, &inst](CheckFinding &found)
+	{
+		Tags_FindUnmatchedLineDefs(found.sel, doc, inst.conf);
+	});
+	passes.add("tagged sectors w/o a matching linedef", 1, [&inst](CheckFinding &found)
+	{
+		Tags_FindUnmatchedSectors(found.sel, inst);
+	});
+	passes.add("invalid 666/667 tags", 1, [&inst](CheckFinding &found)
+	{
+		Tags_FindBeastMarks(found.sel, inst);
+	});
+	passes.add("used tag range", 0, [this](CheckFinding &found)
+	{
+		tagsUsedRange(&found.value, &found.extra);
+	});
+}
+
+
+CheckResult ChecksModule::checkTags(int min_severity, CheckPassList *ready) const
 {
 	UI_Check_Tags dialog(min_severity > 0, inst);
 
-	selection_c  sel;
+	const CheckFinding *found;
+
 	SString check_buffer;
 
 	for (;;)
 	{
-		Tags_FindMissingTags(sel, inst);
+		CheckPassList fresh;
+		if (! ready)
+		{
+			addTagPasses(fresh);
+			fresh.run();
+		}
+		CheckPassList &passes = ready ? *ready : fresh;
+
+		dialog.ShowTiming(passes);
+
+
+		found = &dialog.TakeFinding(passes);
 
-		if (sel.empty())
+		if (found->sel.empty())
 			dialog.AddLine("No linedefs missing a needed tag");
 		else
 		{
-			check_buffer = SString::printf("%d linedefs missing a needed tag", sel.count_obj());
+			check_buffer = SString::printf("%d linedefs missing a needed tag", found->sel.count_obj());
 
-			dialog.AddLine(check_buffer, 2, 320,
+			dialog.AddLine(check_buffer, found->severity, 320,
 			                "Show", &UI_Check_Tags::action_show_missing_tag);
 		}
 
 
-		Tags_FindUnmatchedLineDefs(sel, doc, inst.conf);
+		found = &dialog.TakeFinding(passes);
 
-		if (sel.empty())
+		if (found->sel.empty())
 			dialog.AddLine("No action linedefs w/o a matching target");
 		else
 		{
-			check_buffer = SString::printf("%d action linedefs w/o a matching target", sel.count_obj());
+			check_buffer = SString::printf("%d action linedefs w/o a matching target", found->sel.count_obj());
 
-			dialog.AddLine(check_buffer, 2, 350,
+			dialog.AddLine(check_buffer, found->severity, 350,
 			                "Show", &UI_Check_Tags::action_show_unmatch_line);
 		}
 
 
-		Tags_FindUnmatchedSectors(sel, inst);
+		found = &dialog.TakeFinding(passes);
 
-		if (sel.empty())
+		if (found->sel.empty())
 			dialog.AddLine("No tagged sectors w/o a matching linedef");
 		else
 		{
-			check_buffer = SString::printf("%d tagged sectors w/o a matching linedef", sel.count_obj());
+			check_buffer = SString::printf("%d tagged sectors w/o a matching linedef", found->sel.count_obj());
 
-			dialog.AddLine(check_buffer, 1, 350,
+			dialog.AddLine(check_buffer, found->severity, 350,
 			                "Show", &UI_Check_Tags::action_show_unmatch_sec);
 		}
 
 
-		Tags_FindBeastMarks(sel, inst);
+		found = &dialog.TakeFinding(passes);
 
-		if (sel.empty())
+		if (found->sel.empty())
 			dialog.AddLine("No sectors with tag 666 or 667 used on the wrong map");
 		else
 		{
-			check_buffer = SString::printf("%d sectors have an invalid 666/667 tag", sel.count_obj());
+			check_buffer = SString::printf("%d sectors have an invalid 666/667 tag", found->sel.count_obj());
 
-			dialog.AddLine(check_buffer, 1, 350,
+			dialog.AddLine(check_buffer, found->severity, 350,
 			                "Show", &UI_Check_Tags::action_show_beast_marks);
 		}
 
 		dialog.AddGap(10);
 
 
-		int min_tag, max_tag;
+		found = &dialog.TakeFinding(passes);
 
-		tagsUsedRange(&min_tag, &max_tag);
+		int min_tag = found->value;
+		int max_tag = found->extra;
 
 		if (max_tag <= 0)
 			dialog.AddLine("No tags are in use");
@@ -3540,6 +4169,13 @@ CheckResult ChecksModule::checkTags(int min_severity) const
 
 		if (result == CheckResult::tookAction)
 		{
+			if (ready)
+			{
+				// later categories of checkAll need a re-run too
+				ready->markMapChanged();
+				ready = nullptr;
+			}
+
 			// repeat the tests
 			dialog.Reset();
 			continue;
@@ -3565,43 +4201,42 @@ static void bump_unknown_name(std::map<SString, int>& list,
 }
 
 
-static void Textures_FindMissing(const Instance &inst, selection_c& lines)
+static bool LD_is_missing_texture(const Instance &inst, const Document &doc, const LineDef &L)
 {
-	lines.change_type(ObjType::linedefs);
+	if (L.right < 0)
+		return false;
 
-	for (int n = 0 ; n < inst.level.numLinedefs(); n++)
-	{
-		const auto L = inst.level.linedefs[n];
+	if (L.OneSided())
+		return is_null_tex(doc.getRight(L)->MidTex());
 
-		if (L->right < 0)
-			continue;
+	// Two Sided
+	const Sector &front = doc.getSector(*doc.getRight(L));
+	const Sector &back  = doc.getSector(*doc.getLeft(L));
 
-		if (L->OneSided())
-		{
-			if (is_null_tex(inst.level.getRight(*L)->MidTex()))
-				lines.set(n);
-		}
-		else  // Two Sided
-		{
-			const Sector &front = inst.level.getSector(*inst.level.getRight(*L));
-			const Sector &back  = inst.level.getSector(*inst.level.getLeft(*L));
+	if (front.floorh < back.floorh && is_null_tex(doc.getRight(L)->LowerTex()))
+		return true;
 
-			if (front.floorh < back.floorh && is_null_tex(inst.level.getRight(*L)->LowerTex()))
-				lines.set(n);
+	if (back.floorh < front.floorh && is_null_tex(doc.getLeft(L)->LowerTex()))
+		return true;
 
-			if (back.floorh < front.floorh && is_null_tex(inst.level.getLeft(*L)->LowerTex()))
-				lines.set(n);
+	// missing uppers are OK when between two sky ceilings
+	if (inst.is_sky(front.CeilTex()) && inst.is_sky(back.CeilTex()))
+		return false;
 
-			// missing uppers are OK when between two sky ceilings
-			if (inst.is_sky(front.CeilTex()) && inst.is_sky(back.CeilTex()))
-				continue;
+	if (front.ceilh > back.ceilh && is_null_tex(doc.getRight(L)->UpperTex()))
+		return true;
 
-			if (front.ceilh > back.ceilh && is_null_tex(inst.level.getRight(*L)->UpperTex()))
-				lines.set(n);
+	return back.ceilh > front.ceilh && is_null_tex(doc.getLeft(L)->UpperTex());
+}
 
-			if (back.ceilh > front.ceilh && is_null_tex(inst.level.getLeft(*L)->UpperTex()))
-				lines.set(n);
-		}
+static void Textures_FindMissing(const Instance &inst, selection_c& lines)
+{
+	lines.change_type(ObjType::linedefs);
+
+	for (int n = 0 ; n < inst.level.numLinedefs(); n++)
+	{
+		if (LD_is_missing_texture(inst, inst.level, *inst.level.linedefs[n]))
+			lines.set(n);
 	}
 }
 
@@ -3689,7 +4324,7 @@ static int check_transparent(const Instance &inst, const SString &tex,
 }
 
 
-static void Textures_FindTransparent(Instance &inst, selection_c& lines,
+static void Textures_FindTransparent(const Instance &inst, selection_c& lines,
                               std::map<SString, int>& names)
 {
 	lines.change_type(ObjType::linedefs);
@@ -4407,41 +5042,96 @@ private:
 };
 
 
-CheckResult ChecksModule::checkTextures(int min_severity) const
+void ChecksModule::addTexturePasses(CheckPassList &passes) const
+{
+	const Document &doc = this->doc;
+	const Instance &inst = this->inst;
+
+	passes.add("unknown textures", 2, [&inst](CheckFinding &found)
+	{
+		Textures_FindUnknownTex(found.sel, found.names, inst);
+	});
+	passes.add("unknown flats", 2, [&inst](CheckFinding &found)
+	{
+		Textures_FindUnknownFlat(found.sel, found.names, inst);
+	});
+
+	if (! inst.conf.features.medusa_fixed)
+	{
+		passes.add("Medusa textures", 2, [&inst](CheckFinding &found)
+		{
+			Textures_FindMedusa(found.sel, found.names, inst);
+		});
+	}
+
+	if (! inst.conf.features.tuttifrutti_fixed)
+	{
+		passes.add("tutti-frutti walls", 2, [&inst](CheckFinding &found)
+		{
+			Textures_FindTuttiFrutti(found.sel, inst);
+		});
+	}
+
+	passes.add("missing textures on walls", 1, [&inst](CheckFinding &found)
+	{
+		Textures_FindMissing(inst, found.sel);
+	});
+	passes.add("transparent textures on solids", 1, [&inst](CheckFinding &found)
+	{
+		Textures_FindTransparent(inst, found.sel, found.names);
+	});
+	passes.add("non-animating switch textures", 1, [&doc](CheckFinding &found)
+	{
+		Textures_FindDupSwitches(found.sel, doc);
+	});
+}
+
+
+CheckResult ChecksModule::checkTextures(int min_severity, CheckPassList *ready) const
 {
 	UI_Check_Textures *dialog = new UI_Check_Textures(min_severity > 0, inst);
 
-	selection_c  sel;
+	const CheckFinding *found;
 
-	std::map<SString, int> names;
 	SString check_buffer;
 
 	for (;;)
 	{
-		Textures_FindUnknownTex(sel, names, inst);
+		CheckPassList fresh;
+		if (! ready)
+		{
+			addTexturePasses(fresh);
+			fresh.run();
+		}
+		CheckPassList &passes = ready ? *ready : fresh;
 
-		if (sel.empty())
+		dialog->ShowTiming(passes);
+
+
+		found = &dialog->TakeFinding(passes);
+
+		if (found->sel.empty())
 			dialog->AddLine("No unknown textures");
 		else
 		{
-			check_buffer = SString::printf("%d unknown textures", (int)names.size());
+			check_buffer = SString::printf("%d unknown textures", (int)found->names.size());
 
-			dialog->AddLine(check_buffer, 2, 200,
+			dialog->AddLine(check_buffer, found->severity, 200,
 			                "Show", &UI_Check_Textures::action_show_unk_tex,
 			                "Log",  &UI_Check_Textures::action_log_unk_tex,
 			                "Fix",  &UI_Check_Textures::action_fix_unk_tex);
 		}
 
 
-		Textures_FindUnknownFlat(sel, names, inst);
+		found = &dialog->TakeFinding(passes);
 
-		if (sel.empty())
+		if (found->sel.empty())
 			dialog->AddLine("No unknown flats");
 		else
 		{
-			check_buffer = SString::printf("%d unknown flats", (int)names.size());
+			check_buffer = SString::printf("%d unknown flats", (int)found->names.size());
 
-			dialog->AddLine(check_buffer, 2, 200,
+			dialog->AddLine(check_buffer, found->severity, 200,
 			                "Show", &UI_Check_Textures::action_show_unk_flat,
 			                "Log",  &UI_Check_Textures::action_log_unk_flat,
 			                "Fix",  &UI_Check_Textures::action_fix_unk_flat);
@@ -4450,15 +5140,15 @@ CheckResult ChecksModule::checkTextures(int min_severity) const
 
 		if (! inst.conf.features.medusa_fixed)
 		{
-			Textures_FindMedusa(sel, names, inst);
+			found = &dialog->TakeFinding(passes);
 
-			if (sel.empty())
+			if (found->sel.empty())
 				dialog->AddLine("No textures causing Medusa Effect");
 			else
 			{
-				check_buffer = SString::printf("%d Medusa textures", (int)names.size());
+				check_buffer = SString::printf("%d Medusa textures", (int)found->names.size());
 
-				dialog->AddLine(check_buffer, 2, 200,
+				dialog->AddLine(check_buffer, found->severity, 200,
 								"Show", &UI_Check_Textures::action_show_medusa,
 								"Log",  &UI_Check_Textures::action_log_medusa,
 								"Fix",  &UI_Check_Textures::action_remove_medusa);
@@ -4467,57 +5157,57 @@ CheckResult ChecksModule::checkTextures(int min_severity) const
 
 		if (!inst.conf.features.tuttifrutti_fixed)
 		{
-			Textures_FindTuttiFrutti(sel, inst);
-			if (sel.empty())
+			found = &dialog->TakeFinding(passes);
+			if (found->sel.empty())
 				dialog->AddLine("No tutti-frutti walls");
 			else
 			{
-				check_buffer = SString::printf("%d tutti-frutti walls", sel.count_obj());
-				dialog->AddLine(check_buffer, 2, 200, "Show", &UI_Check_Textures::action_show_tuttifrutti);
+				check_buffer = SString::printf("%d tutti-frutti walls", found->sel.count_obj());
+				dialog->AddLine(check_buffer, found->severity, 200, "Show", &UI_Check_Textures::action_show_tuttifrutti);
 			}
 		}
 
 		dialog->AddGap(10);
 
 
-		Textures_FindMissing(inst, sel);
+		found = &dialog->TakeFinding(passes);
 
-		if (sel.empty())
+		if (found->sel.empty())
 			dialog->AddLine("No missing textures on walls");
 		else
 		{
-			check_buffer = SString::printf("%d missing textures on walls", sel.count_obj());
+			check_buffer = SString::printf("%d missing textures on walls", found->sel.count_obj());
 
-			dialog->AddLine(check_buffer, 1, 275,
+			dialog->AddLine(check_buffer, found->severity, 275,
 			                "Show", &UI_Check_Textures::action_show_missing,
 			                "Fix",  &UI_Check_Textures::action_fix_missing);
 		}
 
 
-		Textures_FindTransparent(inst, sel, names);
+		found = &dialog->TakeFinding(passes);
 
-		if (sel.empty())
+		if (found->sel.empty())
 			dialog->AddLine("No transparent textures on solids");
 		else
 		{
-			check_buffer = SString::printf("%d transparent textures on solids", sel.count_obj());
+			check_buffer = SString::printf("%d transparent textures on solids", found->sel.count_obj());
 
-			dialog->AddLine(check_buffer, 1, 275,
+			dialog->AddLine(check_buffer, found->severity, 275,
 			                "Show", &UI_Check_Textures::action_show_transparent,
 			                "Fix",  &UI_Check_Textures::action_fix_transparent,
 			                "Log",  &UI_Check_Textures::action_log_transparent);
 		}
 
 
-		Textures_FindDupSwitches(sel, doc);
+		found = &dialog->TakeFinding(passes);
 
-		if (sel.empty())
+		if (found->sel.empty())
 			dialog->AddLine("No non-animating switch textures");
 		else
 		{
-			check_buffer = SString::printf("%d non-animating switch textures", sel.count_obj());
+			check_buffer = SString::printf("%d non-animating switch textures", found->sel.count_obj());
 
-			dialog->AddLine(check_buffer, 1, 275,
+			dialog->AddLine(check_buffer, found->severity, 275,
 			                "Show", &UI_Check_Textures::action_show_dup_switch,
 			                "Fix",  &UI_Check_Textures::action_fix_dup_switch);
 		}
@@ -4534,6 +5224,13 @@ CheckResult ChecksModule::checkTextures(int min_severity) const
 
 		if (result == CheckResult::tookAction)
 		{
+			if (ready)
+			{
+				// later categories of checkAll need a re-run too
+				ready->markMapChanged();
+				ready = nullptr;
+			}
+
 			// repeat the tests
 			dialog->Reset();
 			continue;
@@ -4557,28 +5254,54 @@ void ChecksModule::checkAll(bool major_stuff) const
 
 	CheckResult result;
 
+	// run the find-passes of all the categories in one go, they only read
+	// the level. The dialogs below are still shown one after the other.
+	CheckPassList vertices, sectors, linedefs, things, textures, tags;
+
+	addVertexPasses(vertices);
+	addSectorPasses(sectors);
+	addLinedefPasses(linedefs);
+	addThingPasses(things);
+	addTexturePasses(textures);
+	addTagPasses(tags);
+
+	CheckPassList::runAll({ &vertices, &sectors, &linedefs, &things, &textures, &tags });
+
+	// once the user fixes something, the later findings are out of date
+	bool changed = false;
+
+	auto ready = [&changed](CheckPassList &passes) -> CheckPassList *
+	{
+		return changed ? nullptr : &passes;
+	};
+
 
-	result = checkVertices(min_severity);
+	result = checkVertices(min_severity, ready(vertices));
 	if (result == CheckResult::highlight) return;
 	if (result != CheckResult::ok) no_worries = false;
+	changed |= vertices.hasMapChanged();
 
-	result = checkSectors(min_severity);
+	result = checkSectors(min_severity, ready(sectors));
 	if (result == CheckResult::highlight) return;
 	if (result != CheckResult::ok) no_worries = false;
+	changed |= sectors.hasMapChanged();
 
-	result = checkLinedefs(min_severity);
+	result = checkLinedefs(min_severity, ready(linedefs));
 	if (result == CheckResult::highlight) return;
 	if (result != CheckResult::ok) no_worries = false;
+	changed |= linedefs.hasMapChanged();
 
-	result = checkThings(min_severity);
+	result = checkThings(min_severity, ready(things));
 	if (result == CheckResult::highlight) return;
 	if (result != CheckResult::ok) no_worries = false;
+	changed |= things.hasMapChanged();
 
-	result = checkTextures(min_severity);
+	result = checkTextures(min_severity, ready(textures));
 	if (result == CheckResult::highlight) return;
 	if (result != CheckResult::ok) no_worries = false;
+	changed |= textures.hasMapChanged();
 
-	result = checkTags(min_severity);
+	result = checkTags(min_severity, ready(tags));
 	if (result == CheckResult::highlight) return;
 	if (result != CheckResult::ok) no_worries = false;
 
@@ -4591,6 +5314,86 @@ void ChecksModule::checkAll(bool major_stuff) const
 }
 
 
+//
+// Run all the checks without any dialogs, e.g. for the --check mode.
+// Only the findings which found something are reported.
+//
+double ChecksModule::runHeadless(std::vector<CheckReportEntry> &report) const
+{
+	CheckPassList vertices, sectors, linedefs, things, textures, tags;
+
+	addVertexPasses(vertices);
+	addSectorPasses(sectors);
+	addLinedefPasses(linedefs);
+	addThingPasses(things);
+	addTexturePasses(textures);
+	addTagPasses(tags);
+
+	CheckPassList::runAll({ &vertices, &sectors, &linedefs, &things, &textures, &tags });
+
+	auto collect = [&report](const char *category, const CheckPassList &passes)
+	{
+		passes.visit([&report, category](const char *name, const CheckFinding &found)
+		{
+			if (found.sel.empty())
+				return;
+
+			CheckReportEntry entry;
+
+			entry.category = category;
+			entry.name = name;
+			entry.severity = found.severity;
+			entry.type = found.sel.what_type();
+			entry.millis = found.millis;
+
+			for (sel_iter_c it(found.sel); !it.done(); it.next())
+				entry.objects.push_back(*it);
+
+			for (const auto &pair : found.types)
+				entry.details.push_back(SString::printf("%d", pair.first));
+
+			for (const auto &pair : found.names)
+				entry.details.push_back(pair.first);
+
+			report.push_back(std::move(entry));
+		});
+	};
+
+	collect("vertices", vertices);
+	collect("sectors",  sectors);
+	collect("linedefs", linedefs);
+	collect("things",   things);
+	collect("textures", textures);
+	collect("tags",     tags);
+
+	// the player starts are only a summary, without any objects
+	int dm_num;
+	int mask = Things_FindStarts(&dm_num, doc);
+
+	SString messages[2];
+	int severities[2];
+
+	if (Things_DescribeStarts(inst.conf, mask, dm_num, messages, severities))
+	{
+		for (int k = 0; k < 2; k++)
+		{
+			if (severities[k] == 0)
+				continue;
+
+			CheckReportEntry entry;
+
+			entry.category = "things";
+			entry.name = messages[k];
+			entry.severity = severities[k];
+
+			report.push_back(std::move(entry));
+		}
+	}
+
+	return vertices.totalMillis();
+}
+
+
 void Instance::CMD_MapCheck()
 {
 	SString what = EXEC_Param[0];
@@ -4657,6 +5460,15 @@ void Instance::CMD_MapCheck()
 	{
 		level.checks.checkTags(0);
 	}
+	else if (what.noCaseEqual("live"))  // problems found while editing
+	{
+		level.validator.selectProblems(*edit.Selected, edit.mode);
+
+		if (edit.Selected->empty())
+			Status_Set("No live problems here");
+		else
+			GoToErrors();
+	}
 	else
 	{
 		Beep("MapCheck: unknown keyword: %s\n", what.c_str());
@@ -4664,6 +5476,510 @@ void Instance::CMD_MapCheck()
 }
 
 
+//------------------------------------------------------------------------
+//  LIVE VALIDATION
+//------------------------------------------------------------------------
+
+//
+// Severity of each problem bit, per object type (indexed by ObjType)
+//
+static const byte live_severities[5][7] =
+{
+	{ 2 },						// things
+	{ 2, 2, 1, 1, 1, 2, 1 },	// linedefs
+	{ },						// sidedefs
+	{ 1, 2 },					// vertices
+	{ 2, 2, 2 },				// sectors
+};
+
+
+static void AddUser(std::vector<int> &users, int n)
+{
+	if (std::find(users.begin(), users.end(), n) == users.end())
+		users.push_back(n);
+}
+
+
+void LiveValidator::notifyInsert(ObjType type, int objnum)
+{
+	if (! valid)
+		return;
+
+	std::vector<byte> &list = flagsOf(type);
+
+	SYS_ASSERT(0 <= objnum && objnum <= (int)list.size());
+
+	list.insert(list.begin() + objnum, 0);
+
+	for (int &n : dirtyObjects[(int)type])
+		if (n >= objnum)
+			n++;
+
+	markDirty(type, objnum);
+	usersValid = false;
+
+	if (type == ObjType::vertices)
+	{
+		vertexLines.insert(vertexLines.begin() + objnum, 0);
+		vertexWeight.insert(vertexWeight.begin() + objnum, 0);
+
+		// same renumbering as done to the linedefs
+		for (LineRefs &refs : lineRefs)
+		{
+			if (refs.v1 >= objnum) refs.v1++;
+			if (refs.v2 >= objnum) refs.v2++;
+		}
+	}
+	else if (type == ObjType::linedefs)
+	{
+		lineRefs.insert(lineRefs.begin() + objnum, LineRefs());
+	}
+}
+
+
+void LiveValidator::notifyDelete(ObjType type, int objnum)
+{
+	if (! valid)
+		return;
+
+	SYS_ASSERT(0 <= objnum && objnum < (int)flagsOf(type).size());
+
+	setProblems(type, objnum, 0);
+
+	std::vector<int> &dirtyList = dirtyObjects[(int)type];
+	dirtyList.erase(std::remove(dirtyList.begin(), dirtyList.end(), objnum), dirtyList.end());
+
+	for (int &n : dirtyList)
+		if (n > objnum)
+			n--;
+
+	usersValid = false;
+
+	if (type == ObjType::vertices)
+	{
+		vertexLines.erase(vertexLines.begin() + objnum);
+		vertexWeight.erase(vertexWeight.begin() + objnum);
+
+		for (LineRefs &refs : lineRefs)
+		{
+			if (refs.v1 == objnum) refs.v1 = -1;
+			else if (refs.v1 > objnum) refs.v1--;
+
+			if (refs.v2 == objnum) refs.v2 = -1;
+			else if (refs.v2 > objnum) refs.v2--;
+		}
+	}
+	else if (type == ObjType::linedefs)
+	{
+		// its vertices may now be unused or dangling
+		removeLineRefs(objnum);
+		lineRefs.erase(lineRefs.begin() + objnum);
+	}
+
+	std::vector<byte> &list = flagsOf(type);
+	list.erase(list.begin() + objnum);
+}
+
+
+void LiveValidator::notifyChange(ObjType type, int objnum)
+{
+	if (! valid)
+		return;
+
+	SYS_ASSERT(0 <= objnum && objnum < (int)flagsOf(type).size());
+
+	markDirty(type, objnum);
+}
+
+
+void LiveValidator::notifyEnd()
+{
+	if (! valid)
+		return;
+
+	// something changed the map behind our back?
+	if ((int)flagsOf(ObjType::things).size()   != doc.numThings()   ||
+		(int)flagsOf(ObjType::linedefs).size() != doc.numLinedefs() ||
+		(int)flagsOf(ObjType::sidedefs).size() != doc.numSidedefs() ||
+		(int)flagsOf(ObjType::vertices).size() != doc.numVertices() ||
+		(int)flagsOf(ObjType::sectors).size()  != doc.numSectors())
+	{
+		valid = false;
+		return;
+	}
+
+	update();
+}
+
+
+//
+// Get the problem counts, checking the whole map if needed
+//
+const LiveValidator::Totals &LiveValidator::totals()
+{
+	if (! valid)
+		rebuild();
+
+	return mTotals;
+}
+
+
+//
+// Select the objects of the given type which have live problems
+//
+void LiveValidator::selectProblems(selection_c &list, ObjType type)
+{
+	if (! valid)
+		rebuild();
+
+	list.change_type(type);
+
+	const std::vector<byte> &problems = flagsOf(type);
+
+	for (int n = 0; n < (int)problems.size(); n++)
+		if (problems[n] & ~DIRTY)
+			list.set(n);
+}
+
+
+void LiveValidator::rebuild()
+{
+	for (int t = 0; t < NUM_TYPES; t++)
+	{
+		flags[t].clear();
+		dirtyObjects[t].clear();
+
+		for (int b = 0; b < NUM_BITS; b++)
+			bitCounts[t][b] = 0;
+	}
+
+	mTotals = Totals();
+
+	flagsOf(ObjType::things).assign(doc.numThings(), DIRTY);
+	flagsOf(ObjType::linedefs).assign(doc.numLinedefs(), DIRTY);
+	flagsOf(ObjType::sidedefs).assign(doc.numSidedefs(), 0);
+	flagsOf(ObjType::vertices).assign(doc.numVertices(), DIRTY);
+	flagsOf(ObjType::sectors).assign(doc.numSectors(), DIRTY);
+
+	vertexLines.assign(doc.numVertices(), 0);
+	vertexWeight.assign(doc.numVertices(), 0);
+	lineRefs.assign(doc.numLinedefs(), LineRefs());
+
+	// only the linedefs themselves need checking, not their neighbours
+	for (ObjType type : { ObjType::things, ObjType::linedefs, ObjType::vertices, ObjType::sectors })
+	{
+		std::vector<int> &list = dirtyObjects[(int)type];
+		list.resize(flagsOf(type).size());
+		std::iota(list.begin(), list.end(), 0);
+	}
+
+	usersValid = false;
+	valid = true;
+
+	update();
+}
+
+
+//
+// Re-check the objects marked dirty
+//
+void LiveValidator::update()
+{
+	std::vector<int> &lineList = dirtyObjects[(int)ObjType::linedefs];
+	std::vector<int> &vertList = dirtyObjects[(int)ObjType::vertices];
+	std::vector<int> &sideList = dirtyObjects[(int)ObjType::sidedefs];
+	std::vector<int> &secList  = dirtyObjects[(int)ObjType::sectors];
+
+	// linedefs also depend on their vertices, sidedefs and sectors
+	if (! vertList.empty() || ! sideList.empty() || ! secList.empty())
+	{
+		if (! usersValid)
+			buildUsers();
+
+		// a sidedef may have moved to another sector
+		for (int sd : sideList)
+		{
+			int sec = doc.sidedefs[sd]->sector;
+
+			if (doc.isSector(sec))
+				AddUser(sectorSidedefs[sec], sd);
+		}
+
+		for (int v : vertList)
+			for (int n : vertexUsers[v])
+			{
+				const LineDef &L = *doc.linedefs[n];
+
+				if (L.start == v || L.end == v)
+					markDirty(ObjType::linedefs, n);
+			}
+
+		std::vector<byte> &sideFlags = flagsOf(ObjType::sidedefs);
+
+		for (int sd : sideList)
+		{
+			touchSidedef(sd);
+			sideFlags[sd] &= ~DIRTY;
+		}
+
+		sideList.clear();
+
+		for (int sec : secList)
+			for (int sd : sectorSidedefs[sec])
+				if (doc.sidedefs[sd]->sector == sec)
+					touchSidedef(sd);
+	}
+
+	// linedefs go first, since they mark the vertices they use
+	for (int n : lineList)
+		checkLine(n);
+
+	for (int n : vertList)
+		checkVertex(n);
+
+	for (int n : secList)
+		checkSector(n);
+
+	for (int n : dirtyObjects[(int)ObjType::things])
+		checkThing(n);
+
+	for (std::vector<int> &list : dirtyObjects)
+		list.clear();
+}
+
+
+void LiveValidator::markDirty(ObjType type, int objnum)
+{
+	byte &flag = flagsOf(type)[objnum];
+
+	if (flag & DIRTY)
+		return;
+
+	flag |= DIRTY;
+	dirtyObjects[(int)type].push_back(objnum);
+}
+
+
+//
+// Index the users of each vertex, sidedef and sector from scratch
+//
+void LiveValidator::buildUsers()
+{
+	vertexUsers.assign(doc.numVertices(), {});
+	sidedefUsers.assign(doc.numSidedefs(), {});
+	sectorSidedefs.assign(doc.numSectors(), {});
+
+	for (int n = 0; n < doc.numLinedefs(); n++)
+	{
+		const LineDef &L = *doc.linedefs[n];
+
+		AddUser(vertexUsers[L.start], n);
+		AddUser(vertexUsers[L.end], n);
+
+		for (int sd : { L.right, L.left })
+			if (doc.isSidedef(sd))
+				AddUser(sidedefUsers[sd], n);
+	}
+
+	for (int sd = 0; sd < doc.numSidedefs(); sd++)
+	{
+		int sec = doc.sidedefs[sd]->sector;
+
+		if (doc.isSector(sec))
+			sectorSidedefs[sec].push_back(sd);
+	}
+
+	usersValid = true;
+}
+
+
+//
+// Mark the linedefs using the given sidedef
+//
+void LiveValidator::touchSidedef(int sd)
+{
+	for (int n : sidedefUsers[sd])
+	{
+		const LineDef &L = *doc.linedefs[n];
+
+		if (L.right == sd || L.left == sd)
+			markDirty(ObjType::linedefs, n);
+	}
+}
+
+
+//
+// Replace the problem bits of an object (clearing its dirty mark)
+//
+void LiveValidator::setProblems(ObjType type, int objnum, byte problems)
+{
+	byte &flag = flagsOf(type)[objnum];
+
+	byte old = flag & ~DIRTY;
+
+	flag = problems;
+
+	if (old == problems)
+		return;
+
+	for (int b = 0; b < NUM_BITS; b++)
+	{
+		int change = ((problems >> b) & 1) - ((old >> b) & 1);
+		if (change == 0)
+			continue;
+
+		bitCounts[(int)type][b] += change;
+
+		if (live_severities[(int)type][b] >= 2)
+			mTotals.major += change;
+		else
+			mTotals.minor += change;
+	}
+}
+
+
+void LiveValidator::addLineRefs(int n)
+{
+	const LineDef &L = *doc.linedefs[n];
+	LineRefs &refs = lineRefs[n];
+
+	// dangling vertices are fine for lines sitting inside a sector
+	bool inside = L.TwoSided() && doc.getSectorID(L, Side::left) == doc.getSectorID(L, Side::right);
+
+	refs.v1 = L.start;
+	refs.v2 = L.end;
+	refs.weight = inside ? 2 : 1;
+
+	for (int v : { refs.v1, refs.v2 })
+	{
+		vertexLines[v] += 1;
+		vertexWeight[v] += refs.weight;
+		markDirty(ObjType::vertices, v);
+	}
+}
+
+
+void LiveValidator::removeLineRefs(int n)
+{
+	LineRefs &refs = lineRefs[n];
+
+	for (int v : { refs.v1, refs.v2 })
+	{
+		if (v < 0 || refs.weight == 0)
+			continue;
+
+		vertexLines[v] -= 1;
+		vertexWeight[v] -= refs.weight;
+		markDirty(ObjType::vertices, v);
+	}
+
+	refs = LineRefs();
+}
+
+
+void LiveValidator::checkLine(int n)
+{
+	const LineDef &L = *doc.linedefs[n];
+
+	removeLineRefs(n);
+	addLineRefs(n);
+
+	// the index only gains entries here, the stale ones get skipped
+	if (usersValid)
+	{
+		AddUser(vertexUsers[L.start], n);
+		AddUser(vertexUsers[L.end], n);
+
+		for (int sd : { L.right, L.left })
+			if (doc.isSidedef(sd))
+				AddUser(sidedefUsers[sd], n);
+	}
+
+	byte problems = 0;
+
+	if (doc.isZeroLength(L))
+		problems |= LP_zeroLength;
+
+	if (L.right < 0)
+		problems |= LP_noRightSide;
+
+	if (LD_is_unknown_type(inst, L.type))
+		problems |= LP_unknownType;
+
+	if (LD_lacks_impass(L))
+		problems |= LP_lackImpass;
+
+	if (LD_has_bad_2s_flag(L))
+		problems |= LP_bad2SFlag;
+
+	for (const SideDef *SD : { doc.getRight(L), doc.getLeft(L) })
+	{
+		if (! SD)
+			continue;
+
+		if (! inst.wad.images.W_TextureIsKnown(inst.conf, SD->LowerTex()) ||
+			! inst.wad.images.W_TextureIsKnown(inst.conf, SD->UpperTex()) ||
+			! inst.wad.images.W_TextureIsKnown(inst.conf, SD->MidTex()))
+		{
+			problems |= LP_unknownTex;
+		}
+	}
+
+	if (LD_is_missing_texture(inst, doc, L))
+		problems |= LP_missingTex;
+
+	setProblems(ObjType::linedefs, n, problems);
+}
+
+
+void LiveValidator::checkVertex(int n)
+{
+	byte problems = 0;
+
+	if (vertexLines[n] == 0)
+		problems |= VP_unused;
+	else if (vertexWeight[n] == 1)
+		problems |= VP_dangling;
+
+	setProblems(ObjType::vertices, n, problems);
+}
+
+
+void LiveValidator::checkSector(int n)
+{
+	const Sector &S = *doc.sectors[n];
+
+	byte problems = 0;
+
+	if (S.ceilh < S.floorh)
+		problems |= SP_badCeiling;
+
+	int type_num = S.type;
+
+	if (SEC_is_unknown_type(inst, M_CalcMaxSectorType(inst.conf), type_num))
+		problems |= SP_unknownType;
+
+	if (! inst.wad.images.W_FlatIsKnown(inst.conf, S.FloorTex()) ||
+		! inst.wad.images.W_FlatIsKnown(inst.conf, S.CeilTex()))
+	{
+		problems |= SP_unknownFlat;
+	}
+
+	setProblems(ObjType::sectors, n, problems);
+}
+
+
+void LiveValidator::checkThing(int n)
+{
+	byte problems = 0;
+
+	if (TH_is_unknown_type(inst, doc.things[n]->type))
+		problems |= TP_unknownType;
+
+	setProblems(ObjType::things, n, problems);
+}
+
+
 void Debug_CheckUnusedStuff(Document &doc)
 {
 	selection_c sel;
@@ -28,7 +28,9 @@
 #define __EUREKA_E_CHECKS_H__
 
 #include "DocumentModule.h"
+#include "objid.h"
 #include "ui_window.h"
+#include <vector>
 
 // the CHECK_xxx functions return the following values:
 enum class CheckResult
@@ -40,6 +42,24 @@ enum class CheckResult
 	tookAction		// [internal use : user took some action]
 };
 
+class CheckPassList;
+
+//
+// One finding of the map checks, when run without the dialogs
+//
+struct CheckReportEntry
+{
+	SString category;	// "vertices", "sectors", ...
+	SString name;		// e.g. "dangling vertices"
+	int severity = 0;	// 1 = minor, 2 = major
+
+	ObjType type = ObjType::things;
+	std::vector<int> objects;
+	std::vector<SString> details;	// e.g. the unknown texture names
+
+	double millis = 0;	// how long the pass took
+};
+
 //
 // The map checking module
 //
@@ -55,20 +75,146 @@ public:
 	void tagsApplyNewValue(int new_tag);
 	void tagsUsedRange(int *min_tag, int *max_tag) const;
 
+	// runs all the checks (no dialogs), returns the total time in ms
+	double runHeadless(std::vector<CheckReportEntry> &report) const;
+
 private:
 	void checkAll(bool majorStuff) const;
 
-	CheckResult checkVertices(int minSeverity) const;
-	CheckResult checkSectors(int minSeverity) const;
-	CheckResult checkThings(int minSeverity) const;
-	CheckResult checkLinedefs(int minSeverity) const;
-	CheckResult checkTags(int minSeverity) const;
-	CheckResult checkTextures(int minSeverity) const;
+	// if 'ready' is given, its passes were already run (see checkAll)
+	CheckResult checkVertices(int minSeverity, CheckPassList *ready = nullptr) const;
+	CheckResult checkSectors(int minSeverity, CheckPassList *ready = nullptr) const;
+	CheckResult checkThings(int minSeverity, CheckPassList *ready = nullptr) const;
+	CheckResult checkLinedefs(int minSeverity, CheckPassList *ready = nullptr) const;
+	CheckResult checkTags(int minSeverity, CheckPassList *ready = nullptr) const;
+	CheckResult checkTextures(int minSeverity, CheckPassList *ready = nullptr) const;
+
+	void addVertexPasses(CheckPassList &passes) const;
+	void addSectorPasses(CheckPassList &passes) const;
+	void addThingPasses(CheckPassList &passes) const;
+	void addLinedefPasses(CheckPassList &passes) const;
+	void addTagPasses(CheckPassList &passes) const;
+	void addTexturePasses(CheckPassList &passes) const;
 
 	int copySidedef(EditOperation &op, int num) const;
 };
 
+//
+// Live validation: keeps the results of the cheap per-object checks up to
+// date while the map is edited. It follows the Basis notifications and only
+// re-checks the touched objects (plus the linedefs using touched vertices,
+// sidedefs or sectors), so it can run after every edit operation. The users
+// of each vertex, sidedef and sector are indexed to find those linedefs.
+//
+class LiveValidator : public DocumentModule
+{
+public:
+	// problem bits, per object type
+	enum
+	{
+		LP_zeroLength	= 1 << 0,
+		LP_noRightSide	= 1 << 1,
+		LP_unknownType	= 1 << 2,
+		LP_lackImpass	= 1 << 3,
+		LP_bad2SFlag	= 1 << 4,
+		LP_unknownTex	= 1 << 5,
+		LP_missingTex	= 1 << 6,
+
+		SP_badCeiling	= 1 << 0,
+		SP_unknownType	= 1 << 1,
+		SP_unknownFlat	= 1 << 2,
+
+		TP_unknownType	= 1 << 0,
+
+		VP_unused		= 1 << 0,
+		VP_dangling		= 1 << 1,
+	};
+
+	struct Totals
+	{
+		int major = 0;
+		int minor = 0;
+	};
+
+	LiveValidator(Document &doc) : DocumentModule(doc)
+	{
+	}
+
+	void notifyInsert(ObjType type, int objnum);
+	void notifyDelete(ObjType type, int objnum);
+	void notifyChange(ObjType type, int objnum);
+	void notifyEnd();
+
+	// the whole map changed (e.g. loading, or new game config)
+	void invalidate()
+	{
+		valid = false;
+	}
+
+	const Totals &totals();
+	void selectProblems(selection_c &list, ObjType type);
+
+private:
+	// added to the problem bits of objects waiting for a re-check
+	static constexpr byte DIRTY = 0x80;
+
+	static const int NUM_TYPES = 5;
+	static const int NUM_BITS = 7;
+
+	struct LineRefs
+	{
+		int v1 = -1;
+		int v2 = -1;
+		int weight = 0;
+	};
+
+	void rebuild();
+	void update();
+
+	void markDirty(ObjType type, int objnum);
+	void buildUsers();
+	void touchSidedef(int sd);
+
+	void setProblems(ObjType type, int objnum, byte problems);
+	void checkLine(int n);
+	void checkVertex(int n);
+	void checkSector(int n);
+	void checkThing(int n);
+
+	void addLineRefs(int n);
+	void removeLineRefs(int n);
+
+	std::vector<byte> &flagsOf(ObjType type)
+	{
+		return flags[(int)type];
+	}
+
+	bool valid = false;
+
+	std::vector<byte> flags[NUM_TYPES];
+	std::vector<int> dirtyObjects[NUM_TYPES];	// the ones marked DIRTY
+
+	// linedefs per vertex and per sidedef, and sidedefs per sector. These
+	// may hold stale entries, and get rebuilt when objects are inserted or
+	// deleted.
+	bool usersValid = false;
+	std::vector<std::vector<int>> vertexUsers;
+	std::vector<std::vector<int>> sidedefUsers;
+	std::vector<std::vector<int>> sectorSidedefs;
+
+	// vertex usage, see Vertex_FindDanglers() and Vertex_FindUnused()
+	std::vector<int> vertexLines;
+	std::vector<int> vertexWeight;
+	std::vector<LineRefs> lineRefs;
+
+	int bitCounts[NUM_TYPES][NUM_BITS] = {};
+	Totals mTotals;
+};
+
 int findFreeTag(const Instance &inst, ObjType type);
+void Things_FindStuckies(selection_c& list, const Instance &inst);
+void Vertex_FindOverlaps(selection_c& sel, const Document &doc, std::vector<int> *bases = nullptr);
+void LineDefs_FindOverlaps(selection_c& lines, const Document &doc);
 
 #endif  /* __EUREKA_E_CHECKS_H__ */
 
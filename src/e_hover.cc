@@ -600,13 +600,25 @@ int Hover::getOppositeSector(int ld, Side ld_side, FastOppositeTree *tree) const
 //
 // Begin fast-opposite mode
 //
-FastOppositeTree::FastOppositeTree(Instance &inst)
+FastOppositeTree::FastOppositeTree(const Document &doc)
 {
-	inst.level.CalculateLevelBounds();
-	Document &doc = inst.level;
+	// compute the bounds here instead of via CalculateLevelBounds(), so
+	// the document stays untouched (the map checks build this concurrently)
+	v2double_t low = { 0, 0 };
+	v2double_t high = { 0, 0 };
 
-	m_fastopp_X_tree.emplace(static_cast<int>(inst.level.Map_bound1.x - 8), static_cast<int>(inst.level.Map_bound2.x + 8), doc);
-	m_fastopp_Y_tree.emplace(static_cast<int>(inst.level.Map_bound1.y - 8), static_cast<int>(inst.level.Map_bound2.y + 8), doc);
+	for(int n = 0; n < doc.numVertices(); n++)
+	{
+		const Vertex &V = *doc.vertices[n];
+
+		if(n == 0 || V.x() < low.x)  low.x  = V.x();
+		if(n == 0 || V.y() < low.y)  low.y  = V.y();
+		if(n == 0 || V.x() > high.x) high.x = V.x();
+		if(n == 0 || V.y() > high.y) high.y = V.y();
+	}
+
+	m_fastopp_X_tree.emplace(static_cast<int>(low.x - 8), static_cast<int>(high.x + 8), doc);
+	m_fastopp_Y_tree.emplace(static_cast<int>(low.y - 8), static_cast<int>(high.y + 8), doc);
 
 	for(int n = 0; n < doc.numLinedefs(); n++)
 	{
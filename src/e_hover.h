@@ -98,7 +98,7 @@ public:
 
 struct FastOppositeTree
 {
-	explicit FastOppositeTree(Instance &inst);
+	explicit FastOppositeTree(const Document &doc);
 	
 	std::optional<fastopp_node_c> m_fastopp_X_tree;
 	std::optional<fastopp_node_c> m_fastopp_Y_tree;
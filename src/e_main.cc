@@ -418,6 +418,14 @@ void Instance::MapStuff_NotifyBegin()
 
 void Instance::MapStuff_NotifyInsert(ObjType type, int objnum)
 {
+	map_revision++;
+
+	// inserting renumbers the later objects
+	if (type == ObjType::things)
+		sector_info_cache.InvalidateFloors();
+	else
+		Subdiv_InvalidateAll();
+
 	if (type == ObjType::vertices)
 	{
 		if (new_vertex_minimum < 0 || objnum < new_vertex_minimum)
@@ -427,6 +435,13 @@ void Instance::MapStuff_NotifyInsert(ObjType type, int objnum)
 
 void Instance::MapStuff_NotifyDelete(ObjType type, int objnum)
 {
+	map_revision++;
+
+	if (type == ObjType::things)
+		sector_info_cache.InvalidateFloors();
+	else
+		Subdiv_InvalidateAll();
+
 	if (type == ObjType::vertices)
 	{
 		recalc_map_bounds = true;
@@ -441,6 +456,8 @@ void Instance::MapStuff_NotifyDelete(ObjType type, int objnum)
 
 void Instance::MapStuff_NotifyChange(ObjType type, int objnum, Field field)
 {
+	map_revision++;
+
 	if (type == ObjType::vertices)
 	{
 		// NOTE: for performance reasons we don't recalculate the
@@ -455,22 +472,35 @@ void Instance::MapStuff_NotifyChange(ObjType type, int objnum, Field field)
 		if (V->x() > level.Map_bound2.x) level.Map_bound2.x = V->x();
 		if (V->y() > level.Map_bound2.y) level.Map_bound2.y = V->y();
 
-		// TODO: only invalidate sectors touching vertex
-		Subdiv_InvalidateAll();
+		sector_info_cache.InvalidateVertex(objnum);
 	}
 
+	if (type == ObjType::things)
+		sector_info_cache.InvalidateThing(objnum);
+
 	std::visit(overloaded {
-		[this, type](int field) {
+		[this, type, objnum](int field) {
 			if (type == ObjType::sidedefs && field == SideDef::F_SECTOR)
-				Subdiv_InvalidateAll();
-
+				sector_info_cache.InvalidateSides();
 
 			if (type == ObjType::sectors && (field == Sector::F_FLOORH || field == Sector::F_CEILH))
-				Subdiv_InvalidateAll();
+				sector_info_cache.InvalidateSector(objnum);
+
+			if (type == ObjType::sectors && field == Sector::F_TAG)
+				sector_info_cache.InvalidateFloors();
 		},
-		[this, type](int LineDef::*field) {
-			if (type == ObjType::linedefs && (field == &LineDef::left || field == &LineDef::right || field == &LineDef::start || field == &LineDef::end))
-				Subdiv_InvalidateAll();
+		[this, type, objnum](int LineDef::*field) {
+			if (type != ObjType::linedefs)
+				return;
+
+			if (field == &LineDef::left || field == &LineDef::right)
+				sector_info_cache.InvalidateSides();
+			else if (field == &LineDef::start || field == &LineDef::end)
+				sector_info_cache.InvalidateLineDef(objnum);
+			else if (field == &LineDef::type ||
+					 field == &LineDef::arg1 || field == &LineDef::arg2 || field == &LineDef::arg3 ||
+					 field == &LineDef::arg4 || field == &LineDef::arg5)
+				sector_info_cache.InvalidateFloors();
 		},
 		[](auto arg) {}
 	}, field);
@@ -47,15 +47,126 @@
 #include <algorithm>
 
 
+size_t VertexCoordIndex::Hash::operator() (const v2double_t &pos) const noexcept
+{
+	// -0.0 equals 0.0, so it must hash the same
+	size_t hx = std::hash<double>()(pos.x == 0 ? 0.0 : pos.x);
+	size_t hy = std::hash<double>()(pos.y == 0 ? 0.0 : pos.y);
+
+	return hx ^ (hy + 0x9e3779b9 + (hx << 6) + (hx >> 2));
+}
+
+
+void VertexCoordIndex::add(int v, const v2double_t &pos)
+{
+	buckets.emplace(pos, v);
+}
+
+
+void VertexCoordIndex::remove(int v, const v2double_t &pos)
+{
+	auto range = buckets.equal_range(pos);
+
+	for (auto it = range.first ; it != range.second ; ++it)
+	{
+		if (it->second == v)
+		{
+			buckets.erase(it);
+			return;
+		}
+	}
+}
+
+
+int VertexCoordIndex::find(const v2double_t &pos) const
+{
+	int best = -1;
+
+	auto range = buckets.equal_range(pos);
+
+	for (auto it = range.first ; it != range.second ; ++it)
+	{
+		if (best < 0 || it->second < best)
+			best = it->second;
+	}
+
+	return best;
+}
+
+
 int VertexModule::findExact(double fx, double fy) const
 {
-	for (int i = 0 ; i < doc.numVertices() ; i++)
+	updateIndex();
+
+	int v = coordIndex.find({ fx, fy });
+
+	// moved without a notification? then start afresh
+	if (v >= 0 && ! doc.vertices[v]->Matches(fx, fy))
 	{
-		if (doc.vertices[i]->Matches(fx, fy))
-			return i;
+		indexValid = false;
+		updateIndex();
+
+		v = coordIndex.find({ fx, fy });
 	}
 
-	return -1;  // not found
+	return v;
+}
+
+
+void VertexModule::updateIndex() const
+{
+	if (! indexValid || (int)indexedPos.size() > doc.numVertices())
+	{
+		coordIndex.clear();
+		indexedPos.clear();
+
+		indexValid = true;
+	}
+
+	// pick up the vertices added since the last lookup
+	for (int v = (int)indexedPos.size() ; v < doc.numVertices() ; v++)
+	{
+		indexedPos.push_back(doc.vertices[v]->xy());
+		coordIndex.add(v, indexedPos.back());
+	}
+}
+
+
+void VertexModule::notifyInsert(ObjType type, int objnum)
+{
+	// anything but adding at the end renumbers the vertices
+	if (type == ObjType::vertices && objnum < (int)indexedPos.size())
+		indexValid = false;
+}
+
+
+void VertexModule::notifyDelete(ObjType type, int objnum)
+{
+	if (type != ObjType::vertices || ! indexValid || objnum >= (int)indexedPos.size())
+		return;
+
+	if (objnum == (int)indexedPos.size() - 1)
+	{
+		coordIndex.remove(objnum, indexedPos.back());
+		indexedPos.pop_back();
+	}
+	else
+	{
+		indexValid = false;
+	}
+}
+
+
+void VertexModule::notifyChange(ObjType type, int objnum)
+{
+	if (type != ObjType::vertices || ! indexValid || objnum >= (int)indexedPos.size())
+		return;
+
+	// the change has already been made
+	coordIndex.remove(objnum, indexedPos[objnum]);
+
+	indexedPos[objnum] = doc.vertices[objnum]->xy();
+	coordIndex.add(objnum, indexedPos[objnum]);
 }
 
 
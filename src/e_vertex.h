@@ -28,9 +28,41 @@
 #define __EUREKA_E_VERTEX_H__
 
 #include "DocumentModule.h"
+#include "m_vector.h"
+#include "objid.h"
+
+#include <unordered_map>
+#include <vector>
 
 struct vert_along_t;
 
+//
+// Buckets vertices by their exact coordinates, so the vertices sitting on
+// a given spot are found in constant expected time.
+//
+class VertexCoordIndex
+{
+public:
+	void clear()
+	{
+		buckets.clear();
+	}
+
+	void add(int v, const v2double_t &pos);
+	void remove(int v, const v2double_t &pos);
+
+	// lowest numbered vertex at the spot, or -1
+	int find(const v2double_t &pos) const;
+
+private:
+	struct Hash
+	{
+		size_t operator() (const v2double_t &pos) const noexcept;
+	};
+
+	std::unordered_multimap<v2double_t, int, Hash> buckets;
+};
+
 class VertexModule : public DocumentModule
 {
 	friend class Instance;
@@ -40,6 +72,16 @@ public:
 	}
 
 	int findExact(double fx, double fy) const;
+
+	// keep the index of findExact() in step with the edits
+	void notifyInsert(ObjType type, int objnum);
+	void notifyDelete(ObjType type, int objnum);
+	void notifyChange(ObjType type, int objnum);
+	void invalidateIndex()
+	{
+		indexValid = false;
+	}
+
 	int findDragOther(int v_num) const;
 	int howManyLinedefs(int v_num) const;
 	void mergeList(EditOperation &op, selection_c &list, selection_c *deletedResultList) const;
@@ -59,6 +101,14 @@ private:
 		unsigned int start_idx, double arc_rad,
 		double ang_offset /* radians */,
 		bool move_vertices = false) const;
+
+	void updateIndex() const;
+
+	// built on demand by findExact(). Vertices added at the end are only
+	// indexed on the next lookup, since their position is set after adding.
+	mutable VertexCoordIndex coordIndex;
+	mutable std::vector<v2double_t> indexedPos;
+	mutable bool indexValid = false;
 };
 
 #endif  /* __EUREKA_E_VERTEX_H__ */
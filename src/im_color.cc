@@ -68,6 +68,24 @@ bool Palette::updateGamma(int usegamma, int panel_gamma)
 		rgb555_gamma [d] = static_cast<byte>(gammatable[usegamma][i]);
 		rgb555_medium[d] = static_cast<byte>(gammatable[panel_gamma][i]);
 	}
+
+	// rebuild the lookup table used by decodePixels()
+	pixel_rgb.resize(65536 * 4);
+
+	for (int p = 0 ; p < 65536 ; p++)
+	{
+		byte *rgb = &pixel_rgb[p * 4];
+
+		// values between 256 and 32767 are not valid pixels, just keep
+		// them in range of the palette
+		img_pixel_t pix = static_cast<img_pixel_t>(p);
+
+		if (! (pix & IS_RGB_PIXEL))
+			pix &= 255;
+
+		decodePixel(pix, rgb[0], rgb[1], rgb[2]);
+		rgb[3] = 0;
+	}
 	return true;
 }
 
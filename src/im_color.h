@@ -31,6 +31,7 @@
 #include "sys_type.h"
 #include "WindowsSanitization.h"	// needed for Windows
 #include <algorithm>
+#include <vector>
 
 class Lump_c;
 class SString;
@@ -101,6 +102,9 @@ public:
 	bool updateGamma(int usegamma, int panel_gamma);
 	void decodePixel(img_pixel_t p, byte &r, byte &g, byte &b) const;
 	void decodePixelMedium(img_pixel_t p, byte &r, byte &g, byte &b) const noexcept;
+	void decodePixels(const img_pixel_t *src, byte *dest, int count) const noexcept;
+	void decodePixelsDoubled(const img_pixel_t *src, byte *dest, int count) const noexcept;
+	void decodePixelsBGRA(const img_pixel_t *src, byte *dest, int count) const noexcept;
 	void createBrightMap();
 
 	rgb_color_t getPaletteColor(int index) const
@@ -118,6 +122,11 @@ public:
 		return raw_colormap[cmap][pos];
 	}
 
+	const byte *getColormap(int cmap) const
+	{
+		return raw_colormap[cmap];
+	}
+
 	int getTransReplace() const
 	{
 		return trans_replace;
@@ -132,6 +141,9 @@ private:
 	byte bright_map[256] = {};
 	byte raw_palette[256][3] = {};
 	byte raw_colormap[32][256] = {};
+	// R, G, B (and an unused byte) for every img_pixel_t value, using the
+	// same gamma as decodePixel().  Empty until a palette is loaded.
+	std::vector<byte> pixel_rgb;
 	// the palette color closest to what TRANS_PIXEL really is
 	int trans_replace = 0;
 
@@ -30,6 +30,7 @@
 
 #include "im_img.h"
 #include "m_game.h"
+#include <chrono>
 #include <optional>
 
 #ifndef NO_OPENGL
@@ -43,6 +44,8 @@
 
 #define DIGIT_FONT_COLOR   rgbMake(68, 221, 255)
 
+GLUploadStats global::gl_uploads;
+
 
 rgb_color_t Palette::pixelToRGB(img_pixel_t p) const
 {
@@ -284,6 +287,10 @@ void Img_c::bind_gl(const WadData &wad) {}
 
 void Img_c::load_gl(const WadData &wad)
 {
+	typedef std::chrono::steady_clock clock;
+
+	clock::time_point start = clock::now();
+
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
 	glGenTextures(1, &gl_tex);
@@ -302,47 +309,30 @@ void Img_c::load_gl(const WadData &wad)
 		th = RoundPOW2(h);
 	}
 
-	byte *rgba = new byte[tw * th * 4];
+	// reused between uploads, which only happen on the main thread
+	static std::vector<byte> rgba;
 
-	memset(rgba, 0, (size_t)(tw * th * 4));
+	rgba.assign((size_t)tw * th * 4, 0);
 
+	// images with transparent parts are padded with it, others get
+	// repeated into the padding
 	bool has_trans = has_transparent();
 
-	int ex = has_trans ? w : tw;
 	int ey = has_trans ? h : th;
 
-	int x, y;
-
-	for (y = 0 ; y < ey ; y++)
+	for (int y = 0 ; y < ey ; y++)
 	{
 		// invert source Y for OpenGL
 		int sy = h - 1 - y;
 		if (sy < 0)
 			sy += h;
 
-		for (x = 0 ; x < ex ; x++)
-		{
-			int sx = x;
-			if (sx >= w)
-				sx = x - w;
-
-			// convert pixel to RGBA
-			const img_pixel_t pix = buf()[sy*w + sx];
-
-			if (pix != TRANS_PIXEL)
-			{
-				byte r, g, b;
-
-				wad.palette.decodePixel(pix, r, g, b);
+		byte *dest = &rgba[(size_t)y * tw * 4];
 
-				byte *dest = rgba + (y*tw + x) * 4;
+		wad.palette.decodePixelsBGRA(buf() + sy * w, dest, w);
 
-				dest[0] = b;
-				dest[1] = g;
-				dest[2] = r;
-				dest[3] = 255;
-			}
-		}
+		if (! has_trans && tw > w)
+			memcpy(dest + w * 4, dest, (size_t)(tw - w) * 4);
 	}
 
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -350,9 +340,11 @@ void Img_c::load_gl(const WadData &wad)
 
 	glTexImage2D(GL_TEXTURE_2D, 0 /* mip */,
 		GL_RGBA8, tw, th, 0 /* border */,
-		GL_BGRA_EXT, GL_UNSIGNED_INT_8_8_8_8_REV, rgba);
+		GL_BGRA_EXT, GL_UNSIGNED_INT_8_8_8_8_REV, rgba.data());
 
-	delete[] rgba;
+	global::gl_uploads.images += 1;
+	global::gl_uploads.bytes  += rgba.size();
+	global::gl_uploads.millis += std::chrono::duration<double, std::milli>(clock::now() - start).count();
 }
 
 
@@ -392,6 +384,9 @@ void ImageSet::IM_ResetDummyTextures()
 	special_tex_color  = -1;
 	unknown_flat_color = -1;
 	unknown_sprite_color = -1;
+
+	// the cached lookups may point to the old dummies
+	resolved.clear();
 }
 
 
@@ -1106,6 +1101,99 @@ void Palette::decodePixel(img_pixel_t p, byte &r, byte &g, byte &b) const
 	}
 }
 
+//
+// Converts a run of pixels to packed RGB bytes (3 per pixel), giving the
+// same result as decodePixel() on each of them but with a single table
+// lookup and no branches.
+//
+void Palette::decodePixels(const img_pixel_t *src, byte *dest, int count) const noexcept
+{
+	if (pixel_rgb.empty())
+	{
+		for (int i = 0 ; i < count ; i++, dest += 3)
+			decodePixel(src[i], dest[0], dest[1], dest[2]);
+		return;
+	}
+
+	const byte *table = pixel_rgb.data();
+
+	for (int i = 0 ; i < count ; i++, dest += 3)
+	{
+		const byte *rgb = table + src[i] * 4;
+
+		dest[0] = rgb[0];
+		dest[1] = rgb[1];
+		dest[2] = rgb[2];
+	}
+}
+
+//
+// Like decodePixels() but each pixel is output twice, for scaling up a
+// low detail image.  'dest' must have room for count * 6 bytes.
+//
+void Palette::decodePixelsDoubled(const img_pixel_t *src, byte *dest, int count) const noexcept
+{
+	if (pixel_rgb.empty())
+	{
+		for (int i = 0 ; i < count ; i++, dest += 6)
+		{
+			decodePixel(src[i], dest[0], dest[1], dest[2]);
+			decodePixel(src[i], dest[3], dest[4], dest[5]);
+		}
+		return;
+	}
+
+	const byte *table = pixel_rgb.data();
+
+	for (int i = 0 ; i < count ; i++, dest += 6)
+	{
+		const byte *rgb = table + src[i] * 4;
+
+		dest[0] = dest[3] = rgb[0];
+		dest[1] = dest[4] = rgb[1];
+		dest[2] = dest[5] = rgb[2];
+	}
+}
+
+//
+// Like decodePixels() but outputs blue, green, red and alpha for each
+// pixel, the layout which OpenGL textures are uploaded in.  TRANS_PIXEL
+// becomes all zeroes.
+//
+void Palette::decodePixelsBGRA(const img_pixel_t *src, byte *dest, int count) const noexcept
+{
+	for (int i = 0 ; i < count ; i++, dest += 4)
+	{
+		const img_pixel_t pix = src[i];
+
+		if (pix == TRANS_PIXEL)
+		{
+			dest[0] = dest[1] = dest[2] = dest[3] = 0;
+			continue;
+		}
+
+		byte r, g, b;
+
+		if (pixel_rgb.empty())
+		{
+			decodePixel(pix, r, g, b);
+		}
+		else
+		{
+			const byte *rgb = pixel_rgb.data() + pix * 4;
+
+			r = rgb[0];
+			g = rgb[1];
+			b = rgb[2];
+		}
+
+		dest[0] = b;
+		dest[1] = g;
+		dest[2] = r;
+		dest[3] = 255;
+	}
+}
+
 // this applies a constant gamma.
 // for textures/flats/things in the browser and panels.
 void Palette::decodePixelMedium(img_pixel_t p, byte &r, byte &g, byte &b) const noexcept
@@ -60,6 +60,22 @@ class Palette;
 struct ConfigData;
 struct WadData;
 
+//
+// Totals of the images uploaded to OpenGL, for measuring the time it
+// takes.
+//
+struct GLUploadStats
+{
+	int images = 0;
+	size_t bytes = 0;
+	double millis = 0;
+};
+
+namespace global
+{
+	extern GLUploadStats gl_uploads;
+}
+
 class Img_c
 {
 private:
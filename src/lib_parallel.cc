@@ -0,0 +1,251 @@
+//------------------------------------------------------------------------
+//  PARALLEL WORK
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 Ioan Chera
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "lib_parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// don't spawn silly numbers of threads on huge machines
+#define MAX_WORKER_THREADS  31
+
+namespace
+{
+
+// set on threads currently running a job, to catch nested calls
+thread_local bool tl_inJob;
+
+//
+// Persistent worker threads, started on first use
+//
+class WorkerPool
+{
+public:
+	static WorkerPool &shared()
+	{
+		static WorkerPool pool;
+		return pool;
+	}
+
+	~WorkerPool();
+
+	int threadCount() const
+	{
+		return (int)threads.size() + 1;
+	}
+
+	void run(int count, const std::function<void(int)> &func);
+
+private:
+	struct Batch
+	{
+		const std::function<void(int)> *func;
+		int count;
+		std::atomic<int> next{ 0 };
+		std::atomic<int> completed{ 0 };
+		int active = 0;		// workers holding this batch (under mutex)
+		std::exception_ptr error;
+	};
+
+	WorkerPool();
+
+	void workerLoop();
+	void work(Batch &batch);
+
+	std::vector<std::thread> threads;
+
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable finished;
+
+	Batch *batch = nullptr;
+	unsigned generation = 0;
+	bool quit = false;
+
+	// held by the thread owning the pool during a run
+	std::mutex runMutex;
+};
+
+WorkerPool::WorkerPool()
+{
+	unsigned hardware = std::thread::hardware_concurrency();
+	int count = hardware > 1 ? (int)hardware - 1 : 0;
+
+	count = std::min(count, MAX_WORKER_THREADS);
+
+	for (int i = 0; i < count; ++i)
+		threads.emplace_back(&WorkerPool::workerLoop, this);
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		quit = true;
+	}
+	wake.notify_all();
+
+	for (std::thread &thread : threads)
+		thread.join();
+}
+
+void WorkerPool::workerLoop()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+
+	unsigned seen = generation;
+
+	for (;;)
+	{
+		wake.wait(lock, [&] { return quit || generation != seen; });
+
+		if (quit)
+			return;
+
+		seen = generation;
+
+		// may have been finished by the others already
+		Batch *current = batch;
+		if (! current)
+			continue;
+
+		current->active++;
+		lock.unlock();
+
+		work(*current);
+
+		lock.lock();
+		if (--current->active == 0)
+			finished.notify_all();
+	}
+}
+
+void WorkerPool::work(Batch &current)
+{
+	tl_inJob = true;
+
+	for (;;)
+	{
+		int index = current.next++;
+		if (index >= current.count)
+			break;
+
+		try
+		{
+			(*current.func)(index);
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (! current.error)
+				current.error = std::current_exception();
+		}
+
+		if (++current.completed == current.count)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			finished.notify_all();
+		}
+	}
+
+	tl_inJob = false;
+}
+
+void WorkerPool::run(int count, const std::function<void(int)> &func)
+{
+	std::unique_lock<std::mutex> owner(runMutex, std::try_to_lock);
+
+	if (tl_inJob || ! owner.owns_lock() || threads.empty() || count == 1)
+	{
+		// same semantics as the threaded way: finish all, then throw
+		std::exception_ptr error;
+
+		for (int i = 0; i < count; ++i)
+		{
+			try
+			{
+				func(i);
+			}
+			catch (...)
+			{
+				if (! error)
+					error = std::current_exception();
+			}
+		}
+
+		if (error)
+			std::rethrow_exception(error);
+		return;
+	}
+
+	Batch current;
+	current.func = &func;
+	current.count = count;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		batch = &current;
+		generation++;
+	}
+	wake.notify_all();
+
+	work(current);
+
+	std::unique_lock<std::mutex> lock(mutex);
+
+	finished.wait(lock, [&]
+	{
+		return current.completed == current.count && current.active == 0;
+	});
+
+	batch = nullptr;
+
+	if (current.error)
+		std::rethrow_exception(current.error);
+}
+
+}	// anonymous namespace
+
+//
+// Get the number of threads which take part in a job
+//
+int ParallelThreadCount()
+{
+	return WorkerPool::shared().threadCount();
+}
+
+//
+// Run a job on the shared pool
+//
+void ParallelFor(int count, const std::function<void(int index)> &func)
+{
+	if (count <= 0)
+		return;
+
+	WorkerPool::shared().run(count, func);
+}
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
@@ -0,0 +1,44 @@
+//------------------------------------------------------------------------
+//  PARALLEL WORK
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 Ioan Chera
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#ifndef __EUREKA_LIB_PARALLEL_H__
+#define __EUREKA_LIB_PARALLEL_H__
+
+#include <functional>
+
+//
+// Number of threads which can work on a ParallelFor, including the caller.
+//
+int ParallelThreadCount();
+
+//
+// Calls func(0) ... func(count - 1) spread over a shared pool of worker
+// threads, with the calling thread helping out. Returns when all calls are
+// done. If any call throws, the first exception is rethrown here.
+//
+// Calls made from inside a running job, or while another thread owns the
+// pool, just run serially on the caller, so this is safe to nest.
+//
+void ParallelFor(int count, const std::function<void(int index)> &func);
+
+#endif  /* __EUREKA_LIB_PARALLEL_H__ */
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
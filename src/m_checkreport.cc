@@ -0,0 +1,293 @@
+//------------------------------------------------------------------------
+//  MAP CHECK REPORTS
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 Ioan Chera
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "m_checkreport.h"
+
+#include "e_basis.h"
+#include "Errors.h"
+
+bool     global::check_maps = false;
+SString  global::check_format = "json";
+fs::path global::check_report;
+
+
+static const char *SeverityName(int severity)
+{
+	switch (severity)
+	{
+		case 0:  return "info";
+		case 1:  return "minor";
+		default: return "major";
+	}
+}
+
+
+static SString PathString(const fs::path &path)
+{
+	return SString(reinterpret_cast<const char *>(path.u8string().c_str()));
+}
+
+
+CheckReportFormat M_ParseCheckReportFormat(const SString &name) noexcept(false)
+{
+	if (name.noCaseEqual("json"))
+		return CheckReportFormat::json;
+
+	if (name.noCaseEqual("csv"))
+		return CheckReportFormat::csv;
+
+	ThrowException("Unknown check report format: %s\n", name.c_str());
+}
+
+
+//------------------------------------------------------------------------
+//  JSON
+//------------------------------------------------------------------------
+
+static void JSON_AddString(SString &out, const SString &str)
+{
+	out += '"';
+
+	for (char ch : str)
+	{
+		switch (ch)
+		{
+			case '"':  out += "\\\""; break;
+			case '\\': out += "\\\\"; break;
+			case '\n': out += "\\n";  break;
+			case '\r': out += "\\r";  break;
+			case '\t': out += "\\t";  break;
+
+			default:
+				if ((unsigned char)ch < 0x20)
+					out += SString::printf("\\u%04x", (unsigned char)ch);
+				else
+					out += ch;
+				break;
+		}
+	}
+
+	out += '"';
+}
+
+
+static void JSON_AddFinding(SString &out, const CheckReportEntry &entry)
+{
+	out += "\t\t\t\t{ \"category\": ";
+	JSON_AddString(out, entry.category);
+	out += ", \"check\": ";
+	JSON_AddString(out, entry.name);
+	out += SString::printf(", \"severity\": \"%s\", \"count\": %d",
+						   SeverityName(entry.severity), (int)entry.objects.size());
+
+	if (! entry.objects.empty())
+	{
+		out += ", \"type\": ";
+		JSON_AddString(out, NameForObjectType(entry.type, true /* plural */));
+
+		out += ", \"objects\": [";
+		for (size_t k = 0; k < entry.objects.size(); k++)
+			out += SString::printf(k ? ", %d" : "%d", entry.objects[k]);
+		out += "]";
+	}
+
+	if (! entry.details.empty())
+	{
+		out += ", \"details\": [";
+		for (size_t k = 0; k < entry.details.size(); k++)
+		{
+			if (k)
+				out += ", ";
+			JSON_AddString(out, entry.details[k]);
+		}
+		out += "]";
+	}
+
+	out += SString::printf(", \"ms\": %.3f }", entry.millis);
+}
+
+
+static SString JSON_Format(const std::vector<LevelCheckReport> &levels)
+{
+	SString out = "{\n\t\"levels\":\n\t[\n";
+
+	for (size_t n = 0; n < levels.size(); n++)
+	{
+		const LevelCheckReport &level = levels[n];
+
+		out += "\t\t{\n\t\t\t\"wad\": ";
+		JSON_AddString(out, PathString(level.wadPath));
+		out += ",\n\t\t\t\"level\": ";
+		JSON_AddString(out, level.levelName);
+		out += ",\n";
+
+		if (! level.error.empty())
+		{
+			out += "\t\t\t\"error\": ";
+			JSON_AddString(out, level.error);
+			out += ",\n";
+		}
+
+		out += SString::printf("\t\t\t\"bad_refs\": %d,\n", level.badRefs);
+		out += SString::printf("\t\t\t\"load_ms\": %.3f,\n", level.loadMillis);
+		out += SString::printf("\t\t\t\"check_ms\": %.3f,\n", level.checkMillis);
+
+		out += "\t\t\t\"findings\":\n\t\t\t[\n";
+
+		for (size_t k = 0; k < level.findings.size(); k++)
+		{
+			JSON_AddFinding(out, level.findings[k]);
+			out += (k + 1 < level.findings.size()) ? ",\n" : "\n";
+		}
+
+		out += "\t\t\t]\n";
+		out += (n + 1 < levels.size()) ? "\t\t},\n" : "\t\t}\n";
+	}
+
+	out += "\t]\n}\n";
+
+	return out;
+}
+
+
+//------------------------------------------------------------------------
+//  CSV
+//------------------------------------------------------------------------
+
+static void CSV_AddField(SString &out, const SString &field, bool last = false)
+{
+	if (field.find_first_of(",\"\r\n") == std::string::npos)
+		out += field;
+	else
+	{
+		out += '"';
+		for (char ch : field)
+		{
+			if (ch == '"')
+				out += '"';
+			out += ch;
+		}
+		out += '"';
+	}
+
+	out += last ? '\n' : ',';
+}
+
+
+//
+// One row per finding. Levels without findings still get a row (with the
+// check columns empty), so their timing isn't lost.
+//
+static SString CSV_Format(const std::vector<LevelCheckReport> &levels)
+{
+	SString out = "wad,level,error,bad_refs,load_ms,check_ms,"
+				  "category,check,severity,count,type,objects,details,ms\n";
+
+	for (const LevelCheckReport &level : levels)
+	{
+		auto addLevelFields = [&out, &level]()
+		{
+			CSV_AddField(out, PathString(level.wadPath));
+			CSV_AddField(out, level.levelName);
+			CSV_AddField(out, level.error);
+			CSV_AddField(out, SString::printf("%d", level.badRefs));
+			CSV_AddField(out, SString::printf("%.3f", level.loadMillis));
+			CSV_AddField(out, SString::printf("%.3f", level.checkMillis));
+		};
+
+		if (level.findings.empty())
+		{
+			addLevelFields();
+			out += ",,,,,,,\n";
+			continue;
+		}
+
+		for (const CheckReportEntry &entry : level.findings)
+		{
+			addLevelFields();
+
+			CSV_AddField(out, entry.category);
+			CSV_AddField(out, entry.name);
+			CSV_AddField(out, SeverityName(entry.severity));
+			CSV_AddField(out, SString::printf("%d", (int)entry.objects.size()));
+			CSV_AddField(out, entry.objects.empty() ? "" : NameForObjectType(entry.type, true /* plural */));
+
+			SString objects;
+			for (size_t k = 0; k < entry.objects.size(); k++)
+				objects += SString::printf(k ? " %d" : "%d", entry.objects[k]);
+			CSV_AddField(out, objects);
+
+			SString details;
+			for (size_t k = 0; k < entry.details.size(); k++)
+			{
+				if (k)
+					details += ' ';
+				details += entry.details[k];
+			}
+			CSV_AddField(out, details);
+
+			CSV_AddField(out, SString::printf("%.3f", entry.millis), true /* last */);
+		}
+	}
+
+	return out;
+}
+
+
+//------------------------------------------------------------------------
+
+SString M_FormatCheckReport(const std::vector<LevelCheckReport> &levels,
+							CheckReportFormat format)
+{
+	switch (format)
+	{
+		case CheckReportFormat::json:
+			return JSON_Format(levels);
+		case CheckReportFormat::csv:
+			return CSV_Format(levels);
+	}
+
+	BugError("M_FormatCheckReport: bad format %d\n", (int)format);
+}
+
+
+//
+// 0 when all levels are fine, 1 for major problems, 2 if any level couldn't
+// be checked at all
+//
+int M_CheckReportExitCode(const std::vector<LevelCheckReport> &levels)
+{
+	int code = 0;
+
+	for (const LevelCheckReport &level : levels)
+	{
+		if (! level.error.empty())
+			return 2;
+
+		for (const CheckReportEntry &entry : level.findings)
+			if (entry.severity >= 2)
+				code = 1;
+	}
+
+	return code;
+}
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
@@ -0,0 +1,72 @@
+//------------------------------------------------------------------------
+//  MAP CHECK REPORTS
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 Ioan Chera
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#ifndef __EUREKA_M_CHECKREPORT_H__
+#define __EUREKA_M_CHECKREPORT_H__
+
+#include "e_checks.h"
+#include "m_strings.h"
+
+#include <filesystem>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace global
+{
+	extern bool     check_maps;		// --check: check the given wads, then quit
+	extern SString  check_format;	// "json" or "csv"
+	extern fs::path check_report;	// output file, or empty for stdout
+}
+
+//
+// The outcome of checking one level (see the --check option)
+//
+struct LevelCheckReport
+{
+	fs::path wadPath;
+	SString levelName;
+	SString error;		// set when the level couldn't be loaded
+
+	int badRefs = 0;	// bad references replaced while loading
+
+	double loadMillis = 0;
+	double checkMillis = 0;
+
+	std::vector<CheckReportEntry> findings;
+};
+
+enum class CheckReportFormat
+{
+	json,
+	csv
+};
+
+CheckReportFormat M_ParseCheckReportFormat(const SString &name) noexcept(false);
+
+SString M_FormatCheckReport(const std::vector<LevelCheckReport> &levels,
+							CheckReportFormat format);
+
+int M_CheckReportExitCode(const std::vector<LevelCheckReport> &levels);
+
+#endif  /* __EUREKA_M_CHECKREPORT_H__ */
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
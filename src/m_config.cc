@@ -27,6 +27,7 @@
 #include "Instance.h"
 
 #include "lib_adler.h"
+#include "m_checkreport.h"
 #include "m_config.h"
 #include "m_parse.h"
 #include "m_streams.h"
@@ -155,6 +156,30 @@ const opt_desc_t options[] =
 		&config::preloading.levelName	// TODO: this will need to work only for first instance
 	},
 
+	{	"check",
+		0,
+		0,
+		"Check all maps of the given wads, then quit",
+		NULL,
+		&global::check_maps
+	},
+
+	{	"check_format",
+		0,
+		0,
+		"Format of the check report: json or csv",
+		"<fmt>",
+		&global::check_format
+	},
+
+	{	"check_report",
+		0,
+		OptFlag_helpNewline,
+		"Write the check report to a file (default: stdout)",
+		"<file>",
+		&global::check_report
+	},
+
 	{	"udmftest",
 		0,
 		OptFlag_hide,
@@ -613,6 +638,14 @@ const opt_desc_t options[] =
 		&config::render_unknown_bright
 	},
 
+	{	"render_gl_shaders",
+		0,
+		OptFlag_preference,
+		"Use shaders for DOOM lighting in the 3D view (OpenGL mode)",
+		NULL,
+		&config::render_gl_shaders
+	},
+
 	{	"same_mode_clears_selection",
 		0,
 		OptFlag_preference,
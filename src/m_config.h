@@ -140,6 +140,7 @@ extern bool render_high_detail;
 extern bool render_lock_gravity;
 extern bool render_missing_bright;
 extern bool render_unknown_bright;
+extern bool render_gl_shaders;
 
 extern rgb_color_t transparent_col;
 
@@ -38,6 +38,7 @@
 #include "m_config.h"
 #include "m_files.h"
 #include "m_loadsave.h"
+#include "m_snapshot.h"
 #include "m_testmap.h"
 #include "r_subdiv.h"
 #include "Sector.h"
@@ -51,6 +52,7 @@
 #include "ui_file.h"
 
 #include <memory>
+#include <unordered_map>
 
 static const char overwrite_message[] =
 	"The %s PWAD already contains this map.  "
@@ -412,13 +414,36 @@ void Instance::CMD_FreshMap()
 //  LOADING CODE
 //------------------------------------------------------------------------
 
-static void UpperCaseShortStr(char *buf, int max_len)
+//
+// Interns the 8-character texture names of a map lump, uppercased. Each
+// distinct name is only interned once, since the string table lookup is
+// slow and the same few names repeat all over a level.
+//
+class TexNameCache
 {
-	for (int i = 0 ; (i < max_len) && buf[i] ; i++)
+public:
+	StringID get(const char *raw_name)
 	{
-		buf[i] = static_cast<char>(toupper(buf[i]));
+		char name[8] = {};
+
+		for (int i = 0 ; i < 8 && raw_name[i] ; i++)
+			name[i] = static_cast<char>(toupper(raw_name[i]));
+
+		uint64_t key;
+		memcpy(&key, name, sizeof(key));
+
+		auto it = ids.find(key);
+		if (it != ids.end())
+			return it->second;
+
+		StringID id = BA_InternaliseString(SString(name, 8));
+		ids.emplace(key, id);
+		return id;
 	}
-}
+
+private:
+	std::unordered_map<uint64_t, StringID> ids;
+};
 
 
 const Lump_c *Load_LookupAndSeek(int loading_level, const Wad_file *load_wad, const char *name)
@@ -446,17 +471,15 @@ void Document::LoadVertices(int loading_level, const Wad_file *load_wad)
 	PrintDebug("GetVertices: num = %d\n", count);
 # endif
 
-	vertices.reserve(count);
-	LumpInputStream stream(*lump);
+	vertices.reserve(vertices.size() + count);
+	const byte *data = lump->getData().data();
 
-	for (int i = 0 ; i < count ; i++)
+	for (int i = 0 ; i < count ; i++, data += sizeof(raw_vertex_t))
 	{
 		raw_vertex_t raw;
+		memcpy(&raw, data, sizeof(raw));
 
-		if (! stream.read(&raw, sizeof(raw)))
-			ThrowException("Error reading vertices.\n");
-
-		auto vert = std::make_unique<Vertex>();
+		auto vert = std::make_shared<Vertex>();
 
 		vert->xf = LE_S16(raw.x);
 		vert->yf = LE_S16(raw.y);
@@ -478,26 +501,22 @@ void Document::LoadSectors(int loading_level, const Wad_file *load_wad)
 	PrintDebug("GetSectors: num = %d\n", count);
 # endif
 
-	sectors.reserve(count);
-	LumpInputStream stream(*lump);
+	sectors.reserve(sectors.size() + count);
+	const byte *data = lump->getData().data();
+	TexNameCache tex_names;
 
-	for (int i = 0 ; i < count ; i++)
+	for (int i = 0 ; i < count ; i++, data += sizeof(raw_sector_t))
 	{
 		raw_sector_t raw;
-
-		if (! stream.read(&raw, sizeof(raw)))
-			ThrowException("Error reading sectors.\n");
+		memcpy(&raw, data, sizeof(raw));
 
 		auto sec = std::make_shared<Sector>();
 
 		sec->floorh = LE_S16(raw.floorh);
 		sec->ceilh  = LE_S16(raw.ceilh);
 
-		UpperCaseShortStr(raw.floor_tex, 8);
-		UpperCaseShortStr(raw. ceil_tex, 8);
-
-		sec->floor_tex = BA_InternaliseString(SString(raw.floor_tex, 8));
-		sec->ceil_tex  = BA_InternaliseString(SString(raw.ceil_tex,  8));
+		sec->floor_tex = tex_names.get(raw.floor_tex);
+		sec->ceil_tex  = tex_names.get(raw.ceil_tex);
 
 		sec->light = LE_U16(raw.light);
 		sec->type  = LE_U16(raw.type);
@@ -650,16 +669,15 @@ void Document::LoadThings(int loading_level, const Wad_file *load_wad)
 	PrintDebug("GetThings: num = %d\n", count);
 # endif
 
-	LumpInputStream stream(*lump);
+	things.reserve(things.size() + count);
+	const byte *data = lump->getData().data();
 
-	for (int i = 0 ; i < count ; i++)
+	for (int i = 0 ; i < count ; i++, data += sizeof(raw_thing_t))
 	{
 		raw_thing_t raw;
+		memcpy(&raw, data, sizeof(raw));
 
-		if (! stream.read(&raw, sizeof(raw)))
-			ThrowException("Error reading things.\n");
-
-		auto th = std::make_unique<Thing>();
+		auto th = std::make_shared<Thing>();
 
 		th->xf = LE_S16(raw.x);
 		th->yf = LE_S16(raw.y);
@@ -686,16 +704,15 @@ void Document::LoadThings_Hexen(int loading_level, const Wad_file *load_wad)
 	PrintDebug("GetThings: num = %d\n", count);
 # endif
 
-	LumpInputStream stream(*lump);
+	things.reserve(things.size() + count);
+	const byte *data = lump->getData().data();
 
-	for (int i = 0; i < count; ++i)
+	for (int i = 0; i < count; ++i, data += sizeof(raw_hexen_thing_t))
 	{
 		raw_hexen_thing_t raw;
+		memcpy(&raw, data, sizeof(raw));
 
-		if (! stream.read(&raw, sizeof(raw)))
-			ThrowException("Error reading things.\n");
-
-		auto th = std::make_unique<Thing>();
+		auto th = std::make_shared<Thing>();
 
 		th->tid = LE_S16(raw.tid);
 		th->xf = LE_S16(raw.x);
@@ -730,27 +747,23 @@ void Document::LoadSideDefs(int loading_level, const Wad_file *load_wad, const C
 	PrintDebug("GetSidedefs: num = %d\n", count);
 # endif
 
-	LumpInputStream stream(*lump);
+	sidedefs.reserve(sidedefs.size() + count);
+	const byte *data = lump->getData().data();
+	TexNameCache tex_names;
 
-	for (int i = 0 ; i < count ; i++)
+	for (int i = 0 ; i < count ; i++, data += sizeof(raw_sidedef_t))
 	{
 		raw_sidedef_t raw;
-
-		if (! stream.read(&raw, sizeof(raw)))
-			ThrowException("Error reading sidedefs.\n");
+		memcpy(&raw, data, sizeof(raw));
 
 		auto sd = std::make_shared<SideDef>();
 
 		sd->x_offset = LE_S16(raw.x_offset);
 		sd->y_offset = LE_S16(raw.y_offset);
 
-		UpperCaseShortStr(raw.upper_tex, 8);
-		UpperCaseShortStr(raw.lower_tex, 8);
-		UpperCaseShortStr(raw.  mid_tex, 8);
-
-		sd->upper_tex = BA_InternaliseString(SString(raw.upper_tex, 8));
-		sd->lower_tex = BA_InternaliseString(SString(raw.lower_tex, 8));
-		sd->  mid_tex = BA_InternaliseString(SString(raw.  mid_tex, 8));
+		sd->upper_tex = tex_names.get(raw.upper_tex);
+		sd->lower_tex = tex_names.get(raw.lower_tex);
+		sd->  mid_tex = tex_names.get(raw.  mid_tex);
 
 		sd->sector = LE_U16(raw.sector);
 
@@ -776,14 +789,13 @@ void Document::LoadLineDefs(int loading_level, const Wad_file *load_wad, const C
 	if (count == 0)
 		return;
 
-	LumpInputStream stream(*lump);
+	linedefs.reserve(linedefs.size() + count);
+	const byte *data = lump->getData().data();
 
-	for (int i = 0 ; i < count ; i++)
+	for (int i = 0 ; i < count ; i++, data += sizeof(raw_linedef_t))
 	{
 		raw_linedef_t raw;
-
-		if (! stream.read(&raw, sizeof(raw)))
-			ThrowException("Error reading linedefs.\n");
+		memcpy(&raw, data, sizeof(raw));
 
 		auto ld = std::make_shared<LineDef>();
 
@@ -824,14 +836,13 @@ void Document::LoadLineDefs_Hexen(int loading_level, const Wad_file *load_wad, c
 	if (count == 0)
 		return;
 
-	LumpInputStream stream(*lump);
+	linedefs.reserve(linedefs.size() + count);
+	const byte *data = lump->getData().data();
 
-	for (int i = 0 ; i < count ; i++)
+	for (int i = 0 ; i < count ; i++, data += sizeof(raw_hexen_linedef_t))
 	{
 		raw_hexen_linedef_t raw;
-
-		if (! stream.read(&raw, sizeof(raw)))
-			ThrowException("Error reading linedefs.\n");
+		memcpy(&raw, data, sizeof(raw));
 
 		auto ld = std::make_shared<LineDef>();
 
@@ -957,7 +968,7 @@ void Instance::LoadLevel(const Wad_file *wad, const SString &level) noexcept(fal
 	RedrawMap();
 }
 
-NewDocument Instance::openDocument(const LoadingData &inLoading, const Wad_file &wad, int level)
+NewDocument Instance::openDocument(const LoadingData &inLoading, const Wad_file &wad, int level, bool saveSnapshot)
 {
 	assert(level >= 0 && level < wad.LevelCount());
 
@@ -969,9 +980,34 @@ NewDocument Instance::openDocument(const LoadingData &inLoading, const Wad_file
 
 	loading.levelFormat = wad.LevelFormat(level);
 	doc.LoadHeader(level, wad);
+
+	// an unchanged level comes back from its snapshot, already checked
+	SnapshotKey snapshot_key = Snapshot_LevelKey(wad, level);
+	SString snapshot_namespace;
+
+	if(Snapshot_Load(snapshot_key, loading.levelFormat, doc, snapshot_namespace))
+	{
+		if(! snapshot_namespace.empty())
+			loading.udmfNamespace = snapshot_namespace;
+		if(loading.levelFormat == MapFormat::hexen)
+		{
+			doc.LoadBehavior(level, &wad);
+			doc.LoadScripts(level, &wad);
+		}
+		doc.CalculateLevelBounds();
+		doc.markSaved();
+
+		return newdoc;
+	}
+
 	if(loading.levelFormat == MapFormat::udmf)
 	{
+		// find out whether the TEXTMAP names its own namespace
+		loading.udmfNamespace.clear();
 		UDMF_LoadLevel(level, &wad, doc, loading, bad);
+		snapshot_namespace = loading.udmfNamespace;
+		if(loading.udmfNamespace.empty())
+			loading.udmfNamespace = inLoading.udmfNamespace;
 	}
 	else try
 	{
@@ -998,6 +1034,12 @@ NewDocument Instance::openDocument(const LoadingData &inLoading, const Wad_file
 	}
 	doc.RemoveUnusedVerticesAtEnd();
 	doc.checks.sidedefsUnpack(true);
+
+	// fallback objects depend on the game config, so such levels are
+	// parsed each time
+	if(saveSnapshot && ! bad.exists())
+		Snapshot_Save(snapshot_key, loading.levelFormat, doc, snapshot_namespace);
+
 	doc.CalculateLevelBounds();
 	doc.markSaved();
 
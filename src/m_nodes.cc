@@ -284,7 +284,9 @@ build_result_e Instance::BuildAllNodes(nodebuildinfo_t *info)
 		// load level
 		try
 		{
-			NewDocument newdoc = openDocument(loaded, *wad.master.editWad(), n);
+			// every level passes through here once, so don't fill the
+			// snapshot cache with them
+			NewDocument newdoc = openDocument(loaded, *wad.master.editWad(), n, false);
 
 			ret = AJBSP_BuildLevel(info, n, *this, newdoc.doc, newdoc.loading, *wad.master.editWad());
 		}
@@ -0,0 +1,597 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 Ioan Chera
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "m_snapshot.h"
+
+#include "Document.h"
+#include "e_basis.h"
+#include "lib_file.h"
+#include "LineDef.h"
+#include "main.h"
+#include "SafeOutFile.h"
+#include "Sector.h"
+#include "SideDef.h"
+#include "sys_debug.h"
+#include "Thing.h"
+#include "Vertex.h"
+#include "w_wad.h"
+
+#include <algorithm>
+#include <stddef.h>
+#include <string.h>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+#ifdef WIN32
+#include <process.h>
+#define getpid _getpid
+#endif
+
+// bump whenever the layout or the meaning of the stored data changes
+static const uint32_t SNAPSHOT_VERSION = 1;
+
+static const char SNAPSHOT_MAGIC[8] = { 'E', 'U', 'R', 'E', 'K', 'A', 'S', 'N' };
+
+// past this many, the least recently used snapshots get deleted
+static const size_t SNAPSHOT_LIMIT = 32;
+
+static_assert(std::is_trivially_copyable_v<Thing>);
+static_assert(std::is_trivially_copyable_v<Vertex>);
+static_assert(std::is_trivially_copyable_v<Sector>);
+static_assert(std::is_trivially_copyable_v<SideDef>);
+static_assert(std::is_trivially_copyable_v<LineDef>);
+
+//
+// The objects follow the header in their in-memory form, in the order of
+// the counts. The layout fingerprint is part of the header, so that a
+// snapshot from a different build of the editor gets ignored. Texture names
+// are replaced by positions in the name table, which comes before the
+// objects.
+//
+struct SnapshotHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t format;
+
+	uint64_t key;
+	uint64_t level_bytes;	// guards against key collisions
+	uint64_t layout;	// LayoutFingerprint() of the editor which wrote it
+
+	uint32_t sizes[5];
+	uint32_t counts[5];	// things, vertices, sectors, sidedefs, linedefs
+
+	uint32_t namespace_bytes;	// empty unless the TEXTMAP named one
+	uint32_t name_count;
+	uint32_t name_bytes;	// each name is NUL terminated
+	uint32_t reserved;
+};
+
+static uint64_t LayoutFingerprint();
+
+static SnapshotHeader MakeHeader(const SnapshotKey &key, MapFormat format)
+{
+	SnapshotHeader header = {};
+
+	memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+	header.version = SNAPSHOT_VERSION;
+	header.format = static_cast<uint32_t>(format);
+
+	header.key = key.hash;
+	header.level_bytes = key.level_bytes;
+	header.layout = LayoutFingerprint();
+
+	header.sizes[0] = sizeof(Thing);
+	header.sizes[1] = sizeof(Vertex);
+	header.sizes[2] = sizeof(Sector);
+	header.sizes[3] = sizeof(SideDef);
+	header.sizes[4] = sizeof(LineDef);
+
+	return header;
+}
+
+
+//------------------------------------------------------------------------
+//  LEVEL KEY
+//------------------------------------------------------------------------
+
+static inline uint64_t HashMix(uint64_t hash, uint64_t word)
+{
+	hash = (hash ^ word) * 0x9E3779B97F4A7C15ULL;
+	return hash ^ (hash >> 29);
+}
+
+//
+// Word at a time, with four independent lanes, so big TEXTMAP lumps hash
+// at close to memory speed
+//
+static uint64_t HashBytes(uint64_t hash, const uint8_t *data, size_t length)
+{
+	uint64_t lanes[4] = { hash, hash + 1, hash + 2, hash + 3 };
+
+	for (; length >= 32; data += 32, length -= 32)
+	{
+		uint64_t words[4];
+		memcpy(words, data, sizeof(words));
+
+		for (int k = 0; k < 4; k++)
+			lanes[k] = HashMix(lanes[k], words[k]);
+	}
+
+	for (int k = 0; k < 4; k++)
+		hash = HashMix(hash, lanes[k]);
+
+	for (; length >= 8; data += 8, length -= 8)
+	{
+		uint64_t word;
+		memcpy(&word, data, sizeof(word));
+		hash = HashMix(hash, word);
+	}
+
+	// the length goes in the top byte, which the tail never reaches
+	uint64_t tail = 0;
+	memcpy(&tail, data, length);
+
+	return HashMix(hash, tail | (static_cast<uint64_t>(length) << 56));
+}
+
+
+// where each stored field sits, and whether it holds a floating point value
+#define SNAPSHOT_FIELD(T, f)  offsetof(T, f), sizeof(T::f), (std::is_floating_point_v<decltype(T::f)> ? 1u : 0u)
+
+//
+// Changes whenever a stored field moves, resizes or changes its kind, and
+// with each release, which may change what a field means
+//
+static uint64_t LayoutFingerprint()
+{
+	static const size_t fields[] =
+	{
+		sizeof(Thing),
+		SNAPSHOT_FIELD(Thing, angle), SNAPSHOT_FIELD(Thing, type), SNAPSHOT_FIELD(Thing, options),
+		SNAPSHOT_FIELD(Thing, tid), SNAPSHOT_FIELD(Thing, special),
+		SNAPSHOT_FIELD(Thing, arg1), SNAPSHOT_FIELD(Thing, arg2), SNAPSHOT_FIELD(Thing, arg3),
+		SNAPSHOT_FIELD(Thing, arg4), SNAPSHOT_FIELD(Thing, arg5),
+		SNAPSHOT_FIELD(Thing, xf), SNAPSHOT_FIELD(Thing, yf), SNAPSHOT_FIELD(Thing, hf),
+
+		sizeof(Vertex),
+		SNAPSHOT_FIELD(Vertex, xf), SNAPSHOT_FIELD(Vertex, yf),
+
+		sizeof(Sector),
+		SNAPSHOT_FIELD(Sector, floorh), SNAPSHOT_FIELD(Sector, ceilh),
+		SNAPSHOT_FIELD(Sector, floor_tex), SNAPSHOT_FIELD(Sector, ceil_tex),
+		SNAPSHOT_FIELD(Sector, light), SNAPSHOT_FIELD(Sector, type), SNAPSHOT_FIELD(Sector, tag),
+
+		sizeof(SideDef),
+		SNAPSHOT_FIELD(SideDef, x_offset), SNAPSHOT_FIELD(SideDef, y_offset),
+		SNAPSHOT_FIELD(SideDef, upper_tex), SNAPSHOT_FIELD(SideDef, mid_tex),
+		SNAPSHOT_FIELD(SideDef, lower_tex), SNAPSHOT_FIELD(SideDef, sector),
+
+		sizeof(LineDef),
+		SNAPSHOT_FIELD(LineDef, start), SNAPSHOT_FIELD(LineDef, end),
+		SNAPSHOT_FIELD(LineDef, right), SNAPSHOT_FIELD(LineDef, left),
+		SNAPSHOT_FIELD(LineDef, flags), SNAPSHOT_FIELD(LineDef, udmfFlags),
+		SNAPSHOT_FIELD(LineDef, type),
+		SNAPSHOT_FIELD(LineDef, arg1), SNAPSHOT_FIELD(LineDef, arg2), SNAPSHOT_FIELD(LineDef, arg3),
+		SNAPSHOT_FIELD(LineDef, arg4), SNAPSHOT_FIELD(LineDef, arg5),
+		SNAPSHOT_FIELD(LineDef, lineid),
+	};
+
+	static const char build[] = EUREKA_VERSION;
+
+	uint64_t hash = HashBytes(SNAPSHOT_VERSION, reinterpret_cast<const uint8_t *>(fields), sizeof(fields));
+
+	return HashBytes(hash, reinterpret_cast<const uint8_t *>(build), sizeof(build) - 1);
+}
+
+#undef SNAPSHOT_FIELD
+
+
+//
+// Only the lumps which the loader reads. BEHAVIOR and SCRIPTS get read
+// from the wad on each load, and nodes don't get loaded at all, so
+// building them keeps the snapshot.
+//
+static const char *const SNAPSHOT_CLASSIC_LUMPS[] =
+{
+	"THINGS", "LINEDEFS", "SIDEDEFS", "VERTEXES", "SECTORS"
+};
+
+static const char *const SNAPSHOT_UDMF_LUMPS[] =
+{
+	"TEXTMAP"
+};
+
+
+SnapshotKey Snapshot_LevelKey(const Wad_file &wad, int level)
+{
+	MapFormat format = wad.LevelFormat(level);
+
+	SnapshotKey key;
+	uint64_t hash = HashMix(SNAPSHOT_VERSION, static_cast<uint64_t>(format));
+
+	auto addLump = [&](const char *name)
+	{
+		hash = HashBytes(hash, reinterpret_cast<const uint8_t *>(name), strlen(name));
+
+		int index = wad.LevelLookupLump(level, name);
+		if (index < 0)
+		{
+			hash = HashMix(hash, ~0ULL);
+			return;
+		}
+
+		const std::vector<byte> &data = wad.GetLump(index)->getData();
+		hash = HashBytes(hash, data.data(), data.size());
+		key.level_bytes += data.size();
+	};
+
+	if (format == MapFormat::udmf)
+	{
+		for (const char *name : SNAPSHOT_UDMF_LUMPS)
+			addLump(name);
+	}
+	else
+	{
+		for (const char *name : SNAPSHOT_CLASSIC_LUMPS)
+			addLump(name);
+	}
+
+	key.hash = hash;
+	return key;
+}
+
+
+fs::path Snapshot_Path(const SnapshotKey &key)
+{
+	return global::cache_dir / "snapshots" /
+			SString::printf("%016llx.snap", static_cast<unsigned long long>(key.hash)).get();
+}
+
+
+//------------------------------------------------------------------------
+//  LOADING
+//------------------------------------------------------------------------
+
+template<typename T>
+static void ReadObjects(const uint8_t *&pos, uint32_t count, std::vector<std::shared_ptr<T>> &list)
+{
+	list.reserve(count);
+
+	for (uint32_t n = 0; n < count; n++, pos += sizeof(T))
+	{
+		auto object = std::make_shared<T>();
+		memcpy(object.get(), pos, sizeof(T));
+		list.push_back(std::move(object));
+	}
+}
+
+
+static bool MapName(StringID &id, const std::vector<StringID> &names)
+{
+	int index = id.get();
+
+	if (index < 0 || index >= static_cast<int>(names.size()))
+		return false;
+
+	id = names[index];
+	return true;
+}
+
+
+static inline bool InRange(int index, size_t count)
+{
+	return index >= 0 && index < static_cast<int>(count);
+}
+
+
+bool Snapshot_Load(const SnapshotKey &key, MapFormat format, Document &doc, SString &udmf_namespace)
+{
+	// nowhere to keep them, e.g. in tests
+	if (global::cache_dir.empty())
+		return false;
+
+	fs::path path = Snapshot_Path(key);
+
+	std::vector<uint8_t> data;
+	if (! FileLoad(path, data))
+		return false;
+
+	SnapshotHeader header;
+	if (data.size() < sizeof(header))
+		return false;
+
+	memcpy(&header, data.data(), sizeof(header));
+
+	SnapshotHeader expected = MakeHeader(key, format);
+
+	if (memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0 ||
+		header.version != expected.version || header.format != expected.format ||
+		header.key != expected.key || header.level_bytes != expected.level_bytes ||
+		header.layout != expected.layout || memcmp(header.sizes, expected.sizes, sizeof(header.sizes)) != 0)
+	{
+		return false;
+	}
+
+	uint64_t total = sizeof(header) + static_cast<uint64_t>(header.namespace_bytes) + header.name_bytes;
+	for (int k = 0; k < 5; k++)
+		total += static_cast<uint64_t>(header.counts[k]) * header.sizes[k];
+
+	if (total != data.size())
+	{
+		gLog.printf("Ignoring damaged level snapshot %s\n", reinterpret_cast<const char *>(path.u8string().c_str()));
+		return false;
+	}
+
+	const uint8_t *pos = data.data() + sizeof(header);
+
+	std::string_view stored_namespace(reinterpret_cast<const char *>(pos), header.namespace_bytes);
+	pos += header.namespace_bytes;
+
+	if (header.name_count > header.name_bytes)
+		return false;
+
+	std::vector<std::string_view> name_views;
+	name_views.reserve(header.name_count);
+
+	std::string_view names_text(reinterpret_cast<const char *>(pos), header.name_bytes);
+	pos += header.name_bytes;
+
+	while (! names_text.empty())
+	{
+		size_t nul = names_text.find('\0');
+		if (nul == std::string_view::npos)
+			return false;
+
+		name_views.push_back(names_text.substr(0, nul));
+		names_text.remove_prefix(nul + 1);
+	}
+
+	if (name_views.size() != header.name_count)
+		return false;
+
+	std::vector<std::shared_ptr<Thing>> things;
+	std::vector<std::shared_ptr<Vertex>> vertices;
+	std::vector<std::shared_ptr<Sector>> sectors;
+	std::vector<std::shared_ptr<SideDef>> sidedefs;
+	std::vector<std::shared_ptr<LineDef>> linedefs;
+
+	ReadObjects(pos, header.counts[0], things);
+	ReadObjects(pos, header.counts[1], vertices);
+	ReadObjects(pos, header.counts[2], sectors);
+	ReadObjects(pos, header.counts[3], sidedefs);
+	ReadObjects(pos, header.counts[4], linedefs);
+
+	// a snapshot only gets made of a level without bad references, so
+	// finding one here means the file was tampered with
+	bool valid = true;
+
+	for (const auto &SD : sidedefs)
+		valid = valid && InRange(SD->sector, sectors.size());
+
+	for (const auto &L : linedefs)
+	{
+		valid = valid && InRange(L->start, vertices.size()) && InRange(L->end, vertices.size()) &&
+				InRange(L->right + 1, sidedefs.size() + 1) && InRange(L->left + 1, sidedefs.size() + 1);
+	}
+
+	if (! valid)
+	{
+		gLog.printf("Ignoring damaged level snapshot %s\n", reinterpret_cast<const char *>(path.u8string().c_str()));
+		return false;
+	}
+
+	std::vector<StringID> names;
+	names.reserve(name_views.size());
+
+	for (std::string_view name : name_views)
+		names.push_back(BA_InternaliseString(SString(name.data(), static_cast<int>(name.size()))));
+
+	for (const auto &S : sectors)
+		valid = valid && MapName(S->floor_tex, names) && MapName(S->ceil_tex, names);
+
+	for (const auto &SD : sidedefs)
+	{
+		valid = valid && MapName(SD->upper_tex, names) && MapName(SD->mid_tex, names) &&
+				MapName(SD->lower_tex, names);
+	}
+
+	if (! valid)
+	{
+		gLog.printf("Ignoring damaged level snapshot %s\n", reinterpret_cast<const char *>(path.u8string().c_str()));
+		return false;
+	}
+
+	doc.things = std::move(things);
+	doc.vertices = std::move(vertices);
+	doc.sectors = std::move(sectors);
+	doc.sidedefs = std::move(sidedefs);
+	doc.linedefs = std::move(linedefs);
+
+	if (! stored_namespace.empty())
+		udmf_namespace = SString(stored_namespace.data(), static_cast<int>(stored_namespace.size()));
+
+	// keeps it from being pruned as the oldest
+	std::error_code ec;
+	fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+
+	return true;
+}
+
+
+//------------------------------------------------------------------------
+//  SAVING
+//------------------------------------------------------------------------
+
+//
+// Texture names of a level, numbered in order of first use
+//
+class SnapshotNames
+{
+public:
+	void add(StringID id)
+	{
+		if (ids.try_emplace(id.get(), count).second)
+		{
+			SString name = BA_GetString(id);
+			text.append(name.c_str(), name.length() + 1);
+			count++;
+		}
+	}
+
+	StringID local(StringID id) const
+	{
+		return StringID(static_cast<int>(ids.at(id.get())));
+	}
+
+	std::unordered_map<int, uint32_t> ids;
+	std::string text;
+	uint32_t count = 0;
+};
+
+
+template<typename T>
+static void WriteObjects(BufferedOutFile &file, const std::vector<std::shared_ptr<T>> &list)
+{
+	for (const auto &object : list)
+		file.write(object.get(), sizeof(T));
+}
+
+
+//
+// Keeps the most recently used snapshots
+//
+static void PruneSnapshots(const fs::path &dir)
+{
+	std::vector<std::pair<fs::file_time_type, fs::path>> files;
+
+	try
+	{
+		for (const fs::directory_entry &entry : fs::directory_iterator(dir))
+		{
+			if (entry.path().extension() != ".snap")
+				continue;
+
+			std::error_code ec;
+			fs::file_time_type time = entry.last_write_time(ec);
+			if (! ec)
+				files.emplace_back(time, entry.path());
+		}
+	}
+	catch (const fs::filesystem_error &e)
+	{
+		gLog.printf("Failed listing level snapshots: %s\n", e.what());
+		return;
+	}
+
+	if (files.size() <= SNAPSHOT_LIMIT)
+		return;
+
+	std::sort(files.begin(), files.end());
+
+	for (size_t n = 0; n + SNAPSHOT_LIMIT < files.size(); n++)
+		FileDelete(files[n].second);
+}
+
+
+void Snapshot_Save(const SnapshotKey &key, MapFormat format, const Document &doc, const SString &udmf_namespace) noexcept
+{
+	if (global::cache_dir.empty())
+		return;
+
+	fs::path path = Snapshot_Path(key);
+
+	try
+	{
+		SnapshotNames names;
+
+		for (const auto &S : doc.sectors)
+		{
+			names.add(S->floor_tex);
+			names.add(S->ceil_tex);
+		}
+
+		for (const auto &SD : doc.sidedefs)
+		{
+			names.add(SD->upper_tex);
+			names.add(SD->mid_tex);
+			names.add(SD->lower_tex);
+		}
+
+		SnapshotHeader header = MakeHeader(key, format);
+
+		header.counts[0] = static_cast<uint32_t>(doc.things.size());
+		header.counts[1] = static_cast<uint32_t>(doc.vertices.size());
+		header.counts[2] = static_cast<uint32_t>(doc.sectors.size());
+		header.counts[3] = static_cast<uint32_t>(doc.sidedefs.size());
+		header.counts[4] = static_cast<uint32_t>(doc.linedefs.size());
+
+		header.namespace_bytes = static_cast<uint32_t>(udmf_namespace.length());
+		header.name_count = names.count;
+		header.name_bytes = static_cast<uint32_t>(names.text.length());
+
+		FileMakeDirs(path.parent_path());
+
+		// written aside first, so other instances never see half a file. The
+		// name is per process, since several may be saving the same level.
+		fs::path temp_path = path;
+		temp_path += SString::printf(".%d.tmp", static_cast<int>(getpid())).get();
+
+		BufferedOutFile file(temp_path);
+
+		file.write(&header, sizeof(header));
+		file.write(udmf_namespace.c_str(), udmf_namespace.length());
+		file.write(names.text.data(), names.text.length());
+
+		WriteObjects(file, doc.things);
+		WriteObjects(file, doc.vertices);
+
+		for (const auto &S : doc.sectors)
+		{
+			Sector copy = *S;
+			copy.floor_tex = names.local(S->floor_tex);
+			copy.ceil_tex = names.local(S->ceil_tex);
+			file.write(&copy, sizeof(copy));
+		}
+
+		for (const auto &SD : doc.sidedefs)
+		{
+			SideDef copy = *SD;
+			copy.upper_tex = names.local(SD->upper_tex);
+			copy.mid_tex = names.local(SD->mid_tex);
+			copy.lower_tex = names.local(SD->lower_tex);
+			file.write(&copy, sizeof(copy));
+		}
+
+		WriteObjects(file, doc.linedefs);
+
+		file.commit();
+		fs::rename(temp_path, path);
+	}
+	catch (const std::exception &e)
+	{
+		gLog.printf("Failed writing level snapshot %s: %s\n", reinterpret_cast<const char *>(path.u8string().c_str()), e.what());
+		return;
+	}
+
+	PruneSnapshots(path.parent_path());
+}
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
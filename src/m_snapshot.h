@@ -0,0 +1,60 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 Ioan Chera
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#ifndef m_snapshot_h
+#define m_snapshot_h
+
+#include "m_strings.h"
+
+#include <stdint.h>
+
+#include <filesystem>
+namespace fs = std::filesystem;
+
+enum class MapFormat;
+struct Document;
+class Wad_file;
+
+//
+// Binary snapshots of freshly loaded levels, kept under the cache directory
+// and keyed by a hash of the level lumps which get loaded. Reopening a level
+// whose lumps did not change reads the objects back instead of parsing them
+// again.
+//
+
+struct SnapshotKey
+{
+	uint64_t hash = 0;
+	uint64_t level_bytes = 0;	// total size of the hashed lumps
+};
+
+SnapshotKey Snapshot_LevelKey(const Wad_file &wad, int level);
+fs::path Snapshot_Path(const SnapshotKey &key);
+
+// returns false, leaving everything untouched, if there is no usable
+// snapshot. The namespace is only set if the TEXTMAP named one.
+bool Snapshot_Load(const SnapshotKey &key, MapFormat format, Document &doc, SString &udmf_namespace);
+
+// only meant for levels which loaded without problems, with udmf_namespace
+// empty unless the TEXTMAP named one. Failures are just logged.
+void Snapshot_Save(const SnapshotKey &key, MapFormat format, const Document &doc, const SString &udmf_namespace) noexcept;
+
+#endif
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
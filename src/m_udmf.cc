@@ -21,6 +21,7 @@
 #include "Instance.h"
 #include "main.h"
 
+#include "lib_parallel.h"
 #include "LineDef.h"
 #include "m_game.h"
 #include "Sector.h"
@@ -33,32 +34,206 @@
 
 #include "ui_window.h"
 
+#include <charconv>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+
+//
+// Every field, block and global name the parser knows about
+//
+enum class UdmfKey : uint8_t
+{
+	unknown,
+
+	// blocks and globals
+	thing, vertex, linedef, sidedef, sector,
+	namespace_, ee_compat,
+
+	// shared by several blocks
+	x, y, id, special,
+	arg0, arg1, arg2, arg3, arg4,
+
+	// things
+	height, type, angle,
+	skill2, skill3, skill4, ambush, friend_, single, coop, dm,
+
+	// linedefs
+	v1, v2, sidefront, sideback,
+	blocking, blockmonsters, twosided, dontpegtop, dontpegbottom,
+	secret, blocksound, dontdraw, mapped, passuse,
+	playercross, playeruse, monstercross, monsteruse, impact,
+	playerpush, monsterpush, missilecross, repeatspecial,
+
+	// sidedefs (and "sector" above)
+	texturetop, texturebottom, texturemiddle, offsetx, offsety,
+
+	// sectors
+	heightfloor, heightceiling, texturefloor, textureceiling, lightlevel,
+
+	COUNT
+};
+
+// in the same order as UdmfKey
+static constexpr const char *udmf_key_names[] =
+{
+	"",
+
+	"thing", "vertex", "linedef", "sidedef", "sector",
+	"namespace", "ee_compat",
+
+	"x", "y", "id", "special",
+	"arg0", "arg1", "arg2", "arg3", "arg4",
+
+	"height", "type", "angle",
+	"skill2", "skill3", "skill4", "ambush", "friend", "single", "coop", "dm",
+
+	"v1", "v2", "sidefront", "sideback",
+	"blocking", "blockmonsters", "twosided", "dontpegtop", "dontpegbottom",
+	"secret", "blocksound", "dontdraw", "mapped", "passuse",
+	"playercross", "playeruse", "monstercross", "monsteruse", "impact",
+	"playerpush", "monsterpush", "missilecross", "repeatspecial",
+
+	"texturetop", "texturebottom", "texturemiddle", "offsetx", "offsety",
+
+	"heightfloor", "heightceiling", "texturefloor", "textureceiling", "lightlevel",
+};
+
+static_assert(std::size(udmf_key_names) == static_cast<size_t>(UdmfKey::COUNT));
+
+static constexpr char UDMF_Lower(char ch) noexcept
+{
+	return (ch >= 'A' && ch <= 'Z') ? static_cast<char>(ch + ('a' - 'A')) : ch;
+}
+
+//
+// Case-insensitive FNV-style hash. The multiplier was picked so that all
+// the known names land in different slots of a 256-entry table.
+//
+static constexpr int UDMF_KeyHash(std::string_view name) noexcept
+{
+	uint32_t hash = 2166136261u;
+
+	for (char ch : name)
+		hash = (hash ^ static_cast<unsigned char>(UDMF_Lower(ch))) * 0x100200du;
+
+	return static_cast<int>(hash >> 24);
+}
+
+struct Udmf_KeyTable
+{
+	UdmfKey slots[256] = {};
+	bool perfect = true;
+};
+
+static constexpr Udmf_KeyTable UDMF_MakeKeyTable() noexcept
+{
+	Udmf_KeyTable table;
+
+	for (int k = 1; k < static_cast<int>(UdmfKey::COUNT); k++)
+	{
+		int slot = UDMF_KeyHash(udmf_key_names[k]);
+
+		if (table.slots[slot] != UdmfKey::unknown)
+			table.perfect = false;
+
+		table.slots[slot] = static_cast<UdmfKey>(k);
+	}
+
+	return table;
+}
+
+static constexpr Udmf_KeyTable udmf_key_table = UDMF_MakeKeyTable();
+
+static_assert(udmf_key_table.perfect, "UDMF key hash has collisions, pick another multiplier");
+
+
+//
+// Character classes for the tokenizer, one table lookup per byte
+//
+enum : uint8_t
+{
+	UDMF_CH_SPACE = 1,	// whitespace, including the odd bytes in 127..160
+	UDMF_CH_START = 2,	// can start an identifier or a number
+	UDMF_CH_WORD  = 4,	// can continue one
+	UDMF_CH_NEST  = 8,	// matters for finding the end of a block
+	UDMF_CH_STMT  = 16	// ends a statement outside of blocks
+};
+
+struct Udmf_CharTable
+{
+	uint8_t classes[256] = {};
+};
+
+static constexpr Udmf_CharTable UDMF_MakeCharTable() noexcept
+{
+	Udmf_CharTable table;
+
+	for (int ch = 0; ch < 256; ch++)
+	{
+		if (ch <= 32 || (ch >= 127 && ch <= 160))
+			table.classes[ch] = UDMF_CH_SPACE;
+
+		if ((ch >= '0' && ch <= '9') || (ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z') ||
+			ch == '_' || ch == '-' || ch == '+')
+		{
+			table.classes[ch] = UDMF_CH_START | UDMF_CH_WORD;
+		}
+	}
+
+	table.classes[static_cast<int>('.')] = UDMF_CH_WORD;
+
+	for (char ch : { '"', '/', '{', '}' })
+		table.classes[static_cast<int>(ch)] |= UDMF_CH_NEST | UDMF_CH_STMT;
+
+	table.classes[static_cast<int>(';')] |= UDMF_CH_STMT;
+
+	return table;
+}
+
+static constexpr Udmf_CharTable udmf_char_table = UDMF_MakeCharTable();
+
+static inline uint8_t UDMF_CharClass(char ch) noexcept
+{
+	return udmf_char_table.classes[static_cast<unsigned char>(ch)];
+}
+
+
+//
+// A token is a view into the TEXTMAP lump, nothing gets copied until a
+// value is decoded
+//
 class Udmf_Token
 {
 private:
 	// empty means EOF
-	SString text;
+	std::string_view text;
 
 public:
-	Udmf_Token(const char *str) : text(str)
-	{ }
+	Udmf_Token() = default;
 
-	Udmf_Token(const char *str, int len) : text(str, len)
+	explicit Udmf_Token(std::string_view text) : text(text)
 	{ }
 
-	const char *c_str() const
+	std::string_view view() const noexcept
+	{
+		return text;
+	}
+
+	// for messages
+	SString str() const
 	{
-		return text.c_str();
+		return SString(text.data(), static_cast<int>(text.size()));
 	}
 
-	bool IsEOF() const
+	bool IsEOF() const noexcept
 	{
 		return text.empty();
 	}
 
-	bool IsIdentifier() const
+	bool IsIdentifier() const noexcept
 	{
-		if (text.size() == 0)
+		if (text.empty())
 			return false;
 
 		char ch = text[0];
@@ -66,24 +241,68 @@ public:
 		return safe_isalpha(ch) || ch == '_';
 	}
 
-	bool IsString() const
+	bool IsString() const noexcept
 	{
-		return text.size() > 0 && text[0] == '"';
+		return ! text.empty() && text[0] == '"';
 	}
 
-	bool Match(const char *name) const
+	bool Match(std::string_view name) const noexcept
 	{
-		return y_stricmp(text.c_str(), name) == 0;
+		if (text.size() != name.size())
+			return false;
+
+		for (size_t i = 0; i < text.size(); i++)
+			if (UDMF_Lower(text[i]) != UDMF_Lower(name[i]))
+				return false;
+
+		return true;
 	}
 
-	int DecodeInt() const
+	UdmfKey Key() const noexcept
 	{
-		return atoi(text);
+		UdmfKey key = udmf_key_table.slots[UDMF_KeyHash(text)];
+
+		if (key != UdmfKey::unknown && Match(udmf_key_names[static_cast<int>(key)]))
+			return key;
+
+		return UdmfKey::unknown;
 	}
 
-	double DecodeFloat() const
+	// like atoi(), anything unparsable is zero
+	int DecodeInt() const noexcept
 	{
-		return atof(text);
+		const char *p   = text.data();
+		const char *end = p + text.size();
+
+		if (p < end && *p == '+')
+			p++;
+
+		int value = 0;
+		std::from_chars(p, end, value);
+		return value;
+	}
+
+	// like atof(), but not affected by the locale
+	double DecodeFloat() const noexcept
+	{
+		const char *p   = text.data();
+		const char *end = p + text.size();
+
+		if (p < end && *p == '+')
+			p++;
+
+		double value = 0;
+#ifdef __cpp_lib_to_chars
+		std::from_chars(p, end, value);
+#else
+		// no floating point from_chars in this standard library
+		char buffer[64];
+		size_t len = std::min(static_cast<size_t>(end - p), sizeof(buffer) - 1);
+		memcpy(buffer, p, len);
+		buffer[len] = 0;
+		value = strtod(buffer, nullptr);
+#endif
+		return value;
 	}
 
 	SString DecodeString() const
@@ -94,212 +313,136 @@ public:
 			return SString();
 		}
 
-		SString string = text;
-		string.erase(0, 1);
-		string.pop_back();
-		return string;
+		return SString(text.data() + 1, static_cast<int>(text.size()) - 2);
 	}
 
-	double DecodeCoordF() const
+	double DecodeCoordF() const noexcept
 	{
 		return MakeValidCoordF(MapFormat::udmf, DecodeFloat());
 	}
 
-	StringID DecodeTexture() const
+	// the raw name of a texture, without quotes and at most 8 characters
+	std::string_view TextureName() const noexcept
 	{
-		SString buffer;
-
 		if (! IsString())
 		{
 			// TODO warning
-			buffer = "-";
+			return "-";
 		}
-		else
-		{
-			int use_len = 8;
 
-			if (text.size() < 10)
-				use_len = (int)text.size() - 2;
-			buffer = text;
-			buffer.erase(0, 1);
-			buffer.erase(use_len, SString::npos);
-		}
+		size_t use_len = std::min(text.size() - 1, static_cast<size_t>(WAD_TEX_NAME));
+		if (text.size() < 10 && text.size() >= 2)
+			use_len = text.size() - 2;
 
-		return BA_InternaliseString(NormalizeTex(buffer));
+		return text.substr(1, use_len);
 	}
 };
 
 
-// since UDMF lumps can be very large, we read chunks of it
-// as-needed instead of loading the whole thing into memory.
-// the buffer size should be over 2x maximum token length.
-#define U_BUF_SIZE  16384
-
+//
+// Tokenizer working directly on the bytes of the TEXTMAP lump.
+//
 class Udmf_Parser
 {
 private:
-	LumpInputStream stream;
-
-	// reached EOF or a file read error
-	bool done = false;
-
-	// we have seen a "/*" but not the closing "*/"
-	bool in_comment = false;
-
-	// number of remaining bytes
-	int remaining;
-
-	// read buffer
-	char buffer[U_BUF_SIZE];
+	const char *pos;
+	const char *end;
 
-	// position in buffer and used size of buffer
-	int b_pos = 0;
-	int b_size = 0;
+	// textures get local numbers in order of first use, they are only
+	// interned once parsing is done (the string table isn't thread-safe)
+	std::unordered_map<std::string_view, StringID> textures;
+	std::vector<std::string_view> texture_names;
 
 public:
-	Udmf_Parser(const Lump_c &_lump) : stream(_lump)
+	Udmf_Parser(const char *start, const char *end) : pos(start), end(end)
 	{
-		remaining = _lump.Length();
+		// local number zero, like the serial loader always interned it first
+		DecodeTexture(Udmf_Token("\"-\""));
 	}
 
 	Udmf_Token Next()
 	{
 		for (;;)
 		{
-			if (done)
-				return Udmf_Token("");
+			while (pos < end && (UDMF_CharClass(*pos) & UDMF_CH_SPACE))
+				pos++;
 
-			// when position reaches half-way point, shift buffer down
-			if (b_pos >= U_BUF_SIZE/2)
-			{
-				memmove(buffer, buffer + U_BUF_SIZE/2, U_BUF_SIZE/2);
-
-				b_pos  -= U_BUF_SIZE/2;
-				b_size -= U_BUF_SIZE/2;
-			}
+			// end of file?
+			if (pos >= end)
+				return Udmf_Token();
 
-			// top up the buffer
-			if (remaining > 0 && b_size < U_BUF_SIZE)
+			if (*pos == '/' && pos + 1 < end)
 			{
-				int want = U_BUF_SIZE - b_size;
-				if (want > remaining)
-					want = remaining;
-
-				if (! stream.read(buffer + b_size, want))
+				// multi-line comment, an unclosed one runs to EOF
+				if (pos[1] == '*')
 				{
-					// TODO mark error somewhere, show dialog later
-					done = true;
+					pos += 2;
+
+					for (;;)
+					{
+						const char *star = static_cast<const char *>(memchr(pos, '*', end - pos));
+						if (! star || star + 1 >= end)
+						{
+							pos = end;
+							break;
+						}
+						pos = star + 1;
+						if (*pos == '/')
+						{
+							pos++;
+							break;
+						}
+					}
 					continue;
 				}
 
-				remaining -= want;
-				b_size    += want;
-			}
-
-			// end of file?
-			if (remaining <= 0 && b_pos >= b_size)
-			{
-				done = true;
-				continue;
-			}
-
-			if (in_comment)
-			{
-				// end of multi-line comment?
-				if (b_pos+2 <= b_size &&
-					buffer[b_pos] == '*' &&
-					buffer[b_pos+1] == '/')
+				// single-line comment
+				if (pos[1] == '/')
 				{
-					in_comment = false;
-					b_pos += 2;
+					SkipToEOLN();
 					continue;
 				}
-
-				b_pos++;
-				continue;
-			}
-
-			// check for multi-line comment
-			if (b_pos+2 <= b_size &&
-				buffer[b_pos] == '/' &&
-				buffer[b_pos+1] == '*')
-			{
-				in_comment = true;
-				b_pos += 2;
-				continue;
-			}
-
-			// check for single-line comment
-			if (b_pos+2 <= b_size &&
-				buffer[b_pos] == '/' &&
-				buffer[b_pos+1] == '/')
-			{
-				SkipToEOLN();
-				continue;
-			}
-
-			// skip whitespace (assumes ASCII)
-			int start = b_pos;
-			unsigned char ch = buffer[b_pos];
-
-			if ((ch <= 32) || (ch >= 127 && ch <= 160))
-			{
-				b_pos++;
-				continue;
 			}
 
 			// an actual token, yay!
+			const char *start = pos;
 
 			// is it a string?
-			if (ch == '"')
+			if (*pos == '"')
 			{
-				b_pos++;
+				pos++;
 
-				while (b_pos < b_size)
+				while (pos < end)
 				{
 					// skip escapes
-					if (buffer[b_pos] == '\\' && b_pos+1 < b_size)
+					if (*pos == '\\' && pos + 1 < end)
 					{
-						b_pos += 2;
+						pos += 2;
 						continue;
 					}
 
-					if (buffer[b_pos] == '"')
-					{
-						// include trailing double quote
-						b_pos++;
-						break;
-					}
-
-					b_pos++;
+					if (*pos++ == '"')
+						break;	// include trailing double quote
 				}
 
-				return Udmf_Token(buffer+start, b_pos - start);
+				return Udmf_Token(std::string_view(start, pos - start));
 			}
 
 			// is it a identifier or number?
-			if (safe_isalnum(ch) || ch == '_' || ch == '-' || ch == '+')
+			if (UDMF_CharClass(*pos) & UDMF_CH_START)
 			{
-				b_pos++;
+				pos++;
 
-				while (b_pos < b_size)
-				{
-					char ch = buffer[b_pos];
-					if (safe_isalnum(ch) || ch == '_' || ch == '-' || ch == '+' || ch == '.')
-					{
-						b_pos++;
-						continue;
-					}
-					break;
-				}
+				while (pos < end && (UDMF_CharClass(*pos) & UDMF_CH_WORD))
+					pos++;
 
-				return Udmf_Token(buffer+start, b_pos - start);
+				return Udmf_Token(std::string_view(start, pos - start));
 			}
 
 			// it must be a symbol, such as '{' or '}'
-			b_pos++;
+			pos++;
 
-			return Udmf_Token(buffer+start, 1);
+			return Udmf_Token(std::string_view(start, 1));
 		}
 	}
 
@@ -311,13 +454,81 @@ public:
 
 	void SkipToEOLN()
 	{
-		while (b_pos < b_size && buffer[b_pos] != '\n')
-			b_pos++;
+		const char *eoln = static_cast<const char *>(memchr(pos, '\n', end - pos));
+		pos = eoln ? eoln : end;
+	}
+
+	StringID DecodeTexture(const Udmf_Token &value)
+	{
+		std::string_view name = value.TextureName();
+
+		auto it = textures.find(name);
+		if (it != textures.end())
+			return it->second;
+
+		StringID id(static_cast<int>(texture_names.size()));
+		texture_names.push_back(name);
+		textures.emplace(name, id);
+		return id;
+	}
+
+	StringID NullTexture() const noexcept
+	{
+		return StringID(0);
+	}
+
+	const std::vector<std::string_view> &TextureNames() const noexcept
+	{
+		return texture_names;
+	}
+};
+
+
+// big TEXTMAP lumps are parsed in parallel, in chunks of about this size
+static constexpr size_t UDMF_CHUNK_SIZE = 256 * 1024;
+
+//
+// Something a chunk wants logged. Messages are printed after all chunks are
+// parsed, so they come out in file order with proper object numbers.
+//
+struct Udmf_Message
+{
+	// the object kind for an unknown field, otherwise 'namespace_' for an
+	// unknown global and 'unknown' for an unknown block
+	UdmfKey block;
+	int index;	// within the chunk
+	SString name;
+};
+
+//
+// The objects and globals of a run of top-level statements. Texture
+// StringIDs in the objects are the parser's local numbers until merged.
+//
+struct Udmf_Chunk
+{
+	std::vector<std::shared_ptr<Thing>>   things;
+	std::vector<std::shared_ptr<Vertex>>  vertices;
+	std::vector<std::shared_ptr<LineDef>> linedefs;
+	std::vector<std::shared_ptr<SideDef>> sidedefs;
+	std::vector<std::shared_ptr<Sector>>  sectors;
+
+	std::optional<SString> udmfNamespace;
+
+	std::vector<std::string_view> textures;
+	std::vector<Udmf_Message> messages;
+
+	// where the first statement left for the next chunk begins
+	const char *stop = nullptr;
+
+	template<typename T>
+	void UnknownField(UdmfKey block, const std::vector<T> &list, const Udmf_Token &field)
+	{
+		messages.push_back({ block, static_cast<int>(list.size()) - 1, field.str() });
 	}
 };
 
 
-static void UDMF_ParseGlobalVar(LoadingData &loading, Udmf_Parser& parser, const Udmf_Token& name)
+static void UDMF_ParseGlobalVar(Udmf_Chunk &chunk, Udmf_Parser& parser, const Udmf_Token& name)
 {
 	Udmf_Token value = parser.Next();
 	if (value.IsEOF())
@@ -332,25 +543,27 @@ static void UDMF_ParseGlobalVar(LoadingData &loading, Udmf_Parser& parser, const
 		return;
 	}
 
-	if (name.Match("namespace"))
+	switch (name.Key())
 	{
-		// TODO : check if namespace is supported by current port
-		//        [ if not, show a dialog with some options ]
+		case UdmfKey::namespace_:
+			// TODO : check if namespace is supported by current port
+			//        [ if not, show a dialog with some options ]
 
-		loading.udmfNamespace = value.DecodeString();
-	}
-	else if (name.Match("ee_compat"))
-	{
-		// odd Eternity thing, ignore it
-	}
-	else
-	{
-		gLog.printf("skipping unknown global '%s' in UDMF\n", name.c_str());
+			chunk.udmfNamespace = value.DecodeString();
+			break;
+
+		case UdmfKey::ee_compat:
+			// odd Eternity thing, ignore it
+			break;
+
+		default:
+			chunk.messages.push_back({ UdmfKey::namespace_, 0, name.str() });
+			break;
 	}
 }
 
 
-static void UDMF_ParseThingField(const Document &doc, Thing *T, const Udmf_Token& field, const Udmf_Token& value)
+static void UDMF_ParseThingField(Udmf_Chunk &chunk, Thing *T, const Udmf_Token& field, const Udmf_Token& value)
 {
 	// just ignore any setting with the "false" keyword
 	if (value.Match("false"))
@@ -360,68 +573,51 @@ static void UDMF_ParseThingField(const Document &doc, Thing *T, const Udmf_Token
 
 	// TODO strife options
 
-	if (field.Match("x"))
-		T->xf = value.DecodeCoordF();
-	else if (field.Match("y"))
-		T->yf = value.DecodeCoordF();
-	else if (field.Match("height"))
-		T->hf = value.DecodeCoordF();
-	else if (field.Match("type"))
-		T->type = value.DecodeInt();
-	else if (field.Match("angle"))
-		T->angle = value.DecodeInt();
-
-	else if (field.Match("id"))
-		T->tid = value.DecodeInt();
-	else if (field.Match("special"))
-		T->special = value.DecodeInt();
-	else if (field.Match("arg0"))
-		T->arg1 = value.DecodeInt();
-	else if (field.Match("arg1"))
-		T->arg2 = value.DecodeInt();
-	else if (field.Match("arg2"))
-		T->arg3 = value.DecodeInt();
-	else if (field.Match("arg3"))
-		T->arg4 = value.DecodeInt();
-	else if (field.Match("arg4"))
-		T->arg5 = value.DecodeInt();
-
-	else if (field.Match("skill2"))
-		T->options |= MTF_Easy;
-	else if (field.Match("skill3"))
-		T->options |= MTF_Medium;
-	else if (field.Match("skill4"))
-		T->options |= MTF_Hard;
-	else if (field.Match("ambush"))
-		T->options |= MTF_Ambush;
-	else if (field.Match("friend"))
-		T->options |= MTF_Friend;
-	else if (field.Match("single"))
-		T->options &= ~MTF_Not_SP;
-	else if (field.Match("coop"))
-		T->options &= ~MTF_Not_COOP;
-	else if (field.Match("dm"))
-		T->options &= ~MTF_Not_DM;
-
-	else
-	{
-		gLog.debugPrintf("thing #%d: unknown field '%s'\n", doc.numThings()-1, field.c_str());
+	switch (field.Key())
+	{
+		case UdmfKey::x:       T->xf = value.DecodeCoordF(); break;
+		case UdmfKey::y:       T->yf = value.DecodeCoordF(); break;
+		case UdmfKey::height:  T->hf = value.DecodeCoordF(); break;
+		case UdmfKey::type:    T->type = value.DecodeInt(); break;
+		case UdmfKey::angle:   T->angle = value.DecodeInt(); break;
+
+		case UdmfKey::id:      T->tid = value.DecodeInt(); break;
+		case UdmfKey::special: T->special = value.DecodeInt(); break;
+		case UdmfKey::arg0:    T->arg1 = value.DecodeInt(); break;
+		case UdmfKey::arg1:    T->arg2 = value.DecodeInt(); break;
+		case UdmfKey::arg2:    T->arg3 = value.DecodeInt(); break;
+		case UdmfKey::arg3:    T->arg4 = value.DecodeInt(); break;
+		case UdmfKey::arg4:    T->arg5 = value.DecodeInt(); break;
+
+		case UdmfKey::skill2:  T->options |= MTF_Easy; break;
+		case UdmfKey::skill3:  T->options |= MTF_Medium; break;
+		case UdmfKey::skill4:  T->options |= MTF_Hard; break;
+		case UdmfKey::ambush:  T->options |= MTF_Ambush; break;
+		case UdmfKey::friend_: T->options |= MTF_Friend; break;
+		case UdmfKey::single:  T->options &= ~MTF_Not_SP; break;
+		case UdmfKey::coop:    T->options &= ~MTF_Not_COOP; break;
+		case UdmfKey::dm:      T->options &= ~MTF_Not_DM; break;
+
+		default:
+			chunk.UnknownField(UdmfKey::thing, chunk.things, field);
+			break;
 	}
 }
 
-static void UDMF_ParseVertexField(const Document &doc, Vertex *V, const Udmf_Token& field, const Udmf_Token& value)
+static void UDMF_ParseVertexField(Udmf_Chunk &chunk, Vertex *V, const Udmf_Token& field, const Udmf_Token& value)
 {
-	if (field.Match("x"))
-		V->xf = value.DecodeCoordF();
-	else if (field.Match("y"))
-		V->yf = value.DecodeCoordF();
-	else
+	switch (field.Key())
 	{
-		gLog.debugPrintf("vertex #%d: unknown field '%s'\n", doc.numVertices()-1, field.c_str());
+		case UdmfKey::x: V->xf = value.DecodeCoordF(); break;
+		case UdmfKey::y: V->yf = value.DecodeCoordF(); break;
+
+		default:
+			chunk.UnknownField(UdmfKey::vertex, chunk.vertices, field);
+			break;
 	}
 }
 
-static void UDMF_ParseLinedefField(const Document &doc, LineDef *LD, const Udmf_Token& field, const Udmf_Token& value)
+static void UDMF_ParseLinedefField(Udmf_Chunk &chunk, LineDef *LD, const Udmf_Token& field, const Udmf_Token& value)
 {
 	// Note: vertex and sidedef numbers are validated later on
 
@@ -433,180 +629,144 @@ static void UDMF_ParseLinedefField(const Document &doc, LineDef *LD, const Udmf_
 
 	// TODO strife flags
 
-	if (field.Match("v1"))
-		LD->start = value.DecodeInt();
-	else if (field.Match("v2"))
-		LD->end = value.DecodeInt();
-	else if (field.Match("sidefront"))
-		LD->right = value.DecodeInt();
-	else if (field.Match("sideback"))
-		LD->left = value.DecodeInt();
-	else if (field.Match("special"))
-		LD->type = value.DecodeInt();
-
-	else if (field.Match("arg0"))
-		LD->arg1 = value.DecodeInt();
-	else if (field.Match("arg1"))
-		LD->arg2 = value.DecodeInt();
-	else if (field.Match("arg2"))
-		LD->arg3 = value.DecodeInt();
-	else if (field.Match("arg3"))
-		LD->arg4 = value.DecodeInt();
-	else if (field.Match("arg4"))
-		LD->arg5 = value.DecodeInt();
-
-	else if (field.Match("id"))
-		LD->lineid = value.DecodeInt();
-
-	else if (field.Match("blocking"))
-		LD->flags |= MLF_Blocking;
-	else if (field.Match("blockmonsters"))
-		LD->flags |= MLF_BlockMonsters;
-	else if (field.Match("twosided"))
-		LD->flags |= MLF_TwoSided;
-	else if (field.Match("dontpegtop"))
-		LD->flags |= MLF_UpperUnpegged;
-	else if (field.Match("dontpegbottom"))
-		LD->flags |= MLF_LowerUnpegged;
-	else if (field.Match("secret"))
-		LD->flags |= MLF_Secret;
-	else if (field.Match("blocksound"))
-		LD->flags |= MLF_SoundBlock;
-	else if (field.Match("dontdraw"))
-		LD->flags |= MLF_DontDraw;
-	else if (field.Match("mapped"))
-		LD->flags |= MLF_Mapped;
-
-	else if (field.Match("passuse"))
-		LD->flags |= MLF_Boom_PassThru;
-
-	else if (field.Match("playercross"))
-		LD->udmfFlags |= MLF_UDMF_playercross;
-	else if (field.Match("playeruse"))
-		LD->udmfFlags |= MLF_UDMF_playeruse;
-	else if (field.Match("monstercross"))
-		LD->udmfFlags |= MLF_UDMF_monstercross;
-	else if (field.Match("monsteruse"))
-		LD->udmfFlags |= MLF_UDMF_monsteruse;
-	else if (field.Match("impact"))
-		LD->udmfFlags |= MLF_UDMF_impact;
-	else if (field.Match("playerpush"))
-		LD->udmfFlags |= MLF_UDMF_playerpush;
-	else if (field.Match("monsterpush"))
-		LD->udmfFlags |= MLF_UDMF_monsterpush;
-	else if (field.Match("missilecross"))
-		LD->udmfFlags |= MLF_UDMF_missilecross;
-	else if (field.Match("repeatspecial"))
-		LD->udmfFlags |= MLF_UDMF_repeatspecial;
-
-	else
-	{
-		gLog.debugPrintf("linedef #%d: unknown field '%s'\n", doc.numVertices() -1, field.c_str());
+	switch (field.Key())
+	{
+		case UdmfKey::v1:        LD->start = value.DecodeInt(); break;
+		case UdmfKey::v2:        LD->end = value.DecodeInt(); break;
+		case UdmfKey::sidefront: LD->right = value.DecodeInt(); break;
+		case UdmfKey::sideback:  LD->left = value.DecodeInt(); break;
+		case UdmfKey::special:   LD->type = value.DecodeInt(); break;
+
+		case UdmfKey::arg0: LD->arg1 = value.DecodeInt(); break;
+		case UdmfKey::arg1: LD->arg2 = value.DecodeInt(); break;
+		case UdmfKey::arg2: LD->arg3 = value.DecodeInt(); break;
+		case UdmfKey::arg3: LD->arg4 = value.DecodeInt(); break;
+		case UdmfKey::arg4: LD->arg5 = value.DecodeInt(); break;
+
+		case UdmfKey::id: LD->lineid = value.DecodeInt(); break;
+
+		case UdmfKey::blocking:      LD->flags |= MLF_Blocking; break;
+		case UdmfKey::blockmonsters: LD->flags |= MLF_BlockMonsters; break;
+		case UdmfKey::twosided:      LD->flags |= MLF_TwoSided; break;
+		case UdmfKey::dontpegtop:    LD->flags |= MLF_UpperUnpegged; break;
+		case UdmfKey::dontpegbottom: LD->flags |= MLF_LowerUnpegged; break;
+		case UdmfKey::secret:        LD->flags |= MLF_Secret; break;
+		case UdmfKey::blocksound:    LD->flags |= MLF_SoundBlock; break;
+		case UdmfKey::dontdraw:      LD->flags |= MLF_DontDraw; break;
+		case UdmfKey::mapped:        LD->flags |= MLF_Mapped; break;
+
+		case UdmfKey::passuse:       LD->flags |= MLF_Boom_PassThru; break;
+
+		case UdmfKey::playercross:   LD->udmfFlags |= MLF_UDMF_playercross; break;
+		case UdmfKey::playeruse:     LD->udmfFlags |= MLF_UDMF_playeruse; break;
+		case UdmfKey::monstercross:  LD->udmfFlags |= MLF_UDMF_monstercross; break;
+		case UdmfKey::monsteruse:    LD->udmfFlags |= MLF_UDMF_monsteruse; break;
+		case UdmfKey::impact:        LD->udmfFlags |= MLF_UDMF_impact; break;
+		case UdmfKey::playerpush:    LD->udmfFlags |= MLF_UDMF_playerpush; break;
+		case UdmfKey::monsterpush:   LD->udmfFlags |= MLF_UDMF_monsterpush; break;
+		case UdmfKey::missilecross:  LD->udmfFlags |= MLF_UDMF_missilecross; break;
+		case UdmfKey::repeatspecial: LD->udmfFlags |= MLF_UDMF_repeatspecial; break;
+
+		default:
+			chunk.UnknownField(UdmfKey::linedef, chunk.linedefs, field);
+			break;
 	}
 }
 
-static void UDMF_ParseSidedefField(const Document &doc, SideDef *SD, const Udmf_Token& field, const Udmf_Token& value)
+static void UDMF_ParseSidedefField(Udmf_Chunk &chunk, Udmf_Parser &parser, SideDef *SD, const Udmf_Token& field, const Udmf_Token& value)
 {
 	// Note: sector numbers are validated later on
 
 	// TODO: consider how to handle "offsetx_top" (etc), if at all
 
-	if (field.Match("sector"))
-		SD->sector = value.DecodeInt();
-	else if (field.Match("texturetop"))
-		SD->upper_tex = value.DecodeTexture();
-	else if (field.Match("texturebottom"))
-		SD->lower_tex = value.DecodeTexture();
-	else if (field.Match("texturemiddle"))
-		SD->mid_tex = value.DecodeTexture();
-	else if (field.Match("offsetx"))
-		SD->x_offset = value.DecodeInt();
-	else if (field.Match("offsety"))
-		SD->y_offset = value.DecodeInt();
-	else
-	{
-		gLog.debugPrintf("sidedef #%d: unknown field '%s'\n", doc.numVertices() -1, field.c_str());
+	switch (field.Key())
+	{
+		case UdmfKey::sector:        SD->sector = value.DecodeInt(); break;
+		case UdmfKey::texturetop:    SD->upper_tex = parser.DecodeTexture(value); break;
+		case UdmfKey::texturebottom: SD->lower_tex = parser.DecodeTexture(value); break;
+		case UdmfKey::texturemiddle: SD->mid_tex = parser.DecodeTexture(value); break;
+		case UdmfKey::offsetx:       SD->x_offset = value.DecodeInt(); break;
+		case UdmfKey::offsety:       SD->y_offset = value.DecodeInt(); break;
+
+		default:
+			chunk.UnknownField(UdmfKey::sidedef, chunk.sidedefs, field);
+			break;
 	}
 }
 
-static void UDMF_ParseSectorField(const Document &doc, Sector *S, const Udmf_Token& field, const Udmf_Token& value)
-{
-	if (field.Match("heightfloor"))
-		S->floorh = value.DecodeInt();
-	else if (field.Match("heightceiling"))
-		S->ceilh = value.DecodeInt();
-	else if (field.Match("texturefloor"))
-		S->floor_tex = value.DecodeTexture();
-	else if (field.Match("textureceiling"))
-		S->ceil_tex = value.DecodeTexture();
-	else if (field.Match("lightlevel"))
-		S->light = value.DecodeInt();
-	else if (field.Match("special"))
-		S->type = value.DecodeInt();
-	else if (field.Match("id"))
-		S->tag = value.DecodeInt();
-	else
-	{
-		gLog.debugPrintf("sector #%d: unknown field '%s'\n", doc.numVertices() -1, field.c_str());
+static void UDMF_ParseSectorField(Udmf_Chunk &chunk, Udmf_Parser &parser, Sector *S, const Udmf_Token& field, const Udmf_Token& value)
+{
+	switch (field.Key())
+	{
+		case UdmfKey::heightfloor:    S->floorh = value.DecodeInt(); break;
+		case UdmfKey::heightceiling:  S->ceilh = value.DecodeInt(); break;
+		case UdmfKey::texturefloor:   S->floor_tex = parser.DecodeTexture(value); break;
+		case UdmfKey::textureceiling: S->ceil_tex = parser.DecodeTexture(value); break;
+		case UdmfKey::lightlevel:     S->light = value.DecodeInt(); break;
+		case UdmfKey::special:        S->type = value.DecodeInt(); break;
+		case UdmfKey::id:             S->tag = value.DecodeInt(); break;
+
+		default:
+			chunk.UnknownField(UdmfKey::sector, chunk.sectors, field);
+			break;
 	}
 }
 
-static void UDMF_ParseObject(Document &doc, Udmf_Parser& parser, const Udmf_Token& name)
+static void UDMF_ParseObject(Udmf_Chunk &chunk, Udmf_Parser& parser, const Udmf_Token& name)
 {
 	// create a new object of the specified type
-	Objid kind;
-
 	Thing   *new_T  = NULL;
 	Vertex  *new_V  = NULL;
 	LineDef *new_LD = NULL;
 	SideDef *new_SD = NULL;
 	Sector  *new_S  = NULL;
 
-	if (name.Match("thing"))
+	switch (name.Key())
 	{
-		kind = Objid(ObjType::things, 1);
-		auto addedThing = std::make_unique<Thing>();
-		addedThing->options = MTF_Not_SP | MTF_Not_COOP | MTF_Not_DM;
-		doc.things.push_back(std::move(addedThing));
-		new_T = doc.things.back().get();
-	}
-	else if (name.Match("vertex"))
-	{
-		kind = Objid(ObjType::vertices, 1);
-		auto addedVertex = std::make_unique<Vertex>();
-		doc.vertices.push_back(std::move(addedVertex));
-		new_V = doc.vertices.back().get();
-	}
-	else if (name.Match("linedef"))
-	{
-		kind = Objid(ObjType::linedefs, 1);
-		auto addedLine = std::make_shared<LineDef>();
-		doc.linedefs.push_back(std::move(addedLine));
-		new_LD = doc.linedefs.back().get();
-	}
-	else if (name.Match("sidedef"))
-	{
-		kind = Objid(ObjType::sidedefs, 1);
-		auto addedSide = std::make_shared<SideDef>();
-		addedSide->mid_tex = BA_InternaliseString("-");
-		addedSide->lower_tex = addedSide->mid_tex;
-		addedSide->upper_tex = addedSide->mid_tex;
-		doc.sidedefs.push_back(std::move(addedSide));
-		new_SD = doc.sidedefs.back().get();
-	}
-	else if (name.Match("sector"))
-	{
-		kind = Objid(ObjType::sectors, 1);
-		auto addedSector = std::make_shared<Sector>();
-		addedSector->light = 160;
-		doc.sectors.push_back(std::move(addedSector));
-		new_S = doc.sectors.back().get();
-	}
-
-	if (!kind.valid())
-	{
-		// unknown object kind
-		gLog.printf("skipping unknown block '%s' in UDMF\n", name.c_str());
+		case UdmfKey::thing:
+		{
+			auto addedThing = std::make_unique<Thing>();
+			addedThing->options = MTF_Not_SP | MTF_Not_COOP | MTF_Not_DM;
+			chunk.things.push_back(std::move(addedThing));
+			new_T = chunk.things.back().get();
+			break;
+		}
+		case UdmfKey::vertex:
+		{
+			auto addedVertex = std::make_unique<Vertex>();
+			chunk.vertices.push_back(std::move(addedVertex));
+			new_V = chunk.vertices.back().get();
+			break;
+		}
+		case UdmfKey::linedef:
+		{
+			auto addedLine = std::make_shared<LineDef>();
+			chunk.linedefs.push_back(std::move(addedLine));
+			new_LD = chunk.linedefs.back().get();
+			break;
+		}
+		case UdmfKey::sidedef:
+		{
+			auto addedSide = std::make_shared<SideDef>();
+			addedSide->mid_tex = parser.NullTexture();
+			addedSide->lower_tex = addedSide->mid_tex;
+			addedSide->upper_tex = addedSide->mid_tex;
+			chunk.sidedefs.push_back(std::move(addedSide));
+			new_SD = chunk.sidedefs.back().get();
+			break;
+		}
+		case UdmfKey::sector:
+		{
+			auto addedSector = std::make_shared<Sector>();
+			addedSector->light = 160;
+			chunk.sectors.push_back(std::move(addedSector));
+			new_S = chunk.sectors.back().get();
+			break;
+		}
+		default:
+			// unknown object kind
+			chunk.messages.push_back({ UdmfKey::unknown, 0, name.str() });
+			break;
 	}
 
 	for (;;)
@@ -637,19 +797,19 @@ static void UDMF_ParseObject(Document &doc, Udmf_Parser& parser, const Udmf_Toke
 		}
 
 		if (new_T)
-			UDMF_ParseThingField(doc, new_T, tok, value);
+			UDMF_ParseThingField(chunk, new_T, tok, value);
 
 		if (new_V)
-			UDMF_ParseVertexField(doc, new_V, tok, value);
+			UDMF_ParseVertexField(chunk, new_V, tok, value);
 
 		if (new_LD)
-			UDMF_ParseLinedefField(doc, new_LD, tok, value);
+			UDMF_ParseLinedefField(chunk, new_LD, tok, value);
 
 		if (new_SD)
-			UDMF_ParseSidedefField(doc, new_SD, tok, value);
+			UDMF_ParseSidedefField(chunk, parser, new_SD, tok, value);
 
 		if (new_S)
-			UDMF_ParseSectorField(doc, new_S, tok, value);
+			UDMF_ParseSectorField(chunk, parser, new_S, tok, value);
 	}
 }
 
@@ -671,267 +831,703 @@ void Document::ValidateLevel_UDMF(const ConfigData &config, BadCount &bad)
 }
 
 
-void Instance::UDMF_LoadLevel(int loading_level, const Wad_file *load_wad, Document& doc, LoadingData &loading, BadCount &bad) const
+//
+// Parses the statements which start before 'limit'. The text goes on up to
+// 'end' though, since the last statement may run past the limit.
+//
+static void UDMF_ParseChunk(Udmf_Chunk &chunk, const char *start, const char *limit, const char *end)
 {
-	const Lump_c *lump = Load_LookupAndSeek(loading_level, load_wad, "TEXTMAP");
-	// we assume this cannot happen
-	if (! lump)
-		return;
+	Udmf_Parser parser(start, end);
 
-	// NOTE: this must be a pointer to heap, due to stack size.
-	auto parser = std::make_unique<Udmf_Parser>(*lump);
+	chunk.stop = end;
 
 	for (;;)
 	{
-		Udmf_Token tok = parser->Next();
+		Udmf_Token tok = parser.Next();
 		if (tok.IsEOF())
 			break;
 
+		if (tok.view().data() >= limit)
+		{
+			chunk.stop = tok.view().data();
+			break;
+		}
+
 		if (! tok.IsIdentifier())
 		{
 			// something has gone wrong
 			// TODO mark the error somehow, pop-up dialog later
-			parser->SkipToEOLN();
+			parser.SkipToEOLN();
 			continue;
 		}
 
-		Udmf_Token tok2 = parser->Next();
+		Udmf_Token tok2 = parser.Next();
 		if (tok2.IsEOF())
 			break;
 
 		if (tok2.Match("="))
 		{
-			UDMF_ParseGlobalVar(loading, *parser, tok);
+			UDMF_ParseGlobalVar(chunk, parser, tok);
 			continue;
 		}
 		if (tok2.Match("{"))
 		{
-			UDMF_ParseObject(doc, *parser, tok);
+			UDMF_ParseObject(chunk, parser, tok);
 			continue;
 		}
 
 		// unexpected symbol
 		// TODO mark the error somehow, show dialog later
-		parser->SkipToEOLN();
+		parser.SkipToEOLN();
 	}
 
-	doc.ValidateLevel_UDMF(conf, bad);
+	chunk.textures = parser.TextureNames();
 }
 
 
-//----------------------------------------------------------------------
+//
+// Skips any whitespace and comments. An unclosed comment runs to EOF.
+//
+static const char *UDMF_SkipBlanks(const char *p, const char *end)
+{
+	while (p < end)
+	{
+		if (UDMF_CharClass(*p) & UDMF_CH_SPACE)
+		{
+			p++;
+		}
+		else if (*p == '/' && p + 1 < end && p[1] == '/')
+		{
+			p = static_cast<const char *>(memchr(p, '\n', end - p));
+			if (! p)
+				return end;
+		}
+		else if (*p == '/' && p + 1 < end && p[1] == '*')
+		{
+			for (p += 2; p + 1 < end && ! (p[0] == '*' && p[1] == '/'); p++)
+			{ }
+			p = std::min(p + 2, end);
+		}
+		else
+		{
+			break;
+		}
+	}
 
-template<typename T, typename U>
-static inline void WrFlag(Lump_c *lump, T flags, const char *name, U mask)
+	return p;
+}
+
+
+//
+// Quick pass finding where top-level statements begin, skipping strings
+// and comments, which gives up to 'count' - 1 places to split the text.
+// Only the few bytes which can affect nesting are looked at closely.
+//
+static std::vector<const char *> UDMF_FindSplits(const char *start, const char *end, int count)
 {
-	if ((flags & mask) != 0)
+	std::vector<const char *> splits;
+
+	size_t step = (end - start) / count;
+	const char *target = start + step;
+
+	int depth = 0;
+	const char *p = start;
+
+	while ((int)splits.size() < count - 1)
 	{
-		lump->Printf("%s = true;\n", name);
+		// the semicolons inside blocks don't matter
+		uint8_t wanted = depth > 0 ? UDMF_CH_NEST : UDMF_CH_STMT;
+
+		while (p < end && ! (UDMF_CharClass(*p) & wanted))
+			p++;
+
+		if (p >= end)
+			break;
+
+		char ch = *p;
+
+		if (ch == '"')
+		{
+			for (p++; p < end && *p != '"'; p++)
+				if (*p == '\\' && p + 1 < end)
+					p++;
+
+			p = std::min(p + 1, end);
+			continue;
+		}
+
+		if (ch == '/')
+		{
+			const char *after = UDMF_SkipBlanks(p, end);
+			p = (after == p) ? p + 1 : after;
+			continue;
+		}
+
+		p++;
+
+		if (ch == '{')
+		{
+			depth++;
+			continue;
+		}
+
+		if (ch == '}' && depth > 0)
+			depth--;
+		else if (ch != ';' || depth > 0)
+			continue;
+
+		// the end of a statement, does another one follow?
+		if (depth == 0 && p >= target)
+		{
+			p = UDMF_SkipBlanks(p, end);
+
+			if (p < end && (UDMF_CharClass(*p) & UDMF_CH_START))
+			{
+				splits.push_back(p);
+				target = p + step;
+			}
+		}
 	}
+
+	return splits;
 }
 
-static void UDMF_WriteInfo(const LoadingData &loading, Lump_c *lump)
+
+template<typename T>
+static void UDMF_Append(std::vector<std::shared_ptr<T>> &dest, std::vector<std::shared_ptr<T>> &list)
 {
-	lump->Printf("namespace = \"%s\";\n\n", loading.udmfNamespace.c_str());
+	dest.insert(dest.end(), std::make_move_iterator(list.begin()), std::make_move_iterator(list.end()));
 }
 
-static void UDMF_WriteThings(const Instance &inst, Lump_c *lump)
+
+void Instance::UDMF_LoadLevel(int loading_level, const Wad_file *load_wad, Document& doc, LoadingData &loading, BadCount &bad) const
 {
-	for (int i = 0 ; i < inst.level.numThings() ; i++)
+	const Lump_c *lump = Load_LookupAndSeek(loading_level, load_wad, "TEXTMAP");
+	// we assume this cannot happen
+	if (! lump)
+		return;
+
+	// tokens point straight into the lump data
+	const std::vector<byte> &data = lump->getData();
+	const char *start = reinterpret_cast<const char *>(data.data());
+	const char *end   = start + data.size();
+
+	// big levels get split into chunks of whole statements, parsed in
+	// parallel. Each chunk must stop exactly where the next one begins,
+	// otherwise (on malformed input) it's all parsed again in one go.
+	int threads = ParallelThreadCount();
+	int count = std::min(threads * 4, static_cast<int>(data.size() / UDMF_CHUNK_SIZE));
+
+	std::vector<const char *> splits;
+	if (threads > 1 && count > 1)
+		splits = UDMF_FindSplits(start, end, count);
+
+	std::vector<Udmf_Chunk> chunks(splits.size() + 1);
+
+	ParallelFor(static_cast<int>(chunks.size()), [&](int n)
 	{
-		lump->Printf("thing // %d\n", i);
-		lump->Printf("{\n");
+		UDMF_ParseChunk(chunks[n], n > 0 ? splits[n - 1] : start,
+						n < (int)splits.size() ? splits[n] : end, end);
+	});
 
-		const auto th = inst.level.things[i];
+	for (size_t n = 0; n < splits.size(); n++)
+	{
+		if (chunks[n].stop != splits[n])
+		{
+			gLog.debugPrintf("UDMF: chunk %d ends unexpectedly, parsing serially\n", static_cast<int>(n));
 
-		lump->Printf("x = %.16g;\n", th->x());
-		lump->Printf("y = %.16g;\n", th->y());
+			chunks.clear();
+			chunks.resize(1);
+			UDMF_ParseChunk(chunks[0], start, end, end);
+			break;
+		}
+	}
+
+	// join the chunks in file order, interning the textures in the order
+	// of their first use
+	std::unordered_map<std::string_view, StringID> interned;
+
+	for (Udmf_Chunk &chunk : chunks)
+	{
+		std::vector<StringID> tex_ids;
+		tex_ids.reserve(chunk.textures.size());
 
-		if (th->hf)
-			lump->Printf("height = %.16g;\n", th->h());
+		for (std::string_view name : chunk.textures)
+		{
+			auto it = interned.find(name);
+			if (it == interned.end())
+				it = interned.emplace(name, BA_InternaliseString(NormalizeTex(SString(name.data(), static_cast<int>(name.size()))))).first;
+
+			tex_ids.push_back(it->second);
+		}
+
+		for (const std::shared_ptr<SideDef> &SD : chunk.sidedefs)
+		{
+			SD->upper_tex = tex_ids[SD->upper_tex.get()];
+			SD->mid_tex   = tex_ids[SD->mid_tex.get()];
+			SD->lower_tex = tex_ids[SD->lower_tex.get()];
+		}
 
-		lump->Printf("angle = %d;\n", th->angle);
-		lump->Printf("type = %d;\n", th->type);
+		for (const std::shared_ptr<Sector> &S : chunk.sectors)
+		{
+			S->floor_tex = tex_ids[S->floor_tex.get()];
+			S->ceil_tex  = tex_ids[S->ceil_tex.get()];
+		}
 
-		// thing options
-		WrFlag(lump, th->options, "skill1", MTF_Easy);
-		WrFlag(lump, th->options, "skill2", MTF_Easy);
-		WrFlag(lump, th->options, "skill3", MTF_Medium);
-		WrFlag(lump, th->options, "skill4", MTF_Hard);
-		WrFlag(lump, th->options, "skill5", MTF_Hard);
+		for (const Udmf_Message &msg : chunk.messages)
+		{
+			switch (msg.block)
+			{
+				case UdmfKey::unknown:
+					gLog.printf("skipping unknown block '%s' in UDMF\n", msg.name.c_str());
+					break;
 
-		WrFlag(lump, ~ th->options, "single", MTF_Not_SP);
-		WrFlag(lump, ~ th->options, "coop",   MTF_Not_COOP);
-		WrFlag(lump, ~ th->options, "dm",     MTF_Not_DM);
+				case UdmfKey::namespace_:
+					gLog.printf("skipping unknown global '%s' in UDMF\n", msg.name.c_str());
+					break;
 
-		WrFlag(lump, th->options, "ambush", MTF_Ambush);
+				case UdmfKey::thing:
+					gLog.debugPrintf("thing #%d: unknown field '%s'\n", doc.numThings() + msg.index, msg.name.c_str());
+					break;
 
-		if (inst.conf.features.friend_flag)
-			WrFlag(lump, th->options, "friend", MTF_Friend);
+				case UdmfKey::vertex:
+					gLog.debugPrintf("vertex #%d: unknown field '%s'\n", doc.numVertices() + msg.index, msg.name.c_str());
+					break;
 
-		// TODO Hexen flags
+				case UdmfKey::linedef:
+					gLog.debugPrintf("linedef #%d: unknown field '%s'\n", doc.numLinedefs() + msg.index, msg.name.c_str());
+					break;
 
-		// TODO Strife flags
+				case UdmfKey::sidedef:
+					gLog.debugPrintf("sidedef #%d: unknown field '%s'\n", doc.numSidedefs() + msg.index, msg.name.c_str());
+					break;
 
-		// TODO Hexen special and args
+				case UdmfKey::sector:
+					gLog.debugPrintf("sector #%d: unknown field '%s'\n", doc.numSectors() + msg.index, msg.name.c_str());
+					break;
 
-		lump->Printf("}\n\n");
+				default:
+					break;
+			}
+		}
+
+		if (chunk.udmfNamespace)
+			loading.udmfNamespace = *chunk.udmfNamespace;
+
+		UDMF_Append(doc.things,   chunk.things);
+		UDMF_Append(doc.vertices, chunk.vertices);
+		UDMF_Append(doc.linedefs, chunk.linedefs);
+		UDMF_Append(doc.sidedefs, chunk.sidedefs);
+		UDMF_Append(doc.sectors,  chunk.sectors);
 	}
+
+	doc.ValidateLevel_UDMF(conf, bad);
 }
 
-static void UDMF_WriteVertices(const Document &doc, Lump_c *lump)
+
+//----------------------------------------------------------------------
+
+//
+// Text output for the TEXTMAP lump. Numbers are formatted with to_chars
+// straight into one growing buffer, instead of a printf per field.
+//
+class Udmf_Writer
 {
-	for (int i = 0 ; i < doc.numVertices(); i++)
+private:
+	std::string buffer;
+
+	void Number(int value)
 	{
-		lump->Printf("vertex // %d\n", i);
-		lump->Printf("{\n");
+		char digits[16];
+		std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+		buffer.append(digits, result.ptr - digits);
+	}
 
-		const auto vert = doc.vertices[i];
+	// same output as printf's "%.*f", but not affected by the locale
+	void NumberFixed(double value, int precision)
+	{
+		char digits[400];	// enough for any double in fixed notation
+		int len;
+#ifdef __cpp_lib_to_chars
+		std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value,
+				std::chars_format::fixed, precision);
+		len = static_cast<int>(result.ptr - digits);
+#else
+		// no floating point to_chars in this standard library
+		len = snprintf(digits, sizeof(digits), "%.*f", precision, value);
+#endif
+		buffer.append(digits, len);
+	}
 
-		lump->Printf("x = %1.3f;\n", vert->x());
-		lump->Printf("y = %1.3f;\n", vert->y());
+	// the shortest text which reads back as the same value. Always in fixed
+	// notation, since UDMF has no exponents without a decimal point.
+	void NumberShortest(double value)
+	{
+		char digits[400];	// enough for any double in fixed notation
+		int len;
+#ifdef __cpp_lib_to_chars
+		std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value,
+				std::chars_format::fixed);
+		len = static_cast<int>(result.ptr - digits);
+#else
+		// the fewest decimals which read back exactly
+		for (int precision = 0; ; precision++)
+		{
+			len = snprintf(digits, sizeof(digits), "%.*f", precision, value);
+			if (precision >= 340 || strtod(digits, nullptr) == value)
+				break;
+		}
+#endif
+		buffer.append(digits, len);
+	}
 
-		lump->Printf("}\n\n");
+public:
+	void Reserve(size_t size)
+	{
+		buffer.reserve(size);
 	}
-}
 
-static void UDMF_WriteLineDefs(const Instance &inst, Lump_c *lump)
-{
-	for (int i = 0 ; i < inst.level.numLinedefs(); i++)
+	void Text(std::string_view text)
 	{
-		lump->Printf("linedef // %d\n", i);
-		lump->Printf("{\n");
+		buffer.append(text);
+	}
 
-		const auto ld = inst.level.linedefs[i];
+	void Append(const Udmf_Writer &other)
+	{
+		buffer.append(other.buffer);
+	}
 
-		lump->Printf("v1 = %d;\n", ld->start);
-		lump->Printf("v2 = %d;\n", ld->end);
+	// the start of a block, with its number as a comment
+	void Begin(std::string_view kind, int index)
+	{
+		buffer.append(kind);
+		buffer.append(" // ");
+		Number(index);
+		buffer.append("\n{\n");
+	}
 
-		if (ld->right >= 0)
-			lump->Printf("sidefront = %d;\n", ld->right);
-		if (ld->left >= 0)
-			lump->Printf("sideback = %d;\n", ld->left);
+	void End()
+	{
+		buffer.append("}\n\n");
+	}
 
-		if (ld->type != 0)
-			lump->Printf("special = %d;\n", ld->type);
+	void Field(std::string_view name, int value)
+	{
+		buffer.append(name);
+		buffer.append(" = ");
+		Number(value);
+		buffer.append(";\n");
+	}
 
-		if (ld->arg1 != 0)
-			lump->Printf("arg0 = %d;\n", ld->arg1);
-		if (ld->arg2 != 0)
-			lump->Printf("arg1 = %d;\n", ld->arg2);
-		if (ld->arg3 != 0)
-			lump->Printf("arg2 = %d;\n", ld->arg3);
-		if (ld->arg4 != 0)
-			lump->Printf("arg3 = %d;\n", ld->arg4);
-		if (ld->arg5 != 0)
-			lump->Printf("arg4 = %d;\n", ld->arg5);
+	// exactly the same value when read back
+	void FieldPrecise(std::string_view name, double value)
+	{
+		buffer.append(name);
+		buffer.append(" = ");
+		NumberShortest(value);
+		buffer.append(";\n");
+	}
 
-		if (ld->lineid != 0)
-			lump->Printf("id = %d;\n", ld->lineid);
+	// like "%1.3f"
+	void FieldFixed(std::string_view name, double value)
+	{
+		buffer.append(name);
+		buffer.append(" = ");
+		NumberFixed(value, 3);
+		buffer.append(";\n");
+	}
+
+	void FieldString(std::string_view name, const SString &value)
+	{
+		buffer.append(name);
+		buffer.append(" = \"");
+		buffer.append(value.c_str(), value.length());
+		buffer.append("\";\n");
+	}
 
-		// linedef flags
-		WrFlag(lump, ld->flags, "blocking",      MLF_Blocking);
-		WrFlag(lump, ld->flags, "blockmonsters", MLF_BlockMonsters);
-		WrFlag(lump, ld->flags, "twosided",      MLF_TwoSided);
-		WrFlag(lump, ld->flags, "dontpegtop",    MLF_UpperUnpegged);
-		WrFlag(lump, ld->flags, "dontpegbottom", MLF_LowerUnpegged);
-		WrFlag(lump, ld->flags, "secret",        MLF_Secret);
-		WrFlag(lump, ld->flags, "blocksound",    MLF_SoundBlock);
-		WrFlag(lump, ld->flags, "dontdraw",      MLF_DontDraw);
-		WrFlag(lump, ld->flags, "mapped",        MLF_Mapped);
+	void Flag(std::string_view name)
+	{
+		buffer.append(name);
+		buffer.append(" = true;\n");
+	}
 
-		WrFlag(lump, ld->udmfFlags, "playercross",   MLF_UDMF_playercross);
-		WrFlag(lump, ld->udmfFlags, "playeruse",     MLF_UDMF_playeruse);
-		WrFlag(lump, ld->udmfFlags, "monstercross",  MLF_UDMF_monstercross);
-		WrFlag(lump, ld->udmfFlags, "monsteruse",    MLF_UDMF_monsteruse);
-		WrFlag(lump, ld->udmfFlags, "impact",        MLF_UDMF_impact);
-		WrFlag(lump, ld->udmfFlags, "playerpush",    MLF_UDMF_playerpush);
-		WrFlag(lump, ld->udmfFlags, "monsterpush",   MLF_UDMF_monsterpush);
-		WrFlag(lump, ld->udmfFlags, "missilecross",  MLF_UDMF_missilecross);
-		WrFlag(lump, ld->udmfFlags, "repeatspecial", MLF_UDMF_repeatspecial);
+	size_t Size() const noexcept
+	{
+		return buffer.size();
+	}
 
-		if (inst.conf.features.pass_through)
-			WrFlag(lump, ld->flags, "passuse", MLF_Boom_PassThru);
+	void WriteTo(Lump_c &lump) const
+	{
+		lump.Write(buffer.data(), static_cast<int>(buffer.size()));
+	}
+};
 
-		if (inst.conf.features.midtex_3d)
-			WrFlag(lump, ld->flags, "midtex3d", MLF_Eternity_3DMidTex);
+// objects are formatted in parallel in batches of this many
+static constexpr int UDMF_WRITE_BATCH = 4096;
 
-		// TODO : hexen stuff (SPAC flags, etc)
 
-		// TODO : strife stuff
+//
+// Calls write(writer, i) for objects 0 to count - 1. Big lists are split in
+// batches formatted in parallel, then joined in order. 'size_guess' is the
+// usual text length of one object, for reserving the space of a batch.
+//
+template<typename F>
+static void UDMF_WriteObjects(Udmf_Writer &out, int count, size_t size_guess, F write)
+{
+	int batches = (count + UDMF_WRITE_BATCH - 1) / UDMF_WRITE_BATCH;
 
-		// TODO : zdoom stuff
+	if (batches <= 1 || ParallelThreadCount() <= 1)
+	{
+		for (int i = 0; i < count; i++)
+			write(out, i);
 
-		lump->Printf("}\n\n");
+		return;
 	}
+
+	std::vector<Udmf_Writer> parts(batches);
+
+	ParallelFor(batches, [&](int n)
+	{
+		int first = n * UDMF_WRITE_BATCH;
+		int last  = std::min(count, first + UDMF_WRITE_BATCH);
+
+		parts[n].Reserve((last - first) * size_guess);
+
+		for (int i = first; i < last; i++)
+			write(parts[n], i);
+	});
+
+	size_t total = out.Size();
+	for (const Udmf_Writer &part : parts)
+		total += part.Size();
+
+	out.Reserve(total);
+
+	for (const Udmf_Writer &part : parts)
+		out.Append(part);
 }
 
-static void UDMF_WriteSideDefs(const Document &doc, Lump_c *lump)
+
+template<typename T, typename U>
+static inline void WrFlag(Udmf_Writer &out, T flags, const char *name, U mask)
 {
-	for (int i = 0 ; i < doc.numSidedefs(); i++)
+	if ((flags & mask) != 0)
 	{
-		lump->Printf("sidedef // %d\n", i);
-		lump->Printf("{\n");
+		out.Flag(name);
+	}
+}
 
-		const auto side = doc.sidedefs[i];
+static void UDMF_WriteInfo(const LoadingData &loading, Udmf_Writer &out)
+{
+	out.FieldString("namespace", loading.udmfNamespace);
+	out.Text("\n");
+}
 
-		lump->Printf("sector = %d;\n", side->sector);
+static void UDMF_WriteThing(const Instance &inst, Udmf_Writer &out, int i)
+{
+	out.Begin("thing", i);
 
-		if (side->x_offset != 0)
-			lump->Printf("offsetx = %d;\n", side->x_offset);
-		if (side->y_offset != 0)
-			lump->Printf("offsety = %d;\n", side->y_offset);
+	const Thing *th = inst.level.things[i].get();
 
-		// use NormalizeTex to ensure no double quote
+	out.FieldPrecise("x", th->x());
+	out.FieldPrecise("y", th->y());
 
-		if (side->UpperTex() != "-")
-			lump->Printf("texturetop = \"%s\";\n", NormalizeTex(side->UpperTex()).c_str());
-		if (side->LowerTex() != "-")
-			lump->Printf("texturebottom = \"%s\";\n", NormalizeTex(side->LowerTex()).c_str());
-		if (side->MidTex() != "-")
-			lump->Printf("texturemiddle = \"%s\";\n", NormalizeTex(side->MidTex()).c_str());
+	if (th->hf)
+		out.FieldPrecise("height", th->h());
 
-		lump->Printf("}\n\n");
-	}
+	out.Field("angle", th->angle);
+	out.Field("type", th->type);
+
+	// thing options
+	WrFlag(out, th->options, "skill1", MTF_Easy);
+	WrFlag(out, th->options, "skill2", MTF_Easy);
+	WrFlag(out, th->options, "skill3", MTF_Medium);
+	WrFlag(out, th->options, "skill4", MTF_Hard);
+	WrFlag(out, th->options, "skill5", MTF_Hard);
+
+	WrFlag(out, ~ th->options, "single", MTF_Not_SP);
+	WrFlag(out, ~ th->options, "coop",   MTF_Not_COOP);
+	WrFlag(out, ~ th->options, "dm",     MTF_Not_DM);
+
+	WrFlag(out, th->options, "ambush", MTF_Ambush);
+
+	if (inst.conf.features.friend_flag)
+		WrFlag(out, th->options, "friend", MTF_Friend);
+
+	// TODO Hexen flags
+
+	// TODO Strife flags
+
+	// TODO Hexen special and args
+
+	out.End();
 }
 
-static void UDMF_WriteSectors(const Document &doc, Lump_c *lump)
+static void UDMF_WriteVertex(const Document &doc, Udmf_Writer &out, int i)
 {
-	for (int i = 0 ; i < doc.numSectors(); i++)
-	{
-		lump->Printf("sector // %d\n", i);
-		lump->Printf("{\n");
+	out.Begin("vertex", i);
 
-		const auto sec = doc.sectors[i];
+	const Vertex *vert = doc.vertices[i].get();
 
-		lump->Printf("heightfloor = %d;\n", sec->floorh);
-		lump->Printf("heightceiling = %d;\n", sec->ceilh);
+	out.FieldFixed("x", vert->x());
+	out.FieldFixed("y", vert->y());
 
-		// use NormalizeTex to ensure no double quote
+	out.End();
+}
 
-		lump->Printf("texturefloor = \"%s\";\n", NormalizeTex(sec->FloorTex()).c_str());
-		lump->Printf("textureceiling = \"%s\";\n", NormalizeTex(sec->CeilTex()).c_str());
+static void UDMF_WriteLineDef(const Instance &inst, Udmf_Writer &out, int i)
+{
+	out.Begin("linedef", i);
+
+	const LineDef *ld = inst.level.linedefs[i].get();
+
+	out.Field("v1", ld->start);
+	out.Field("v2", ld->end);
+
+	if (ld->right >= 0)
+		out.Field("sidefront", ld->right);
+	if (ld->left >= 0)
+		out.Field("sideback", ld->left);
+
+	if (ld->type != 0)
+		out.Field("special", ld->type);
+
+	if (ld->arg1 != 0)
+		out.Field("arg0", ld->arg1);
+	if (ld->arg2 != 0)
+		out.Field("arg1", ld->arg2);
+	if (ld->arg3 != 0)
+		out.Field("arg2", ld->arg3);
+	if (ld->arg4 != 0)
+		out.Field("arg3", ld->arg4);
+	if (ld->arg5 != 0)
+		out.Field("arg4", ld->arg5);
+
+	if (ld->lineid != 0)
+		out.Field("id", ld->lineid);
+
+	// linedef flags
+	WrFlag(out, ld->flags, "blocking",      MLF_Blocking);
+	WrFlag(out, ld->flags, "blockmonsters", MLF_BlockMonsters);
+	WrFlag(out, ld->flags, "twosided",      MLF_TwoSided);
+	WrFlag(out, ld->flags, "dontpegtop",    MLF_UpperUnpegged);
+	WrFlag(out, ld->flags, "dontpegbottom", MLF_LowerUnpegged);
+	WrFlag(out, ld->flags, "secret",        MLF_Secret);
+	WrFlag(out, ld->flags, "blocksound",    MLF_SoundBlock);
+	WrFlag(out, ld->flags, "dontdraw",      MLF_DontDraw);
+	WrFlag(out, ld->flags, "mapped",        MLF_Mapped);
+
+	WrFlag(out, ld->udmfFlags, "playercross",   MLF_UDMF_playercross);
+	WrFlag(out, ld->udmfFlags, "playeruse",     MLF_UDMF_playeruse);
+	WrFlag(out, ld->udmfFlags, "monstercross",  MLF_UDMF_monstercross);
+	WrFlag(out, ld->udmfFlags, "monsteruse",    MLF_UDMF_monsteruse);
+	WrFlag(out, ld->udmfFlags, "impact",        MLF_UDMF_impact);
+	WrFlag(out, ld->udmfFlags, "playerpush",    MLF_UDMF_playerpush);
+	WrFlag(out, ld->udmfFlags, "monsterpush",   MLF_UDMF_monsterpush);
+	WrFlag(out, ld->udmfFlags, "missilecross",  MLF_UDMF_missilecross);
+	WrFlag(out, ld->udmfFlags, "repeatspecial", MLF_UDMF_repeatspecial);
+
+	if (inst.conf.features.pass_through)
+		WrFlag(out, ld->flags, "passuse", MLF_Boom_PassThru);
+
+	if (inst.conf.features.midtex_3d)
+		WrFlag(out, ld->flags, "midtex3d", MLF_Eternity_3DMidTex);
+
+	// TODO : hexen stuff (SPAC flags, etc)
+
+	// TODO : strife stuff
+
+	// TODO : zdoom stuff
+
+	out.End();
+}
 
-		lump->Printf("lightlevel = %d;\n", sec->light);
-		if (sec->type != 0)
-			lump->Printf("special = %d;\n", sec->type);
-		if (sec->tag != 0)
-			lump->Printf("id = %d;\n", sec->tag);
+static void UDMF_WriteSideDef(const Document &doc, Udmf_Writer &out, int i)
+{
+	out.Begin("sidedef", i);
 
-		lump->Printf("}\n\n");
-	}
+	const SideDef *side = doc.sidedefs[i].get();
+
+	out.Field("sector", side->sector);
+
+	if (side->x_offset != 0)
+		out.Field("offsetx", side->x_offset);
+	if (side->y_offset != 0)
+		out.Field("offsety", side->y_offset);
+
+	// use NormalizeTex to ensure no double quote
+
+	SString tex = side->UpperTex();
+	if (tex != "-")
+		out.FieldString("texturetop", NormalizeTex(tex));
+
+	tex = side->LowerTex();
+	if (tex != "-")
+		out.FieldString("texturebottom", NormalizeTex(tex));
+
+	tex = side->MidTex();
+	if (tex != "-")
+		out.FieldString("texturemiddle", NormalizeTex(tex));
+
+	out.End();
+}
+
+static void UDMF_WriteSector(const Document &doc, Udmf_Writer &out, int i)
+{
+	out.Begin("sector", i);
+
+	const Sector *sec = doc.sectors[i].get();
+
+	out.Field("heightfloor", sec->floorh);
+	out.Field("heightceiling", sec->ceilh);
+
+	// use NormalizeTex to ensure no double quote
+
+	out.FieldString("texturefloor", NormalizeTex(sec->FloorTex()));
+	out.FieldString("textureceiling", NormalizeTex(sec->CeilTex()));
+
+	out.Field("lightlevel", sec->light);
+	if (sec->type != 0)
+		out.Field("special", sec->type);
+	if (sec->tag != 0)
+		out.Field("id", sec->tag);
+
+	out.End();
 }
 
 void Instance::UDMF_SaveLevel(const LoadingData& loading, Wad_file& wad) const
 {
 	Lump_c &lump = wad.AddLump("TEXTMAP");
 
-	UDMF_WriteInfo(loading, &lump);
-	UDMF_WriteThings(*this, &lump);
-	UDMF_WriteVertices(level, &lump);
-	UDMF_WriteLineDefs(*this, &lump);
-	UDMF_WriteSideDefs(level, &lump);
-	UDMF_WriteSectors(level, &lump);
+	// the whole text usually fits without growing
+	Udmf_Writer out;
+	out.Reserve(100 + level.numThings() * 110 + level.numVertices() * 40 + level.numLinedefs() * 90 +
+				level.numSidedefs() * 70 + level.numSectors() * 150);
+
+	UDMF_WriteInfo(loading, out);
+
+	UDMF_WriteObjects(out, level.numThings(), 110, [this](Udmf_Writer &part, int i)
+	{
+		UDMF_WriteThing(*this, part, i);
+	});
+	UDMF_WriteObjects(out, level.numVertices(), 40, [this](Udmf_Writer &part, int i)
+	{
+		UDMF_WriteVertex(level, part, i);
+	});
+	UDMF_WriteObjects(out, level.numLinedefs(), 90, [this](Udmf_Writer &part, int i)
+	{
+		UDMF_WriteLineDef(*this, part, i);
+	});
+	UDMF_WriteObjects(out, level.numSidedefs(), 70, [this](Udmf_Writer &part, int i)
+	{
+		UDMF_WriteSideDef(level, part, i);
+	});
+	UDMF_WriteObjects(out, level.numSectors(), 150, [this](Udmf_Writer &part, int i)
+	{
+		UDMF_WriteSector(level, part, i);
+	});
+
+	out.WriteTo(lump);
 
 	wad.AddLump("ENDMAP");
 }
@@ -29,10 +29,12 @@
 #include "main.h"
 
 #include <time.h>
+#include <chrono>
 #include <memory>
 #include <stdexcept>
 
 #include "im_color.h"
+#include "m_checkreport.h"
 #include "m_config.h"
 #include "m_game.h"
 #include "m_files.h"
@@ -44,6 +46,7 @@
 #include "m_strings.h"
 #include "r_render.h"
 #include "r_subdiv.h"
+#include "SafeOutFile.h"
 
 #include "w_dehacked.h"
 #include "w_rawdef.h"
@@ -242,7 +245,7 @@ static void CreateHomeDirs()
 	static const fs::path subdirs[] =
 	{
 		// these under $cache_dir
-		"cache", "backups",
+		"cache", "backups", "snapshots",
 
 		// these under $home_dir
 		"iwads", "games", "ports"
@@ -250,7 +253,7 @@ static void CreateHomeDirs()
 
 	for (int i = 0 ; i < (int)lengthof(subdirs) ; i++)
 	{
-		dir_name = (i < 2 ? global::cache_dir : global::home_dir) / subdirs[i];
+		dir_name = (i < 3 ? global::cache_dir : global::home_dir) / subdirs[i];
 		FileMakeDir(dir_name);
 	}
 }
@@ -444,6 +447,10 @@ static bool DetermineIWAD(Instance &inst)
 
 		if (inst.loaded.iwadName.empty())
 		{
+			// nobody to ask when only checking the maps
+			if (global::check_maps)
+				ThrowException("Cannot find an IWAD, use the -iwad option\n");
+
 			// show the "Missing IWAD!" dialog.
 			// if user cancels it, we have no choice but to quit.
 			if (! inst.MissingIWAD_Dialog())
@@ -1057,6 +1064,9 @@ void Instance::UpdateViewOnResources()
 	// reset sector info (for slopes and 3D floors)
 	Subdiv_InvalidateAll();
 
+	// unknown types and textures depend on the resources
+	level.validator.invalidate();
+
 	if (main_win)
 	{
 		// kill all loaded OpenGL images
@@ -1134,6 +1144,145 @@ static void ShowTime()
 #endif
 }
 
+//
+// Load one level of the wad and run all the checks on it
+//
+static void CheckOneLevel(Instance &inst, const Wad_file &wad, int lev_num,
+						  bool &resourcesLoaded, LevelCheckReport &report) noexcept(false)
+{
+	typedef std::chrono::steady_clock clock;
+
+	clock::time_point start = clock::now();
+
+	NewDocument newdoc = inst.openDocument(inst.loaded, wad, lev_num);
+
+	// the game config depends on the map format and UDMF namespace
+	if (! resourcesLoaded ||
+		newdoc.loading.levelFormat   != inst.loaded.levelFormat ||
+		newdoc.loading.udmfNamespace != inst.loaded.udmfNamespace)
+	{
+		inst.Main_LoadResources(newdoc.loading);
+		resourcesLoaded = true;
+
+		// the level loading uses the config too
+		newdoc = inst.openDocument(inst.loaded, wad, lev_num);
+	}
+
+	inst.loaded = newdoc.loading;
+	inst.loaded.levelName = report.levelName;
+	inst.level = std::move(newdoc.doc);
+	inst.Subdiv_InvalidateAll();
+
+	report.badRefs = newdoc.bad.linedef_count + newdoc.bad.sector_refs +
+					 newdoc.bad.sidedef_refs;
+
+	report.loadMillis = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+	report.checkMillis = inst.level.checks.runHeadless(report.findings);
+
+	gLog.printf("Checked %s in %.1f ms: %d findings\n", report.levelName.c_str(),
+				report.checkMillis, (int)report.findings.size());
+}
+
+
+//
+// The --check mode: check all levels of the given wads, write a report and
+// quit. This runs before FLTK is set up, so no window is ever opened.
+// Returns the exit code.
+//
+static int Main_CheckMaps(Instance &inst) noexcept(false)
+{
+	CheckReportFormat format = M_ParseCheckReportFormat(global::check_format);
+
+	if (global::Pwad_list.empty())
+		ThrowException("No wads given to check\n");
+
+	// this fatal errors on any missing file
+	M_ValidateGivenFiles();
+
+	// keep stdout clean for the report
+	if (global::check_report.empty())
+		global::Quiet = true;
+
+	// nobody is around to answer any dialog
+	DLG_Notify_Override = [](const char *msg, va_list ap)
+	{
+		gLog.printf("%s\n", SString::vprintf(msg, ap).c_str());
+	};
+	DLG_Confirm_Override = [](const std::vector<SString> &, const char *msg, va_list ap)
+	{
+		gLog.printf("%s\n", SString::vprintf(msg, ap).c_str());
+		return 0;	// e.g. "Ignore" for problems in the EUREKA lump
+	};
+
+	std::vector<LevelCheckReport> reports;
+
+	for (const fs::path &path : global::Pwad_list)
+	{
+		std::shared_ptr<Wad_file> editWad = Wad_file::Open(path, WadOpenMode::read);
+		if (! editWad)
+			ThrowException("Cannot load pwad: %s\n", reinterpret_cast<const char *>(path.u8string().c_str()));
+
+		// each wad starts from the command-line settings
+		inst.loaded = config::preloading;
+		inst.wad.master.ReplaceEditWad(editWad);
+
+		inst.loaded.parseEurekaLump(global::home_dir, global::old_linux_home_and_cache_dir,
+				global::install_dir, global::recent, editWad.get(), true /* keep_cmd_line_args */);
+
+		DetermineIWAD(inst);
+
+		std::shared_ptr<Wad_file> gameWad = Wad_file::Open(inst.loaded.iwadName, WadOpenMode::read);
+		if (! gameWad)
+			ThrowException("Cannot load IWAD: %s\n", reinterpret_cast<const char *>(inst.loaded.iwadName.u8string().c_str()));
+
+		DeterminePort(inst);
+
+		inst.wad.master.setGameWad(gameWad);
+		gameWad.reset();
+
+		bool resourcesLoaded = false;
+
+		for (int lev_num = 0; lev_num < editWad->LevelCount(); lev_num++)
+		{
+			LevelCheckReport report;
+
+			report.wadPath = path;
+			report.levelName = editWad->GetLump(editWad->LevelHeader(lev_num))->Name();
+
+			try
+			{
+				CheckOneLevel(inst, *editWad, lev_num, resourcesLoaded, report);
+			}
+			catch (const std::runtime_error &e)
+			{
+				report.error = e.what();
+				report.error.trimTrailingSpaces();
+
+				gLog.printf("Failed checking %s: %s\n", report.levelName.c_str(), report.error.c_str());
+			}
+
+			reports.push_back(std::move(report));
+		}
+	}
+
+	SString text = M_FormatCheckReport(reports, format);
+
+	if (global::check_report.empty())
+	{
+		fwrite(text.c_str(), 1, text.length(), stdout);
+		fflush(stdout);
+	}
+	else
+	{
+		BufferedOutFile file(global::check_report);
+		file.write(text.c_str(), text.length());
+		file.commit();
+	}
+
+	return M_CheckReportExitCode(reports);
+}
+
 //
 // Sets up the config path before using it
 //
@@ -1254,6 +1403,18 @@ int EurekaMain(int argc, char *argv[])
 		// TODO: create a new instance
 		gInstance->Editor_Init();
 
+		if (global::check_maps)
+		{
+			global::recent.load(global::home_dir, global::old_linux_home_and_cache_dir);
+			global::recent.lookForIWADs(global::install_dir, global::home_dir,
+					global::old_linux_home_and_cache_dir);
+
+			int code = Main_CheckMaps(*gInstance);
+
+			gLog.close();
+			return code;
+		}
+
 		Main_SetupFLTK();
 
 		init_progress = ProgressStatus::loaded;
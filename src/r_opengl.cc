@@ -26,9 +26,18 @@
 
 #include <map>
 #include <algorithm>
+#include <chrono>
+#include <functional>
 
 #include "FL/gl.h"
 
+#if defined(__APPLE__)
+#include <dlfcn.h>
+#elif !defined(_WIN32)
+#include <GL/glx.h>
+#endif
+
+#include "e_basis.h"
 #include "e_main.h"
 #include "e_hover.h"  // PointOnLineSide
 #include "e_linedef.h"  // LD_RailHeights
@@ -89,6 +98,341 @@ static float DoomLightToFloat(int light, float dist)
 }
 
 
+// The walls and planes of each sector are kept between frames, grouped
+// by image, and only built again when an edit touches the sector or a
+// neighbour.  Targeting OpenGL 1.1 without extensions, they live in
+// client-side vertex arrays rather than buffer objects.
+
+#define RGL_VERTEX_FLOATS  9  // x y z, s t light, r g b
+
+// light value of the vertices of fullbright surfaces
+#define RGL_FULLBRIGHT  256
+
+struct rgl_batch_t
+{
+	Img_c *img;  // NULL for a plain color
+
+	bool masked;  // needs the alpha test (railings)
+
+	// planes have a znormal of +1 (floors) or -1 (ceilings) and are
+	// skipped when the camera is behind them.  walls have a znormal of
+	// 0 and only their front faces are drawn.
+	int znormal;
+	float plane_z;
+	bool sloped;
+
+	std::vector<GLfloat> verts;
+};
+
+struct rgl_sector_mesh_t
+{
+	bool built = false;
+
+	// uses 3D floors, slopes or BOOM 242 (of itself or a neighbour),
+	// which can be defined from anywhere in the map
+	bool special = false;
+
+	// the planes of BOOM 242 sectors depend on the camera height, so
+	// they are not kept
+	bool immediate_flats = false;
+
+	std::vector<rgl_batch_t> batches;
+};
+
+//------------------------------------------------------------------------
+//  GLSL LIGHTING
+//------------------------------------------------------------------------
+
+// When OpenGL 2.0 is available, a shader applies the DOOM light
+// equation to each fragment, from the light level stored in the mesh
+// vertices and the depth from the camera.  This makes the lit view as
+// cheap as the unlit one.  Otherwise lit views are drawn by clipping
+// the geometry, as above.
+
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+
+#ifndef GL_FRAGMENT_SHADER
+#define GL_FRAGMENT_SHADER  0x8B30
+#define GL_VERTEX_SHADER    0x8B31
+#define GL_COMPILE_STATUS   0x8B81
+#define GL_LINK_STATUS      0x8B82
+#endif
+
+static struct
+{
+	bool tried;
+	bool ok;
+
+	GLuint (APIENTRY *CreateShader)(GLenum type);
+	void   (APIENTRY *ShaderSource)(GLuint shader, GLsizei count, const char *const *str, const GLint *len);
+	void   (APIENTRY *CompileShader)(GLuint shader);
+	void   (APIENTRY *GetShaderiv)(GLuint shader, GLenum pname, GLint *param);
+	void   (APIENTRY *GetShaderInfoLog)(GLuint shader, GLsizei size, GLsizei *len, char *log);
+	void   (APIENTRY *DeleteShader)(GLuint shader);
+	GLuint (APIENTRY *CreateProgram)();
+	void   (APIENTRY *AttachShader)(GLuint program, GLuint shader);
+	void   (APIENTRY *LinkProgram)(GLuint program);
+	void   (APIENTRY *GetProgramiv)(GLuint program, GLenum pname, GLint *param);
+	void   (APIENTRY *GetProgramInfoLog)(GLuint program, GLsizei size, GLsizei *len, char *log);
+	void   (APIENTRY *UseProgram)(GLuint program);
+	GLint  (APIENTRY *GetUniformLocation)(GLuint program, const char *name);
+	void   (APIENTRY *Uniform1i)(GLint location, GLint value);
+	void   (APIENTRY *Uniform1fv)(GLint location, GLsizei count, const GLfloat *value);
+} rgl_glsl;
+
+
+static void *RGL_GetProcAddress(const char *name)
+{
+#if defined(_WIN32)
+	return reinterpret_cast<void *>(wglGetProcAddress(name));
+#elif defined(__APPLE__)
+	return dlsym(RTLD_DEFAULT, name);
+#else
+	return reinterpret_cast<void *>(glXGetProcAddressARB(reinterpret_cast<const GLubyte *>(name)));
+#endif
+}
+
+
+template<typename FUNC>
+static void RGL_LoadProc(FUNC *&func, const char *name)
+{
+	func = reinterpret_cast<FUNC *>(RGL_GetProcAddress(name));
+
+	if (! func)
+		rgl_glsl.ok = false;
+}
+
+
+//
+// Looks up the OpenGL 2.0 functions, once.  Needs a current context.
+//
+static bool RGL_LoadShaderFuncs()
+{
+	if (rgl_glsl.tried)
+		return rgl_glsl.ok;
+
+	rgl_glsl.tried = true;
+
+	const char *version = reinterpret_cast<const char *>(glGetString(GL_VERSION));
+
+	if (! version || atoi(version) < 2)
+	{
+		gLog.printf("OpenGL version %s: no shaders for 3D lighting\n", version ? version : "unknown");
+		return false;
+	}
+
+	rgl_glsl.ok = true;
+
+	RGL_LoadProc(rgl_glsl.CreateShader,       "glCreateShader");
+	RGL_LoadProc(rgl_glsl.ShaderSource,       "glShaderSource");
+	RGL_LoadProc(rgl_glsl.CompileShader,      "glCompileShader");
+	RGL_LoadProc(rgl_glsl.GetShaderiv,        "glGetShaderiv");
+	RGL_LoadProc(rgl_glsl.GetShaderInfoLog,   "glGetShaderInfoLog");
+	RGL_LoadProc(rgl_glsl.DeleteShader,       "glDeleteShader");
+	RGL_LoadProc(rgl_glsl.CreateProgram,      "glCreateProgram");
+	RGL_LoadProc(rgl_glsl.AttachShader,       "glAttachShader");
+	RGL_LoadProc(rgl_glsl.LinkProgram,        "glLinkProgram");
+	RGL_LoadProc(rgl_glsl.GetProgramiv,       "glGetProgramiv");
+	RGL_LoadProc(rgl_glsl.GetProgramInfoLog,  "glGetProgramInfoLog");
+	RGL_LoadProc(rgl_glsl.UseProgram,         "glUseProgram");
+	RGL_LoadProc(rgl_glsl.GetUniformLocation, "glGetUniformLocation");
+	RGL_LoadProc(rgl_glsl.Uniform1i,          "glUniform1i");
+	RGL_LoadProc(rgl_glsl.Uniform1fv,         "glUniform1fv");
+
+	if (! rgl_glsl.ok)
+		gLog.printf("OpenGL shader functions are missing: no shaders for 3D lighting\n");
+
+	return rgl_glsl.ok;
+}
+
+
+static const char *const rgl_light_vertex_shader =
+	"varying float light;\n"
+	"varying float depth;\n"
+	"\n"
+	"void main()\n"
+	"{\n"
+	"	gl_Position = ftransform();\n"
+	"	gl_FrontColor = gl_Color;\n"
+	"	gl_TexCoord[0] = gl_MultiTexCoord0;\n"
+	"\n"
+	"	// the light level rides along as the R texture coordinate\n"
+	"	light = gl_MultiTexCoord0.p;\n"
+	"	depth = -(gl_ModelViewMatrix * gl_Vertex).z;\n"
+	"}\n";
+
+// this is R_DoomLightingEquation, and the gamma-corrected level of
+// each colormap comes from the CPU.
+static const char *const rgl_light_fragment_shader =
+	"uniform sampler2D tex;\n"
+	"uniform bool textured;\n"
+	"uniform float levels[32];\n"
+	"\n"
+	"varying float light;\n"
+	"varying float depth;\n"
+	"\n"
+	"void main()\n"
+	"{\n"
+	"	// light is a whole number, but may not interpolate exactly\n"
+	"	float L = floor((light + 0.5) / 4.0);\n"
+	"	float min_L = clamp(36.0 - L, 0.0, 31.0);\n"
+	"	float index = (59.0 - L) - floor(1280.0 / max(1.0, depth));\n"
+	"\n"
+	"	int map = int(clamp(index, min_L, 31.0));\n"
+	"\n"
+	"	vec4 color = gl_Color;\n"
+	"	if (textured)\n"
+	"		color *= texture2D(tex, gl_TexCoord[0].st);\n"
+	"\n"
+	"	gl_FragColor = vec4(color.rgb * levels[map], color.a);\n"
+	"}\n";
+
+
+static GLuint RGL_CompileShader(GLenum type, const char *source)
+{
+	GLuint shader = rgl_glsl.CreateShader(type);
+
+	rgl_glsl.ShaderSource(shader, 1, &source, NULL);
+	rgl_glsl.CompileShader(shader);
+
+	GLint status = 0;
+	rgl_glsl.GetShaderiv(shader, GL_COMPILE_STATUS, &status);
+
+	if (! status)
+	{
+		char log[1024] = {};
+		rgl_glsl.GetShaderInfoLog(shader, sizeof(log), NULL, log);
+
+		gLog.printf("Failed to compile 3D lighting shader:\n%s\n", log);
+
+		rgl_glsl.DeleteShader(shader);
+		return 0;
+	}
+
+	return shader;
+}
+
+
+struct rgl_light_shader_t
+{
+	bool tried = false;
+
+	GLuint program = 0;
+
+	GLint loc_tex = -1;
+	GLint loc_textured = -1;
+	GLint loc_levels = -1;
+
+	//
+	// Builds the program the first time it's needed in a context.
+	// Returns false when shaders cannot be used.
+	//
+	bool Prepare()
+	{
+		if (tried)
+			return program != 0;
+
+		tried = true;
+
+		if (! RGL_LoadShaderFuncs())
+			return false;
+
+		GLuint vert = RGL_CompileShader(GL_VERTEX_SHADER,   rgl_light_vertex_shader);
+		GLuint frag = RGL_CompileShader(GL_FRAGMENT_SHADER, rgl_light_fragment_shader);
+
+		if (vert && frag)
+		{
+			program = rgl_glsl.CreateProgram();
+
+			rgl_glsl.AttachShader(program, vert);
+			rgl_glsl.AttachShader(program, frag);
+			rgl_glsl.LinkProgram(program);
+
+			GLint status = 0;
+			rgl_glsl.GetProgramiv(program, GL_LINK_STATUS, &status);
+
+			if (! status)
+			{
+				char log[1024] = {};
+				rgl_glsl.GetProgramInfoLog(program, sizeof(log), NULL, log);
+
+				gLog.printf("Failed to link 3D lighting shader:\n%s\n", log);
+				program = 0;
+			}
+		}
+
+		// the program keeps them
+		if (vert)
+			rgl_glsl.DeleteShader(vert);
+		if (frag)
+			rgl_glsl.DeleteShader(frag);
+
+		if (program)
+		{
+			loc_tex      = rgl_glsl.GetUniformLocation(program, "tex");
+			loc_textured = rgl_glsl.GetUniformLocation(program, "textured");
+			loc_levels   = rgl_glsl.GetUniformLocation(program, "levels");
+		}
+
+		return program != 0;
+	}
+
+	void Begin()
+	{
+		rgl_glsl.UseProgram(program);
+
+		// the light level of each colormap
+		GLfloat levels[32];
+
+		for (int map = 0 ; map < 32 ; map++)
+		{
+			int level = (31 - map) * 8 + 7;
+
+			if (config::usegamma > 0)
+				level = gammatable[config::usegamma][level];
+
+			levels[map] = static_cast<GLfloat>(level) / 255.0f;
+		}
+
+		rgl_glsl.Uniform1fv(loc_levels, 32, levels);
+		rgl_glsl.Uniform1i(loc_tex, 0);
+	}
+
+	void SetTextured(bool textured)
+	{
+		rgl_glsl.Uniform1i(loc_textured, textured ? 1 : 0);
+	}
+
+	void End()
+	{
+		rgl_glsl.UseProgram(0);
+	}
+};
+
+
+struct RGL_MeshCache
+{
+	std::vector<rgl_sector_mesh_t> sectors;
+
+	// the right and left sector of each linedef, as of the last update
+	std::vector<std::pair<int, int>> line_sectors;
+
+	// the view settings which the meshes were built with
+	bool texturing = false;
+	bool lighting = false;
+	bool npot = false;
+
+	// scratch lists for each frame
+	std::vector<const rgl_batch_t *> draw_list;
+	std::vector<int> immediate_sectors;
+
+	// belongs to the current OpenGL context
+	rgl_light_shader_t light_shader;
+};
+
+
 struct RendInfo3D
 {
 public:
@@ -100,6 +444,17 @@ public:
 private:
 	Instance &inst;
 
+	// when not NULL, geometry goes into this mesh instead of OpenGL
+	rgl_sector_mesh_t *building = NULL;
+
+	// which batch of the mesh the geometry goes into
+	Img_c *cur_img = NULL;
+	bool cur_masked = false;
+	int cur_znormal = 0;
+	float cur_plane_z = 0;
+	bool cur_sloped = false;
+	int cur_light = RGL_FULLBRIGHT;
+
 public:
 	explicit RendInfo3D(Instance &inst) : seen_sectors(inst.level.numSectors() + 1), inst(inst)
 	{ }
@@ -145,14 +500,66 @@ public:
 		return x;
 	}
 
-	Img_c *FindFlat(const SString &fname, byte& r, byte& g, byte& b, bool& fullbright)
+	void UseImage(Img_c *img)
+	{
+		if (building)
+			cur_img = img;
+		else if (img)
+			img->bind_gl(inst.wad);
+		else
+			glBindTexture(GL_TEXTURE_2D, 0);
+	}
+
+	void SetMasked(bool masked)
+	{
+		if (building)
+			cur_masked = masked;
+		else if (masked)
+			glEnable(GL_ALPHA_TEST);
+		else
+			glDisable(GL_ALPHA_TEST);
+	}
+
+	std::vector<GLfloat> &BatchVerts()
+	{
+		for (rgl_batch_t &batch : building->batches)
+		{
+			if (batch.img == cur_img && batch.masked == cur_masked &&
+				batch.znormal == cur_znormal && batch.plane_z == cur_plane_z &&
+				batch.sloped == cur_sloped)
+			{
+				return batch.verts;
+			}
+		}
+
+		building->batches.push_back({ cur_img, cur_masked, cur_znormal, cur_plane_z, cur_sloped, {} });
+
+		return building->batches.back().verts;
+	}
+
+	void BatchVertex(std::vector<GLfloat> &verts, float x, float y, float z,
+					 float s, float t, float r, float g, float b)
+	{
+		GLfloat v[RGL_VERTEX_FLOATS] = { x, y, z, s, t, static_cast<GLfloat>(cur_light), r, g, b };
+
+		verts.insert(verts.end(), v, v + RGL_VERTEX_FLOATS);
+	}
+
+	bool IsSky(StringID fname)
+	{
+		return inst.wad.images.isSkyFlat(inst.conf, fname);
+	}
+
+	Img_c *FindFlat(StringID fname, byte& r, byte& g, byte& b, bool& fullbright)
 	{
 		fullbright = false;
 
-		if (inst.is_sky(fname))
+		ResolvedImage res = inst.wad.images.resolveFlat(inst.conf, fname);
+
+		if (res.how == ImageResolve::sky)
 		{
 			fullbright = true;
-			glBindTexture(GL_TEXTURE_2D, 0);
+			UseImage(NULL);
 
 			inst.wad.palette.decodePixel(static_cast<img_pixel_t>(inst.conf.miscInfo.sky_color), r, g, b);
 			return NULL;
@@ -160,7 +567,7 @@ public:
 
 		if (! inst.r_view.texturing)
 		{
-			glBindTexture(GL_TEXTURE_2D, 0);
+			UseImage(NULL);
 
 			int col;
 
@@ -168,32 +575,29 @@ public:
 			if (inst.r_view.lighting)
 				col = inst.conf.miscInfo.floor_colors[1];
 			else
-				col = HashedPalColor(fname, inst.conf.miscInfo.floor_colors);
+				col = HashedPalColor(BA_GetString(fname), inst.conf.miscInfo.floor_colors);
 
 			inst.wad.palette.decodePixel(static_cast<img_pixel_t>(col), r, g, b);
 			return NULL;
 		}
 
-		Img_c *img = inst.wad.images.getMutableFlat(inst.conf, fname);
-		if (! img)
-		{
-			img = &inst.wad.images.getMutableUnknownFlat(inst.conf);
+		Img_c *img = res.img;
+		if (res.how == ImageResolve::unknown)
 			fullbright = config::render_unknown_bright;
-		}
 
-		img->bind_gl(inst.wad);
+		UseImage(img);
 
 		r = g = b = 255;
 		return img;
 	}
 
-	Img_c *FindTexture(const SString &tname, byte& r, byte& g, byte& b, bool& fullbright)
+	Img_c *FindTexture(StringID tname, byte& r, byte& g, byte& b, bool& fullbright)
 	{
 		fullbright = false;
 
 		if (! inst.r_view.texturing)
 		{
-			glBindTexture(GL_TEXTURE_2D, 0);
+			UseImage(NULL);
 
 			int col;
 
@@ -201,35 +605,22 @@ public:
 			if (inst.r_view.lighting)
 				col = inst.conf.miscInfo.wall_colors[1];
 			else
-				col = HashedPalColor(tname, inst.conf.miscInfo.wall_colors);
+				col = HashedPalColor(BA_GetString(tname), inst.conf.miscInfo.wall_colors);
 
 			inst.wad.palette.decodePixel(static_cast<img_pixel_t>(col), r, g, b);
 			return NULL;
 		}
 
-		Img_c *img;
+		ResolvedImage res = inst.wad.images.resolveTexture(inst.conf, inst.wad.palette, tname);
 
-		if (is_null_tex(tname))
-		{
-			img = &inst.wad.images.getMutableMissingTexture(inst.conf);
-			fullbright = config::render_missing_bright;
-		}
-		else if (is_special_tex(tname))
-		{
-			img = &inst.wad.images.getMutableSpecialTexture(inst.wad.palette);
-		}
-		else
-		{
-			img = inst.wad.images.getMutableTexture(inst.conf, tname);
+		Img_c *img = res.img;
 
-			if (! img)
-			{
-				img = &inst.wad.images.getMutableUnknownTexture(inst.conf);
-				fullbright = config::render_unknown_bright;
-			}
-		}
+		if (res.how == ImageResolve::missing)
+			fullbright = config::render_missing_bright;
+		else if (res.how == ImageResolve::unknown)
+			fullbright = config::render_unknown_bright;
 
-		img->bind_gl(inst.wad);
+		UseImage(img);
 
 		r = g = b = 255;
 		return img;
@@ -482,6 +873,20 @@ public:
 				zb1 = zb2;
 		}
 
+		if (building)
+		{
+			std::vector<GLfloat> &verts = BatchVerts();
+
+			BatchVertex(verts, x1, y1, za1, tx1, (za1 - tex_top) * tex_scale, r, g, b);
+			BatchVertex(verts, x1, y1, za2, tx1, (za2 - tex_top) * tex_scale, r, g, b);
+			BatchVertex(verts, x2, y2, zb2, tx2, (zb2 - tex_top) * tex_scale, r, g, b);
+
+			BatchVertex(verts, x1, y1, za1, tx1, (za1 - tex_top) * tex_scale, r, g, b);
+			BatchVertex(verts, x2, y2, zb2, tx2, (zb2 - tex_top) * tex_scale, r, g, b);
+			BatchVertex(verts, x2, y2, zb1, tx2, (zb1 - tex_top) * tex_scale, r, g, b);
+			return;
+		}
+
 		glColor3f(level * r, level * g, level * b);
 
 		glBegin(GL_QUADS);
@@ -582,12 +987,13 @@ public:
 	}
 
 	void DrawSectorPolygons(const Sector *sec, sector_subdivision_c *subdiv,
-			const slope_plane_c *plane, int znormal, float z, const SString &fname)
+			const slope_plane_c *plane, int znormal, float z, StringID fname)
 	{
 		bool is_slope = plane && plane->sloped;
 
 		// check if camera is behind plane
-		if (! is_slope)
+		// [ meshes keep both, and check it when drawn ]
+		if (! is_slope && ! building)
 		{
 			if (znormal > 0 && inst.r_view.z < z) return;
 			if (znormal < 0 && inst.r_view.z > z) return;
@@ -612,6 +1018,34 @@ public:
 		float g = g0 / 255.0f;
 		float b = b0 / 255.0f;
 
+		if (building)
+		{
+			cur_masked = false;
+			cur_znormal = znormal;
+			cur_plane_z = is_slope ? 0 : z;
+			cur_sloped = is_slope;
+			cur_light = fullbright ? RGL_FULLBRIGHT : sec->light;
+
+			std::vector<GLfloat> &verts = BatchVerts();
+
+			for (const sector_polygon_t &poly : subdiv->polygons)
+			{
+				for (int p = 2 ; p < poly.count ; p++)
+				{
+					for (int k : { 0, p - 1, p })
+					{
+						float px = poly.mx[k];
+						float py = poly.my[k];
+						float pz = static_cast<float>(plane ? plane->SlopeZ(px, py) : z);
+
+						BatchVertex(verts, px, py, pz,
+									px / static_cast<float>(img_w), py / static_cast<float>(img_h), r, g, b);
+					}
+				}
+			}
+			return;
+		}
+
 		for (unsigned int i = 0 ; i < subdiv->polygons.size() ; i++)
 		{
 			const sector_polygon_t *poly = &subdiv->polygons[i];
@@ -690,7 +1124,7 @@ public:
 	//   - 'U' for upper
 	//   - 'E' for extrafloor side
 	void DrawSide(char where, const LineDef *ld, const SideDef *sd,
-		const SString &texname, const Sector *front, const Sector *back,
+		StringID texname, const Sector *front, const Sector *back,
 		bool sky_upper, float ld_length,
 		float x1, float y1, const slope_plane_c *p1,
 		float x2, float y2, const slope_plane_c *p2)
@@ -701,7 +1135,7 @@ public:
 
 		if (sky_upper && where == 'U')
 		{
-			glBindTexture(GL_TEXTURE_2D, 0);
+			UseImage(NULL);
 			inst.wad.palette.decodePixel(static_cast<img_pixel_t>(inst.conf.miscInfo.sky_color), r, g, b);
 		}
 		else
@@ -772,22 +1206,27 @@ public:
 			tex_scale = 1.0f / img_th;
 		}
 
-		glDisable(GL_ALPHA_TEST);
+		SetMasked(false);
 
 		double r0 = (double)r / 255.0;
 		double g0 = (double)g / 255.0;
 		double b0 = (double)b / 255.0;
 
-		if (inst.r_view.lighting && !fullbright)
-		{
-			int light = front->light;
+		int light = front->light;
+
+		// add "fake constrast" for axis-aligned walls
+		if (inst.level.isVertical(*ld))
+			light += 16;
+		else if (inst.level.isHorizontal(*ld))
+			light -= 16;
 
-			// add "fake constrast" for axis-aligned walls
-			if (inst.level.isVertical(*ld))
-				light += 16;
-			else if (inst.level.isHorizontal(*ld))
-				light -= 16;
+		cur_znormal = 0;
+		cur_plane_z = 0;
+		cur_sloped = false;
+		cur_light = fullbright ? RGL_FULLBRIGHT : light;
 
+		if (inst.r_view.lighting && !fullbright && !building)
+		{
 			LightClippedQuad(x1,y1,p1, x2,y2,p2, tx1,tx2,tex_top,tex_scale,
 							 where, static_cast<float>(r0), static_cast<float>(g0), static_cast<float>(b0), light);
 		}
@@ -807,7 +1246,7 @@ public:
 		bool fullbright;
 		Img_c *img;
 
-		img = FindTexture(sd->MidTex(), r, g, b, fullbright);
+		img = FindTexture(sd->mid_tex, r, g, b, fullbright);
 		if (img == NULL)
 			return;
 
@@ -850,7 +1289,7 @@ public:
 			z1 = z2 - img_h;
 		}
 
-		glEnable(GL_ALPHA_TEST);
+		SetMasked(true);
 
 		slope_plane_c p1; p1.Init(z1);
 		slope_plane_c p2; p2.Init(z2);
@@ -861,16 +1300,21 @@ public:
 
 		float tex_scale = 1.0f / img_th;
 
-		if (inst.r_view.lighting && !fullbright)
-		{
-			int light = inst.level.getSector(*sd).light;
+		int light = inst.level.getSector(*sd).light;
+
+		// add "fake constrast" for axis-aligned walls
+		if (inst.level.isVertical(*ld))
+			light += 16;
+		else if (inst.level.isHorizontal(*ld))
+			light -= 16;
 
-			// add "fake constrast" for axis-aligned walls
-			if (inst.level.isVertical(*ld))
-				light += 16;
-			else if (inst.level.isHorizontal(*ld))
-				light -= 16;
+		cur_znormal = 0;
+		cur_plane_z = 0;
+		cur_sloped = false;
+		cur_light = fullbright ? RGL_FULLBRIGHT : light;
 
+		if (inst.r_view.lighting && !fullbright && !building)
+		{
 			LightClippedQuad(x1,y1,&p1, x2,y2,&p2, tx1,tx2,z1,tex_scale,
 							 'R', static_cast<float>(r0), static_cast<float>(g0), static_cast<float>(b0), light);
 		}
@@ -995,12 +1439,34 @@ public:
 				seen_sectors.set(inst.level.getRight(*ld)->sector);
 		}
 
-		/* actually draw it... */
+		DrawLineSide(ld_index, side);
+	}
 
-		x1 = static_cast<float>(inst.level.getStart(*ld).x());
-		y1 = static_cast<float>(inst.level.getStart(*ld).y());
-		x2 = static_cast<float>(inst.level.getEnd(*ld).x());
-		y2 = static_cast<float>(inst.level.getEnd(*ld).y());
+	// draws the walls of one side of a linedef, no matter where the
+	// camera is.
+	void DrawLineSide(int ld_index, Side side)
+	{
+		const auto ld = inst.level.linedefs[ld_index];
+
+		if (!inst.level.isVertex(ld->start) || !inst.level.isVertex(ld->end))
+			return;
+
+		if (! inst.level.getRight(*ld))
+			return;
+
+		const SideDef *sd = (side == Side::left) ? inst.level.getLeft(*ld) : inst.level.getRight(*ld);
+
+		if (! sd)
+			return;
+
+		bool self_ref = false;
+		if (inst.level.getLeft(*ld) && inst.level.getRight(*ld) && inst.level.getLeft(*ld)->sector == inst.level.getRight(*ld)->sector)
+			self_ref = true;
+
+		float x1 = static_cast<float>(inst.level.getStart(*ld).x());
+		float y1 = static_cast<float>(inst.level.getStart(*ld).y());
+		float x2 = static_cast<float>(inst.level.getEnd(*ld).x());
+		float y2 = static_cast<float>(inst.level.getEnd(*ld).y());
 
 		if (side == Side::left)
 		{
@@ -1012,14 +1478,14 @@ public:
 
 		const Sector *front = sd ? &inst.level.getSector(*sd) : NULL;
 
-		bool sky_front = inst.is_sky(front->CeilTex());
+		bool sky_front = IsSky(front->ceil_tex);
 		bool sky_upper = false;
 
 		if (ld->OneSided())
 		{
 			sector_3dfloors_c *ex = inst.Subdiv_3DFloorsForSector(sd->sector);
 
-			DrawSide('W', ld.get(), sd, sd->MidTex(), front, NULL, false,
+			DrawSide('W', ld.get(), sd, sd->mid_tex, front, NULL, false,
 				ld_len, x1, y1, &ex->f_plane, x2, y2, &ex->c_plane);
 		}
 		else
@@ -1027,7 +1493,7 @@ public:
 			const SideDef *sd_back = (side == Side::left) ? inst.level.getRight(*ld) : inst.level.getLeft(*ld);
 			const Sector *back  = sd_back ? &inst.level.getSector(*sd_back) : NULL;
 
-			sky_upper = sky_front && inst.is_sky(back->CeilTex());
+			sky_upper = sky_front && IsSky(back->ceil_tex);
 
 			// check for BOOM 242 invisible platforms
 			bool invis_back = false;
@@ -1058,16 +1524,17 @@ public:
 
 			// lower part
 			if ((back->floorh > front->floorh || f_sloped) && !self_ref && !invis_back)
-				DrawSide('L', ld.get(), sd, sd->LowerTex(), front, back, sky_upper,
+				DrawSide('L', ld.get(), sd, sd->lower_tex, front, back, sky_upper,
 					ld_len, x1, y1, f_floorp, x2, y2, &b_ex->f_plane);
 
 			// upper part
 			if ((back->ceilh < front->ceilh || c_sloped) && !self_ref && !sky_upper)
-				DrawSide('U', ld.get(), sd, sd->UpperTex(), front, back, sky_upper,
+				DrawSide('U', ld.get(), sd, sd->upper_tex, front, back, sky_upper,
 					ld_len, x1, y1, &b_ex->c_plane, x2, y2, &f_ex->c_plane);
 
 			// railing tex
-			if (!is_null_tex(sd->MidTex()) && inst.r_view.texturing)
+			if (inst.r_view.texturing &&
+				inst.wad.images.resolveTexture(inst.conf, inst.wad.palette, sd->mid_tex).how != ImageResolve::missing)
 				DrawMidMasker(ld.get(), sd, front, back, sky_upper,
 					ld_len, x1, y1, x2, y2);
 
@@ -1092,13 +1559,13 @@ public:
 					if (top_h <= bottom_h)
 						continue;
 
-					SString tex = "-";
+					StringID tex;
 					if (EF.flags & EXFL_UPPER)
-						tex = sd->UpperTex();
+						tex = sd->upper_tex;
 					else if (EF.flags & EXFL_LOWER)
-						tex = sd->LowerTex();
+						tex = sd->lower_tex;
 					else
-						tex = ef_sd->MidTex();
+						tex = ef_sd->mid_tex;
 
 					slope_plane_c p1; p1.Init(static_cast<float>(bottom_h));
 					slope_plane_c p2; p2.Init(static_cast<float>(top_h));
@@ -1121,7 +1588,7 @@ public:
 			slope_plane_c p1; p1.Init(static_cast<float>(front->ceilh));
 			slope_plane_c p2; p2.Init(static_cast<float>(front->ceilh + 16384.0));
 
-			DrawSide('U', ld.get(), sd, "-", front, NULL, true /* sky_upper */,
+			DrawSide('U', ld.get(), sd, StringID(), front, NULL, true /* sky_upper */,
 				ld_len, x1, y1, &p1, x2, y2, &p2);
 		}
 	}
@@ -1147,45 +1614,45 @@ public:
 			if (dummy->floorh > sec->floorh && inst.r_view.z < dummy->floorh)
 			{
 				// space C : underwater
-				DrawSectorPolygons(sec.get(), subdiv, NULL, -1, static_cast<float>(dummy->floorh), dummy->CeilTex());
-				DrawSectorPolygons(sec.get(), subdiv, NULL, +1, static_cast<float>(sec->floorh), dummy->FloorTex());
+				DrawSectorPolygons(sec.get(), subdiv, NULL, -1, static_cast<float>(dummy->floorh), dummy->ceil_tex);
+				DrawSectorPolygons(sec.get(), subdiv, NULL, +1, static_cast<float>(sec->floorh), dummy->floor_tex);
 
 				// this helps the view to not look weird when clipping around
 				if (dummy->ceilh > sec->floorh)
-					DrawSectorPolygons(sec.get(), subdiv, NULL, -1, static_cast<float>(dummy->ceilh), sec->CeilTex());
+					DrawSectorPolygons(sec.get(), subdiv, NULL, -1, static_cast<float>(dummy->ceilh), sec->ceil_tex);
 			}
 			else if (dummy->ceilh < sec->ceilh && inst.r_view.z > dummy->ceilh)
 			{
 				// space A : head over ceiling
-				DrawSectorPolygons(sec.get(), subdiv, NULL, -1, static_cast<float>(dummy->ceilh), dummy->FloorTex());
-				DrawSectorPolygons(sec.get(), subdiv, NULL, -1, static_cast<float>(sec->ceilh), dummy->CeilTex());
+				DrawSectorPolygons(sec.get(), subdiv, NULL, -1, static_cast<float>(dummy->ceilh), dummy->floor_tex);
+				DrawSectorPolygons(sec.get(), subdiv, NULL, -1, static_cast<float>(sec->ceilh), dummy->ceil_tex);
 
 				if (dummy->floorh < sec->ceilh)
-					DrawSectorPolygons(sec.get(), subdiv, NULL, +1, static_cast<float>(dummy->floorh), sec->FloorTex());
+					DrawSectorPolygons(sec.get(), subdiv, NULL, +1, static_cast<float>(dummy->floorh), sec->floor_tex);
 			}
 			else if (dummy->floorh < sec->floorh)
 			{
 				// invisible platform
-				DrawSectorPolygons(sec.get(), subdiv, NULL, +1, static_cast<float>(dummy->floorh), sec->FloorTex());
+				DrawSectorPolygons(sec.get(), subdiv, NULL, +1, static_cast<float>(dummy->floorh), sec->floor_tex);
 
-				if (!inst.is_sky(sec->CeilTex()))
-					DrawSectorPolygons(sec.get(), subdiv, NULL, -1, static_cast<float>(dummy->ceilh), sec->CeilTex());
+				if (!IsSky(sec->ceil_tex))
+					DrawSectorPolygons(sec.get(), subdiv, NULL, -1, static_cast<float>(dummy->ceilh), sec->ceil_tex);
 			}
 			else
 			{
 				// space B : normal
-				DrawSectorPolygons(sec.get(), subdiv, NULL, +1, static_cast<float>(dummy->floorh), sec->FloorTex());
+				DrawSectorPolygons(sec.get(), subdiv, NULL, +1, static_cast<float>(dummy->floorh), sec->floor_tex);
 
-				if (!inst.is_sky(sec->CeilTex()))
-					DrawSectorPolygons(sec.get(), subdiv, NULL, -1, static_cast<float>(dummy->ceilh), sec->CeilTex());
+				if (!IsSky(sec->ceil_tex))
+					DrawSectorPolygons(sec.get(), subdiv, NULL, -1, static_cast<float>(dummy->ceilh), sec->ceil_tex);
 			}
 		} else {
 
 			// normal sector
-			DrawSectorPolygons(sec.get(), subdiv, &exfloor->f_plane, +1, static_cast<float>(sec->floorh), sec->FloorTex());
+			DrawSectorPolygons(sec.get(), subdiv, &exfloor->f_plane, +1, static_cast<float>(sec->floorh), sec->floor_tex);
 
-			if (!inst.is_sky(sec->CeilTex()))
-				DrawSectorPolygons(sec.get(), subdiv, &exfloor->c_plane, -1, static_cast<float>(sec->ceilh), sec->CeilTex());
+			if (!IsSky(sec->ceil_tex))
+				DrawSectorPolygons(sec.get(), subdiv, &exfloor->c_plane, -1, static_cast<float>(sec->ceilh), sec->ceil_tex);
 		}
 
 		// draw planes of 3D floors
@@ -1202,8 +1669,8 @@ public:
 			int top_h = dummy->ceilh;
 			int bottom_h = dummy->floorh;
 
-			SString top_tex = dummy->CeilTex();
-			SString bottom_tex = dummy->FloorTex();
+			StringID top_tex = dummy->ceil_tex;
+			StringID bottom_tex = dummy->floor_tex;
 
 			if (EF.flags & EXFL_TOP)
 				bottom_h = top_h;
@@ -1613,19 +2080,412 @@ public:
 			seen_sectors.set(obj.num);
 	}
 
-	void Render()
+	//
+	// Uploads every image the level uses ahead of time, instead of when
+	// it first comes into view, which would stall that frame.
+	//
+	void PreloadImages()
+	{
+		typedef std::chrono::steady_clock clock;
+
+		clock::time_point start = clock::now();
+
+		const GLUploadStats before = global::gl_uploads;
+
+		byte r, g, b;
+		bool fullbright;
+
+		for (const auto &sd : inst.level.sidedefs)
+		{
+			FindTexture(sd->upper_tex, r, g, b, fullbright);
+			FindTexture(sd->mid_tex,   r, g, b, fullbright);
+			FindTexture(sd->lower_tex, r, g, b, fullbright);
+		}
+
+		for (const auto &sec : inst.level.sectors)
+		{
+			FindFlat(sec->floor_tex, r, g, b, fullbright);
+			FindFlat(sec->ceil_tex,  r, g, b, fullbright);
+		}
+
+		// only the front rotation, others are seen less often
+		if (inst.r_view.sprites)
+		{
+			for (const auto &th : inst.level.things)
+			{
+				Img_c *img = inst.wad.getMutableSprite(inst.conf, th->type, inst.loaded, 1);
+
+				if (img)
+					img->bind_gl(inst.wad);
+			}
+		}
+
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		double millis = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+		gLog.debugPrintf("Uploaded %d images (%zu KB) in %1.1f ms, %1.1f ms of it in OpenGL\n",
+						 global::gl_uploads.images - before.images,
+						 (global::gl_uploads.bytes - before.bytes) / 1024,
+						 millis, global::gl_uploads.millis - before.millis);
+	}
+
+	static bool IsSpecial(const sector_3dfloors_c *ex)
+	{
+		return ex->heightsec >= 0 || !ex->floors.empty() ||
+			ex->f_plane.sloped || ex->c_plane.sloped;
+	}
+
+	RGL_MeshCache &Meshes()
+	{
+		if (! inst.r_view.gl_meshes)
+			inst.r_view.gl_meshes = std::make_shared<RGL_MeshCache>();
+
+		return *inst.r_view.gl_meshes;
+	}
+
+	//
+	// Forgets the meshes of the sectors touched by the edits since the
+	// last frame, plus their neighbours (whose walls face into them).
+	//
+	void UpdateMeshes()
+	{
+		RGL_MeshCache &cache = Meshes();
+		Render_GLDirty_t &dirty = inst.r_view.gl_dirty;
+
+		const int num_sectors = inst.level.numSectors();
+		const int num_lines = inst.level.numLinedefs();
+
+		if (dirty.all ||
+			cache.sectors.size() != (size_t)num_sectors ||
+			cache.line_sectors.size() != (size_t)num_lines ||
+			cache.texturing != inst.r_view.texturing ||
+			cache.lighting != inst.r_view.lighting ||
+			cache.npot != global::use_npot_textures)
+		{
+			cache.sectors.clear();
+			cache.sectors.resize((size_t)num_sectors);
+
+			cache.line_sectors.resize((size_t)num_lines);
+
+			for (int n = 0 ; n < num_lines ; n++)
+			{
+				const auto L = inst.level.linedefs[n];
+
+				cache.line_sectors[n] = { inst.level.getSectorID(*L, Side::right),
+										  inst.level.getSectorID(*L, Side::left) };
+			}
+
+			cache.texturing = inst.r_view.texturing;
+			cache.lighting = inst.r_view.lighting;
+			cache.npot = global::use_npot_textures;
+
+			dirty.Clear();
+			return;
+		}
+
+		if (dirty.empty())
+			return;
+
+		std::vector<char> moved_verts((size_t)inst.level.numVertices(), 0);
+		std::vector<char> moved_lines((size_t)num_lines, 0);
+		std::vector<char> changed_sides((size_t)inst.level.numSidedefs(), 0);
+		std::vector<char> changed((size_t)num_sectors, 0);
+		std::vector<char> rebuild((size_t)num_sectors, 0);
+
+		auto mark = [](std::vector<char> &list, int num)
+		{
+			if (num >= 0 && num < (int)list.size())
+				list[num] = 1;
+		};
+
+		for (int v : dirty.vertices)
+			mark(moved_verts, v);
+
+		for (int ld : dirty.linedefs)
+			mark(moved_lines, ld);
+
+		for (int sd : dirty.sidedefs)
+			mark(changed_sides, sd);
+
+		for (int sec : dirty.sectors)
+			mark(changed, sec);
+
+		// a changed sector may be the dummy of a 3D floor, or the source
+		// of a slope, anywhere in the map
+		if (dirty.floors || !dirty.sectors.empty())
+		{
+			for (int sec = 0 ; sec < num_sectors ; sec++)
+			{
+				if (cache.sectors[sec].special ||
+					(dirty.floors && IsSpecial(inst.Subdiv_3DFloorsForSector(sec))))
+				{
+					changed[sec] = 1;
+				}
+			}
+		}
+
+		for (int n = 0 ; n < num_lines ; n++)
+		{
+			const auto L = inst.level.linedefs[n];
+
+			std::pair<int, int> secs = { inst.level.getSectorID(*L, Side::right),
+										 inst.level.getSectorID(*L, Side::left) };
+
+			bool touched = moved_lines[n] || moved_verts[L->start] || moved_verts[L->end] ||
+				(L->right >= 0 && changed_sides[L->right]) ||
+				(L->left  >= 0 && changed_sides[L->left]);
+
+			if (secs != cache.line_sectors[n])
+			{
+				// both the sectors which lost the line and which gained it
+				mark(rebuild, cache.line_sectors[n].first);
+				mark(rebuild, cache.line_sectors[n].second);
+
+				cache.line_sectors[n] = secs;
+				touched = true;
+			}
+
+			if (secs.first >= 0 && changed[secs.first])
+				touched = true;
+			if (secs.second >= 0 && changed[secs.second])
+				touched = true;
+
+			if (touched)
+			{
+				mark(rebuild, secs.first);
+				mark(rebuild, secs.second);
+			}
+		}
+
+		for (int sec = 0 ; sec < num_sectors ; sec++)
+			if (changed[sec] || rebuild[sec])
+				cache.sectors[sec].built = false;
+
+		dirty.Clear();
+	}
+
+	void BuildMesh(int sec, rgl_sector_mesh_t &mesh)
+	{
+		const sector_3dfloors_c *ex = inst.Subdiv_3DFloorsForSector(sec);
+		const sector_extra_info_t &info = inst.sector_info_cache.infos[sec];
+
+		mesh.batches.clear();
+		mesh.special = IsSpecial(ex);
+		mesh.immediate_flats = (ex->heightsec >= 0);
+
+		building = &mesh;
+
+		for (int n = info.first_line ; n >= 0 && n <= info.last_line ; n++)
+		{
+			const auto L = inst.level.linedefs[n];
+
+			for (Side side : { Side::right, Side::left })
+			{
+				if (inst.level.getSectorID(*L, side) != sec)
+					continue;
+
+				DrawLineSide(n, side);
+
+				int back = inst.level.getSectorID(*L, (side == Side::left) ? Side::right : Side::left);
+
+				if (back >= 0 && IsSpecial(inst.Subdiv_3DFloorsForSector(back)))
+					mesh.special = true;
+			}
+		}
+
+		if (! mesh.immediate_flats)
+			DrawSector(sec);
+
+		building = NULL;
+
+		mesh.built = true;
+	}
+
+	bool SectorInView(int sec) const
+	{
+		const sector_extra_info_t &info = inst.sector_info_cache.infos[sec];
+
+		if (info.first_line < 0)
+			return false;
+
+		double near_dist = +1e30;
+		double far_dist  = -1e30;
+
+		for (double x : { info.bound_x1, info.bound_x2 })
+		for (double y : { info.bound_y1, info.bound_y2 })
+		{
+			double dist = (x - inst.r_view.x) * inst.r_view.Cos + (y - inst.r_view.y) * inst.r_view.Sin;
+
+			near_dist = std::min(near_dist, dist);
+			far_dist  = std::max(far_dist,  dist);
+		}
+
+		// completely behind the camera, or beyond the far clip?
+		return far_dist > 0 && near_dist < config::render_far_clip;
+	}
+
+	void DrawMeshes(rgl_light_shader_t *shader)
 	{
-		// always draw the sector the camera is in
-		MarkCameraSector();
+		RGL_MeshCache &cache = Meshes();
+
+		// bring the sector bounds up to date
+		inst.sector_info_cache.Update();
+
+		cache.draw_list.clear();
+		cache.immediate_sectors.clear();
+
+		for (int sec = 0 ; sec < inst.level.numSectors() ; sec++)
+		{
+			if (! SectorInView(sec))
+				continue;
+
+			rgl_sector_mesh_t &mesh = cache.sectors[sec];
+
+			if (! mesh.built)
+				BuildMesh(sec, mesh);
+
+			if (mesh.immediate_flats)
+				cache.immediate_sectors.push_back(sec);
+
+			for (const rgl_batch_t &batch : mesh.batches)
+			{
+				if (batch.verts.empty())
+					continue;
+
+				// check if camera is behind plane
+				if (! batch.sloped)
+				{
+					if (batch.znormal > 0 && inst.r_view.z < batch.plane_z) continue;
+					if (batch.znormal < 0 && inst.r_view.z > batch.plane_z) continue;
+				}
+
+				cache.draw_list.push_back(&batch);
+			}
+		}
+
+		// group the batches to bind each image once
+		std::sort(cache.draw_list.begin(), cache.draw_list.end(),
+			[](const rgl_batch_t *A, const rgl_batch_t *B)
+			{
+				if (A->img != B->img)
+					return std::less<const Img_c *>()(A->img, B->img);
+
+				if (A->masked != B->masked)
+					return B->masked;
+
+				return (A->znormal == 0) < (B->znormal == 0);
+			});
+
+		glEnableClientState(GL_VERTEX_ARRAY);
+		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+		glEnableClientState(GL_COLOR_ARRAY);
+
+		// walls are only seen from the front, which winds clockwise
+		glFrontFace(GL_CW);
+		glCullFace(GL_BACK);
+
+		if (shader)
+			shader->Begin();
 
-		for (int i=0 ; i < inst.level.numLinedefs(); i++)
-			DrawLine(i);
+		const rgl_batch_t *prev = NULL;
+
+		for (const rgl_batch_t *batch : cache.draw_list)
+		{
+			if (! prev || batch->img != prev->img)
+			{
+				if (batch->img)
+					batch->img->bind_gl(inst.wad);
+				else
+					glBindTexture(GL_TEXTURE_2D, 0);
+
+				if (shader)
+					shader->SetTextured(batch->img != NULL);
+			}
+
+			if (! prev || batch->masked != prev->masked)
+			{
+				if (batch->masked)
+					glEnable(GL_ALPHA_TEST);
+				else
+					glDisable(GL_ALPHA_TEST);
+			}
+
+			if (! prev || (batch->znormal == 0) != (prev->znormal == 0))
+			{
+				if (batch->znormal == 0)
+					glEnable(GL_CULL_FACE);
+				else
+					glDisable(GL_CULL_FACE);
+			}
+
+			const GLfloat *v = batch->verts.data();
+			const GLsizei stride = RGL_VERTEX_FLOATS * sizeof(GLfloat);
+
+			glVertexPointer(3, GL_FLOAT, stride, v);
+			glTexCoordPointer(3, GL_FLOAT, stride, v + 3);
+			glColorPointer(3, GL_FLOAT, stride, v + 6);
+
+			glDrawArrays(GL_TRIANGLES, 0, (GLsizei)(batch->verts.size() / RGL_VERTEX_FLOATS));
+
+			prev = batch;
+		}
+
+		if (shader)
+			shader->End();
+
+		glDisableClientState(GL_VERTEX_ARRAY);
+		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+		glDisableClientState(GL_COLOR_ARRAY);
+
+		glDisable(GL_CULL_FACE);
+		glFrontFace(GL_CCW);
 
 		glDisable(GL_ALPHA_TEST);
 
-		for (int s=0 ; s < inst.level.numSectors(); s++)
-			if (seen_sectors.get(s))
-				DrawSector(s);
+		for (int sec : cache.immediate_sectors)
+			DrawSector(sec);
+	}
+
+	void Render()
+	{
+		if (inst.r_view.gl_dirty.images)
+		{
+			inst.r_view.gl_dirty.images = false;
+			PreloadImages();
+		}
+
+		rgl_light_shader_t *shader = NULL;
+
+		if (inst.r_view.lighting && config::render_gl_shaders &&
+			Meshes().light_shader.Prepare())
+		{
+			shader = &Meshes().light_shader;
+		}
+
+		if (inst.r_view.lighting && ! shader)
+		{
+			// without shaders, DOOM lighting depends on clipping by the
+			// distance to the camera, so the lit view is drawn from
+			// scratch each frame.
+
+			// always draw the sector the camera is in
+			MarkCameraSector();
+
+			for (int i=0 ; i < inst.level.numLinedefs(); i++)
+				DrawLine(i);
+
+			glDisable(GL_ALPHA_TEST);
+
+			for (int s=0 ; s < inst.level.numSectors(); s++)
+				if (seen_sectors.get(s))
+					DrawSector(s);
+		}
+		else
+		{
+			UpdateMeshes();
+			DrawMeshes(shader);
+		}
 
 		glEnable(GL_ALPHA_TEST);
 
@@ -1700,6 +2560,16 @@ public:
 };
 
 
+void RGL_ForgetContext(Instance &inst)
+{
+	// the shader program and the textures belonged to it
+	if (inst.r_view.gl_meshes)
+		inst.r_view.gl_meshes->light_shader = rgl_light_shader_t();
+
+	inst.r_view.gl_dirty.images = true;
+}
+
+
 void RGL_RenderWorld(Instance &inst, int ox, int oy, int pixel_w, int pixel_h)
 {
 	RendInfo3D rend(inst);
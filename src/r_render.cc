@@ -57,6 +57,7 @@ bool config::render_high_detail    = false;
 bool config::render_lock_gravity   = false;
 bool config::render_missing_bright = true;
 bool config::render_unknown_bright = true;
+bool config::render_gl_shaders     = true;
 
 int  config::render_far_clip = 32768;
 
@@ -239,20 +240,41 @@ void Render3D_NotifyBegin()
 	thing_sec_cache::ResetRange();
 }
 
-void Render3D_NotifyInsert(ObjType type, int objnum)
+void Render3D_NotifyInsert(Instance &inst, ObjType type, int objnum)
 {
 	if (type == ObjType::things)
+	{
 		thing_sec_cache::InvalidateThing(objnum);
+
+		// it may be a slope thing
+		inst.r_view.gl_dirty.floors = true;
+	}
+	else
+	{
+		// inserting renumbers the later objects
+		inst.r_view.gl_dirty.all = true;
+	}
 }
 
-void Render3D_NotifyDelete(const Document &doc, ObjType type, int objnum)
+void Render3D_NotifyDelete(Instance &inst, ObjType type, int objnum)
 {
 	if (type == ObjType::things || type == ObjType::sectors)
-		thing_sec_cache::InvalidateAll(doc, true);
+		thing_sec_cache::InvalidateAll(inst.level, true);
+
+	if (type == ObjType::things)
+		inst.r_view.gl_dirty.floors = true;
+	else
+		inst.r_view.gl_dirty.all = true;
 }
 
-void Render3D_NotifyChange(ObjType type, int objnum, Field field)
+void Render3D_NotifyChange(Instance &inst, ObjType type, int objnum, Field field)
 {
+	Render_GLDirty_t &dirty = inst.r_view.gl_dirty;
+
+	// without meshes there is nothing to update, the first frame builds
+	// them all
+	bool record = inst.r_view.gl_meshes != nullptr;
+
 	std::visit(overloaded {
 		[objnum, type](double Thing::*field) {
 			if (type == ObjType::things &&
@@ -261,8 +283,55 @@ void Render3D_NotifyChange(ObjType type, int objnum, Field field)
 				thing_sec_cache::InvalidateThing(objnum);
 			}
 		},
+		[&dirty, objnum, type, record](int LineDef::*field) {
+			if (type != ObjType::linedefs || ! record)
+				return;
+
+			if (field == &LineDef::type ||
+				field == &LineDef::arg1 || field == &LineDef::arg2 || field == &LineDef::arg3 ||
+				field == &LineDef::arg4 || field == &LineDef::arg5)
+			{
+				dirty.floors = true;
+			}
+			else if (field != &LineDef::lineid)
+			{
+				dirty.Add(dirty.linedefs, objnum);
+			}
+		},
 		[](auto arg) {}
 	}, field);
+
+	if (! record)
+		return;
+
+	switch (type)
+	{
+	case ObjType::vertices:
+		dirty.Add(dirty.vertices, objnum);
+		break;
+
+	case ObjType::sidedefs:
+		dirty.Add(dirty.sidedefs, objnum);
+		break;
+
+	case ObjType::sectors:
+		dirty.Add(dirty.sectors, objnum);
+
+		if (std::holds_alternative<int>(field) && std::get<int>(field) == Sector::F_TAG)
+			dirty.floors = true;
+		break;
+
+	case ObjType::things:
+		if (Subdiv_IsSlopeThing(inst.level.things[objnum]->type) ||
+			(std::holds_alternative<int>(field) && std::get<int>(field) == Thing::F_TYPE))
+		{
+			dirty.floors = true;
+		}
+		break;
+
+	default:
+		break;
+	}
 }
 
 void Render3D_NotifyEnd(Instance &inst)
@@ -29,6 +29,92 @@
 
 #include "im_img.h"
 
+struct RendInfo;
+struct RGL_MeshCache;
+
+
+//
+// The linedefs bucketed into square cells of the map, so that the
+// software renderer can visit them from the camera outwards.  Rebuilt
+// whenever Instance::map_revision changes.
+//
+struct Render_LineGrid_t
+{
+	static constexpr int MIN_CELL_SIZE = 256;
+	static constexpr int MAX_CELLS = 512;  // along each axis
+
+	bool valid = false;
+	unsigned revision = 0;
+
+	// map coordinate of the first cell, and size in cells
+	int x0 = 0, y0 = 0;
+	int w = 0, h = 0;
+	int cell_size = MIN_CELL_SIZE;
+
+	// lines of cell (cx, cy) are lines[start[i] .. start[i+1]-1]
+	// where i = cy * w + cx
+	std::vector<int> start;
+	std::vector<int> lines;
+
+	// last frame which visited each line (lines span several cells)
+	std::vector<unsigned> line_visit;
+	unsigned frame = 0;
+};
+
+//
+// The edits which the OpenGL renderer has not yet applied to its
+// retained sector geometry.  Filled by the Render3D_Notify functions.
+//
+struct Render_GLDirty_t
+{
+	bool all = true;
+
+	// something which may define a slope or 3D floor changed
+	bool floors = false;
+
+	// the level, its resources or the OpenGL context changed, so the
+	// images it uses need uploading.  Not reset by Clear().
+	bool images = true;
+
+	std::vector<int> vertices;
+	std::vector<int> linedefs;
+	std::vector<int> sidedefs;
+	std::vector<int> sectors;
+
+	bool empty() const
+	{
+		return !all && !floors && vertices.empty() && linedefs.empty() &&
+			sidedefs.empty() && sectors.empty();
+	}
+
+	// past this many recorded objects, rebuilding everything is cheaper
+	static constexpr size_t LIMIT = 4096;
+
+	void Add(std::vector<int> &list, int num)
+	{
+		if (all)
+			return;
+
+		if (vertices.size() + linedefs.size() + sidedefs.size() + sectors.size() >= LIMIT)
+		{
+			Clear();
+			all = true;
+			return;
+		}
+
+		list.push_back(num);
+	}
+
+	void Clear()
+	{
+		all = floors = false;
+
+		vertices.clear();
+		linedefs.clear();
+		sidedefs.clear();
+		sectors.clear();
+	}
+};
 
 struct Render_View_t
 {
@@ -48,6 +134,9 @@ public:
 	int screen_w = 0, screen_h = 0;
 	img_pixel_t *screen = nullptr;
 
+	// the screen converted to RGB, for drawing it in one go
+	std::vector<byte> screen_rgb;
+
 	float aspect_sh = 0;
 	float aspect_sw = 0;  // screen_w * aspect_ratio
 
@@ -59,6 +148,15 @@ public:
 
 	std::vector<int> thing_sectors;
 
+	Render_LineGrid_t line_grid;
+
+	// the software renderer's state, reused between frames
+	std::shared_ptr<RendInfo> sw_renderer;
+
+	// the OpenGL renderer's geometry of each sector, kept between frames
+	std::shared_ptr<RGL_MeshCache> gl_meshes;
+	Render_GLDirty_t gl_dirty;
+
 	// current mouse coords (in window), invalid if -1
 	int mouse_x = -1, mouse_y = -1;
 
@@ -108,9 +206,9 @@ void Render3D_DragThings(Instance &inst);
 void Render3D_DragSectors(Instance &inst);
 
 void Render3D_NotifyBegin();
-void Render3D_NotifyInsert(ObjType type, int objnum);
-void Render3D_NotifyDelete(const Document &doc, ObjType type, int objnum);
-void Render3D_NotifyChange(ObjType type, int objnum, Field field);
+void Render3D_NotifyInsert(Instance &inst, ObjType type, int objnum);
+void Render3D_NotifyDelete(Instance &inst, ObjType type, int objnum);
+void Render3D_NotifyChange(Instance &inst, ObjType type, int objnum, Field field);
 void Render3D_NotifyEnd(Instance &inst);
 
 int Render3D_CalcRotation(double viewAngle_rad, int thingAngle_deg);
@@ -119,6 +217,9 @@ int Render3D_CalcRotation(double viewAngle_rad, int thingAngle_deg);
 
 void RGL_RenderWorld(Instance &inst, int ox, int oy, int ow, int oh);
 
+// the OpenGL context is new, forget what belonged to the old one
+void RGL_ForgetContext(Instance &inst);
+
 #endif  /* __EUREKA_R_RENDER__ */
 
 //--- editor settings ---
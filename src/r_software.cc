@@ -26,6 +26,9 @@
 
 #include <map>
 #include <algorithm>
+#include <array>
+#include <deque>
+#include <optional>
 
 #ifndef NO_OPENGL
 #include "FL/gl.h"
@@ -33,9 +36,11 @@
 
 #include "im_color.h"
 #include "im_img.h"
+#include "e_basis.h"
 #include "e_hover.h"
 #include "e_linedef.h"
 #include "e_main.h"
+#include "lib_parallel.h"
 #include "LineDef.h"
 #include "m_config.h"
 #include "m_game.h"
@@ -48,28 +53,160 @@
 #include "Thing.h"
 #include "Vertex.h"
 
-static img_pixel_t DoomLightRemap(const Instance &inst, int light, float dist, img_pixel_t pixel)
+//
+// For each light map (0 bright .. 31 dark), what a 5-bit RGB channel
+// becomes.  This matches how the colormaps darken palette colors.
+//
+static constexpr std::array<std::array<byte, 32>, 32> MakeRGBLightTable()
 {
-	int map = R_DoomLightingEquation(light, dist);
+	std::array<std::array<byte, 32>, 32> table = {};
 
-	if (pixel & IS_RGB_PIXEL)
+	for (int map = 0 ; map < 32 ; map++)
 	{
-		map = (map ^ 31) + 1;
+		int scale = (map ^ 31) + 1;
 
-		int r = IMG_PIXEL_RED(pixel);
-		int g = IMG_PIXEL_GREEN(pixel);
-		int b = IMG_PIXEL_BLUE(pixel);
+		for (int c = 0 ; c < 32 ; c++)
+			table[map][c] = static_cast<byte>((c * scale) >> 5);
+	}
 
-		r = (r * map) >> 5;
-		g = (g * map) >> 5;
-		b = (b * map) >> 5;
+	return table;
+}
 
-		return pixelMakeRGB(r, g, b);
+static constexpr std::array<std::array<byte, 32>, 32> rgb_light_table = MakeRGBLightTable();
+
+
+//
+// Darkens pixels to a single light map.  Palette pixels go through the
+// COLORMAP row and RGB pixels through the channel table above, so it's
+// only a lookup per pixel.  Walls and sprites have a constant distance
+// over a column, hence need one of these per column; flats need a new
+// one whenever the light map changes between rows.
+//
+class LightRemap
+{
+private:
+	const byte *cmap;
+	const byte *rgb;
+
+public:
+	LightRemap() : cmap(nullptr), rgb(nullptr)
+	{ }
+
+	LightRemap(const Instance &inst, int light, float dist)
+	{
+		Set(inst, R_DoomLightingEquation(light, dist));
 	}
-	else
+
+	void Set(const Instance &inst, int map)
+	{
+		cmap = inst.wad.palette.getColormap(map);
+		rgb  = rgb_light_table[map].data();
+	}
+
+	img_pixel_t operator() (img_pixel_t pixel) const
+	{
+		if (pixel & IS_RGB_PIXEL)
+		{
+			return pixelMakeRGB(rgb[IMG_PIXEL_RED(pixel)],
+								rgb[IMG_PIXEL_GREEN(pixel)],
+								rgb[IMG_PIXEL_BLUE(pixel)]);
+		}
+
+		return cmap[pixel];
+	}
+};
+
+
+//
+// Buckets every linedef into the grid cells its bounding box touches.
+//
+static void BuildLineGrid(Instance &inst)
+{
+	Render_LineGrid_t &grid = inst.r_view.line_grid;
+	const Document &doc = inst.level;
+
+	grid.valid = true;
+	grid.revision = inst.map_revision;
+
+	grid.w = grid.h = 0;
+	grid.start.clear();
+	grid.lines.clear();
+	grid.line_visit.assign(doc.numLinedefs(), 0);
+	grid.frame = 0;
+
+	if (doc.numVertices() == 0)
+		return;
+
+	double min_x = doc.vertices[0]->x();
+	double min_y = doc.vertices[0]->y();
+	double max_x = min_x;
+	double max_y = min_y;
+
+	for (const auto &vertex : doc.vertices)
 	{
-		return inst.wad.palette.getColormapIndex(map, pixel);
+		min_x = std::min(min_x, vertex->x());
+		min_y = std::min(min_y, vertex->y());
+		max_x = std::max(max_x, vertex->x());
+		max_y = std::max(max_y, vertex->y());
 	}
+
+	// very large maps get larger cells
+	double extent = std::max(max_x - min_x, max_y - min_y);
+
+	grid.cell_size = std::max(Render_LineGrid_t::MIN_CELL_SIZE,
+							  static_cast<int>(ceil(extent / Render_LineGrid_t::MAX_CELLS)) + 1);
+
+	grid.x0 = static_cast<int>(floor(min_x));
+	grid.y0 = static_cast<int>(floor(min_y));
+	grid.w  = static_cast<int>((max_x - grid.x0) / grid.cell_size) + 1;
+	grid.h  = static_cast<int>((max_y - grid.y0) / grid.cell_size) + 1;
+
+	grid.start.assign(static_cast<size_t>(grid.w) * grid.h + 1, 0);
+
+	// first pass counts the lines in each cell, second pass stores them
+	for (int pass = 0 ; pass < 2 ; pass++)
+	{
+		for (int n = 0 ; n < doc.numLinedefs() ; n++)
+		{
+			const LineDef &ld = *doc.linedefs[n];
+
+			if (! doc.isVertex(ld.start) || ! doc.isVertex(ld.end))
+				continue;
+
+			const Vertex &v1 = doc.getStart(ld);
+			const Vertex &v2 = doc.getEnd(ld);
+
+			int cx1 = static_cast<int>((std::min(v1.x(), v2.x()) - grid.x0) / grid.cell_size);
+			int cy1 = static_cast<int>((std::min(v1.y(), v2.y()) - grid.y0) / grid.cell_size);
+			int cx2 = static_cast<int>((std::max(v1.x(), v2.x()) - grid.x0) / grid.cell_size);
+			int cy2 = static_cast<int>((std::max(v1.y(), v2.y()) - grid.y0) / grid.cell_size);
+
+			for (int cy = cy1 ; cy <= cy2 ; cy++)
+			for (int cx = cx1 ; cx <= cx2 ; cx++)
+			{
+				size_t cell = static_cast<size_t>(cy) * grid.w + cx;
+
+				if (pass == 0)
+					grid.start[cell + 1]++;
+				else
+					grid.lines[grid.start[cell]++] = n;
+			}
+		}
+
+		if (pass == 0)
+		{
+			for (size_t i = 1 ; i < grid.start.size() ; i++)
+				grid.start[i] += grid.start[i - 1];
+
+			grid.lines.resize(grid.start.back());
+		}
+	}
+
+	// the second pass moved each start to the end of its cell
+	for (size_t i = grid.start.size() - 1 ; i > 0 ; i--)
+		grid.start[i] = grid.start[i - 1];
+
+	grid.start[0] = 0;
 }
 
 
@@ -110,11 +247,13 @@ public:
 	~DrawSurf()
 	{ }
 
-	void FindFlat(const SString & fname)
+	void FindFlat(StringID fname)
 	{
 		fullbright = false;
 
-		if (inst.is_sky(fname))
+		ResolvedImage res = inst.wad.images.resolveFlat(inst.conf, fname);
+
+		if (res.how == ImageResolve::sky)
 		{
 			col = static_cast<img_pixel_t>(inst.conf.miscInfo.sky_color);
 			fullbright = true;
@@ -123,13 +262,10 @@ public:
 
 		if (inst.r_view.texturing)
 		{
-			img = inst.wad.images.W_GetFlat(inst.conf, fname);
+			img = res.img;
 
-			if (! img)
-			{
-				img = &inst.wad.images.IM_UnknownFlat(inst.conf);
+			if (res.how == ImageResolve::unknown)
 				fullbright = config::render_unknown_bright;
-			}
 
 			return;
 		}
@@ -138,34 +274,23 @@ public:
 		if (inst.r_view.lighting)
 			col = static_cast<img_pixel_t>(inst.conf.miscInfo.floor_colors[1]);
 		else
-			col = static_cast<img_pixel_t>(HashedPalColor(fname, inst.conf.miscInfo.floor_colors));
+			col = static_cast<img_pixel_t>(HashedPalColor(BA_GetString(fname), inst.conf.miscInfo.floor_colors));
 	}
 
-	void FindTex(const SString & tname, LineDef *ld)
+	void FindTex(StringID tname, LineDef *ld)
 	{
 		fullbright = false;
 
 		if (inst.r_view.texturing)
 		{
-			if (is_null_tex(tname))
-			{
-				img = &inst.wad.images.IM_MissingTex(inst.conf);
-				fullbright = config::render_missing_bright;
-				return;
-			}
-			else if (is_special_tex(tname))
-			{
-				img = &inst.wad.images.IM_SpecialTex(inst.wad.palette);
-				return;
-			}
+			ResolvedImage res = inst.wad.images.resolveTexture(inst.conf, inst.wad.palette, tname);
 
-			img = inst.wad.images.getTexture(inst.conf, tname);
+			img = res.img;
 
-			if (! img)
-			{
-				img = &inst.wad.images.IM_UnknownTex(inst.conf);
+			if (res.how == ImageResolve::missing)
+				fullbright = config::render_missing_bright;
+			else if (res.how == ImageResolve::unknown)
 				fullbright = config::render_unknown_bright;
-			}
 
 			return;
 		}
@@ -174,7 +299,7 @@ public:
 		if (inst.r_view.lighting)
 			col = static_cast<img_pixel_t>(inst.conf.miscInfo.wall_colors[1]);
 		else
-			col = static_cast<img_pixel_t>(HashedPalColor(tname, inst.conf.miscInfo.wall_colors));
+			col = static_cast<img_pixel_t>(HashedPalColor(BA_GetString(tname), inst.conf.miscInfo.wall_colors));
 	}
 };
 
@@ -222,6 +347,9 @@ public:
 	// for sprites, the remembered open space to clip to
 	int oy1, oy2;
 
+	// position in the (sorted) walls list, for the picking buffer
+	int pick_index;
+
 	/* surfaces */
 
 	DrawSurf ceil;
@@ -239,8 +367,14 @@ public:
 	// than the given wall (wall B).
 	//
 	// Note that it is NOT suitable as a predicate for std::sort()
-	// since it does not guarantee a linear order (total order) of
-	// the elements.  Hence the need for our own sorting code.
+	// since the shared vertex test below is not transitive, so it does
+	// not guarantee a linear order (total order) of the elements.
+	// Hence the need for our own sorting code.
+	//
+	// It is however asymmetric, and walls at the same depth are ordered
+	// by their index in the walls list, so the result does not depend on
+	// the order the active list happened to be in (e.g. when a strip of
+	// the screen starts with a freshly seeded list).
 
 	inline bool IsCloser(const DrawWall *const B) const
 	{
@@ -256,32 +390,17 @@ public:
 
 			// if they do share a vertex, we check if the other vertex of
 			// wall A and the camera position are both on the same side of
-			// wall B (extended to infinity).
+			// wall B (extended to infinity), and vice versa.  Only when
+			// the two tests agree is the answer used.
 
-			int A_other = -1;
+			Side A_closer = A->SharedVertexSide(B);
 
-			if (B->ld->TouchesVertex(A->ld->start))
-				A_other = A->ld->end;
-			else if (B->ld->TouchesVertex(A->ld->end))
-				A_other = A->ld->start;
-
-			if (A_other >= 0)
+			if (A_closer != Side::neither)
 			{
-				int ax = static_cast<int>(inst.level.vertices[A_other]->x());
-				int ay = static_cast<int>(inst.level.vertices[A_other]->y());
-
-				int bx1 = static_cast<int>(inst.level.getStart(*B->ld).x());
-				int by1 = static_cast<int>(inst.level.getStart(*B->ld).y());
-				int bx2 = static_cast<int>(inst.level.getEnd(*B->ld).x());
-				int by2 = static_cast<int>(inst.level.getEnd(*B->ld).y());
-
-				int cx = (int)inst.r_view.x;  // camera
-				int cy = (int)inst.r_view.y;
+				Side B_closer = B->SharedVertexSide(A);
 
-				Side A_side = PointOnLineSide(ax, ay, bx1, by1, bx2, by2);
-				Side C_side = PointOnLineSide(cx, cy, bx1, by1, bx2, by2);
-
-				return (A_side * C_side != Side::left);
+				if (B_closer != Side::neither && B_closer != A_closer)
+					return (A_closer == Side::right);
 			}
 		}
 		else if (A->th >= 0 && B->th >= 0)
@@ -294,7 +413,58 @@ public:
 				return A->th > B->th;
 		}
 
-		return A->cur_iz > B->cur_iz;
+		if (A->cur_iz != B->cur_iz)
+			return A->cur_iz > B->cur_iz;
+
+		return A->pick_index < B->pick_index;
+	}
+
+	// when THIS wall and the given one share a vertex, returns
+	// Side::right if the other vertex of this wall is on the same side
+	// of wall B as the camera, Side::left if it is on the opposite side.
+	// Returns Side::neither when nothing is shared or either point lies
+	// on wall B (extended to infinity).
+	inline Side SharedVertexSide(const DrawWall *const B) const
+	{
+		int A_other = -1;
+
+		if (B->ld->TouchesVertex(ld->start))
+			A_other = ld->end;
+		else if (B->ld->TouchesVertex(ld->end))
+			A_other = ld->start;
+
+		if (A_other < 0)
+			return Side::neither;
+
+		int ax = static_cast<int>(inst.level.vertices[A_other]->x());
+		int ay = static_cast<int>(inst.level.vertices[A_other]->y());
+
+		int bx1 = static_cast<int>(inst.level.getStart(*B->ld).x());
+		int by1 = static_cast<int>(inst.level.getStart(*B->ld).y());
+		int bx2 = static_cast<int>(inst.level.getEnd(*B->ld).x());
+		int by2 = static_cast<int>(inst.level.getEnd(*B->ld).y());
+
+		int cx = (int)inst.r_view.x;  // camera
+		int cy = (int)inst.r_view.y;
+
+		Side A_side = PointOnLineSide(ax, ay, bx1, by1, bx2, by2);
+		Side C_side = PointOnLineSide(cx, cy, bx1, by1, bx2, by2);
+
+		return A_side * C_side;
+	}
+
+	// a fixed order for walls which otherwise compare equal, so the
+	// sorts below give the same result whatever order the walls were
+	// added in.
+	inline bool IsBefore(const DrawWall *const B) const
+	{
+		if (th != B->th)
+			return th < B->th;
+
+		if (ld_index != B->ld_index)
+			return ld_index < B->ld_index;
+
+		return side < B->side;
 	}
 
 	/* PREDICATES */
@@ -303,7 +473,10 @@ public:
 	{
 		inline bool operator() (const DrawWall * A, const DrawWall * B) const
 		{
-			return A->mid_iz > B->mid_iz;
+			if (A->mid_iz != B->mid_iz)
+				return A->mid_iz > B->mid_iz;
+
+			return A->IsBefore(B);
 		}
 	};
 
@@ -311,7 +484,10 @@ public:
 	{
 		inline bool operator() (const DrawWall * A, const DrawWall * B) const
 		{
-			return A->sx1 < B->sx1;
+			if (A->sx1 != B->sx1)
+				return A->sx1 < B->sx1;
+
+			return A->IsBefore(B);
 		}
 
 		inline bool operator() (const DrawWall * A, int x) const
@@ -402,10 +578,13 @@ public:
 			}
 		}
 
-		bool sky_upper = back && inst.is_sky(front->CeilTex()) && inst.is_sky(back->CeilTex());
+		ImageSet &images = inst.wad.images;
+
+		bool sky_front = images.isSkyFlat(inst.conf, front->ceil_tex);
+		bool sky_upper = back && sky_front && images.isSkyFlat(inst.conf, back->ceil_tex);
 		bool self_ref  = (front == back) ? true : false;
 
-		if ((front->ceilh > inst.r_view.z || inst.is_sky(front->CeilTex()))
+		if ((front->ceilh > inst.r_view.z || sky_front)
 		    && ! sky_upper && ! self_ref)
 		{
 			ceil.kind = DrawSurf::K_FLAT;
@@ -414,7 +593,7 @@ public:
 			ceil.tex_h = ceil.h1;
 			ceil.y_clip = DrawSurf::SOLID_ABOVE;
 
-			ceil.FindFlat(front->CeilTex());
+			ceil.FindFlat(front->ceil_tex);
 		}
 
 		if (front->floorh < inst.r_view.z && ! self_ref)
@@ -425,7 +604,7 @@ public:
 			floor.tex_h = floor.h2;
 			floor.y_clip = DrawSurf::SOLID_BELOW;
 
-			floor.FindFlat(front->FloorTex());
+			floor.FindFlat(front->floor_tex);
 		}
 
 		if (! back)
@@ -437,7 +616,7 @@ public:
 			lower.h2 = front->ceilh;
 			lower.y_clip = DrawSurf::SOLID_ABOVE | DrawSurf::SOLID_BELOW;
 
-			lower.FindTex(sd->MidTex(), ld);
+			lower.FindTex(sd->mid_tex, ld);
 
 			if (lower.img && (ld->flags & MLF_LowerUnpegged))
 				lower.tex_h = lower.h1 + lower.img->height();
@@ -457,7 +636,7 @@ public:
 			upper.h2 = front->ceilh;
 			upper.y_clip = DrawSurf::SOLID_ABOVE;
 
-			upper.FindTex(sd->UpperTex(), ld);
+			upper.FindTex(sd->upper_tex, ld);
 
 			if (upper.img && ! (ld->flags & MLF_UpperUnpegged))
 				upper.tex_h = upper.h1 + upper.img->height();
@@ -474,7 +653,7 @@ public:
 			lower.h2 = back->floorh;
 			lower.y_clip = DrawSurf::SOLID_BELOW;
 
-			lower.FindTex(sd->LowerTex(), ld);
+			lower.FindTex(sd->lower_tex, ld);
 
 			// note "sky_upper" here, needed to match original DOOM behavior
 			if (ld->flags & MLF_LowerUnpegged)
@@ -490,10 +669,10 @@ public:
 		if (! inst.r_view.texturing)
 			return;
 
-		if (is_null_tex(sd->MidTex()))
+		if (images.resolveTexture(inst.conf, inst.wad.palette, sd->mid_tex).how == ImageResolve::missing)
 			return;
 
-		rail.FindTex(sd->MidTex(), ld);
+		rail.FindTex(sd->mid_tex, ld);
 		if (! rail.img)
 			return;
 
@@ -543,6 +722,41 @@ public:
 };
 
 
+//
+// Storage for the walls and sprites of a frame.  New walls are built in
+// place over the ones of earlier frames, so once the arena has grown to
+// fit the view, rendering does no heap allocation for them.
+//
+class DrawWallArena
+{
+private:
+	std::deque<std::optional<DrawWall>> pool;
+	size_t used = 0;
+
+public:
+	template <typename... Args>
+	DrawWall *New(Args &&... args)
+	{
+		if (used == pool.size())
+			pool.emplace_back();
+
+		return &pool[used++].emplace(std::forward<Args>(args)...);
+	}
+
+	// forget all walls, keeping the memory for the next frame
+	void Reset()
+	{
+		used = 0;
+	}
+};
+
+
+// the columns are split into more strips than there are threads, since
+// some parts of the view (e.g. open areas with many sprites) cost more
+// than others.
+static const int STRIPS_PER_THREAD = 4;
+static const int MIN_STRIP_WIDTH   = 16;
+
 struct RendInfo
 {
 public:
@@ -550,9 +764,15 @@ public:
 	DrawWall::vec_t walls;
 
 	// the active list.  Pointers here are always duplicates of ones in
-	// the walls list (no need to 'delete' any of them).
+	// the walls list.
 	DrawWall::vec_t active;
 
+	// owns everything in the walls list
+	DrawWallArena arena;
+
+	// renderers of the parallel strips, kept for reusing their memory
+	std::vector<std::unique_ptr<RendInfo>> strip_rends;
+
 	// query state
 	int query_mode;  // 0 for normal render
 	int query_sx;
@@ -566,6 +786,43 @@ public:
 	// inverse distances over X range, 0 when empty.
 	std::vector<double> depth_x;
 
+	// what the mouse would hit at each pixel of the last frame, so that
+	// queries don't need to render again.  Values are pick_index of the
+	// walls (-1 for nothing).  Stored column by column.
+	//
+	// Sprites and mid-masked railings are drawn back to front, so they
+	// share one entry which the nearest one pickable in the current
+	// edit mode ends up in.
+	struct PickPixel
+	{
+		int surf;
+		ObjType surf_type;	// of the surface: sectors or linedefs
+		byte surf_part;		// PART_XXX
+		int masked;
+		ObjType masked_type;	// things (sprite) or linedefs (railing)
+	};
+	std::vector<PickPixel> pick_pixels;
+
+	// where to write, shared with the strip renderers (NULL for none)
+	PickPixel *pick_buf = nullptr;
+
+	// only fill the picking buffer, nothing is drawn
+	bool pick_only = false;
+
+	// what the picking buffer was rendered with
+	struct PickKey
+	{
+		unsigned map_revision = 0;
+		double x = 0, y = 0, z = 0, angle = 0;
+		int screen_w = 0, screen_h = 0;
+		bool sprites = false;
+		ObjType mode = ObjType::things;
+
+		bool operator== (const PickKey &other) const = default;
+	};
+	PickKey pick_key;
+	bool pick_valid = false;
+
 	// vertical clip window, an inclusive range
 	int open_y1;
 	int open_y2;
@@ -577,12 +834,6 @@ public:
 
 	Instance &inst;
 
-private:
-	static void DeleteWall(DrawWall *P)
-	{
-		delete P;
-	}
-
 public:
 	explicit RendInfo(Instance &inst) :
 		walls(), active(),
@@ -590,12 +841,12 @@ public:
 		depth_x(), open_y1(), open_y2(), inst(inst)
 	{ }
 
-	~RendInfo()
+	// drops the walls of the previous frame
+	void Reset()
 	{
-		std::for_each(walls.begin(), walls.end(), DeleteWall);
-
-		walls.clear ();
-		active.clear ();
+		walls.clear();
+		active.clear();
+		arena.Reset();
 	}
 
 	void InitDepthBuf (int width)
@@ -832,7 +1083,7 @@ public:
 
 		// create drawwall structure
 
-		DrawWall *dw = new DrawWall(inst);
+		DrawWall *dw = arena.New(inst);
 
 		dw->th = -1;
 		dw->ld = ld.get();
@@ -868,6 +1119,164 @@ public:
 		walls.push_back(dw);
 	}
 
+	//
+	// Whether any part of a map box is inside the 90 degree view.
+	//
+	bool BoxInView(double x1, double y1, double x2, double y2) const
+	{
+		int left_out  = 0;
+		int right_out = 0;
+
+		for (int k = 0 ; k < 4 ; k++)
+		{
+			double dx = ((k & 1) ? x2 : x1) - inst.r_view.x;
+			double dy = ((k & 2) ? y2 : y1) - inst.r_view.y;
+
+			double tx = dx * inst.r_view.Sin - dy * inst.r_view.Cos;
+			double ty = dx * inst.r_view.Cos + dy * inst.r_view.Sin;
+
+			if (tx > ty)
+				right_out++;
+
+			if (-tx > ty)
+				left_out++;
+		}
+
+		return left_out < 4 && right_out < 4;
+	}
+
+	//
+	// Adds the linedefs by walking the line grid in square rings around
+	// the camera, closest first.  One-sided walls are entered into the
+	// depth buffer as we go, and once they cover every column, the walk
+	// stops at the first ring which is entirely behind them.  Hence the
+	// cost depends on what is visible rather than the size of the map.
+	//
+	void AddVisibleLines()
+	{
+		Render_LineGrid_t &grid = inst.r_view.line_grid;
+
+		if (! grid.valid || grid.revision != inst.map_revision ||
+			grid.line_visit.size() != static_cast<size_t>(inst.level.numLinedefs()))
+		{
+			BuildLineGrid(inst);
+		}
+
+		if (grid.w == 0)
+			return;
+
+		if (++grid.frame == 0)
+		{
+			std::fill(grid.line_visit.begin(), grid.line_visit.end(), 0);
+			grid.frame = 1;
+		}
+
+		// the columns which matter (only one in query mode)
+		int col1 = query_mode ? query_sx : 0;
+		int col2 = query_mode ? query_sx : inst.r_view.screen_w - 1;
+
+		if (col1 < 0 || col2 >= inst.r_view.screen_w || col1 > col2)
+			return;
+
+		int covered = 0;
+
+		int cam_cx = static_cast<int>(floor((inst.r_view.x - grid.x0) / grid.cell_size));
+		int cam_cy = static_cast<int>(floor((inst.r_view.y - grid.y0) / grid.cell_size));
+
+		// rings which contain any cells (the camera may be outside the grid)
+		int min_ring = std::max(std::max(0, std::max(-cam_cx, cam_cx - (grid.w - 1))),
+								std::max(0, std::max(-cam_cy, cam_cy - (grid.h - 1))));
+
+		int max_ring = std::max(std::max(abs(cam_cx), abs(grid.w - 1 - cam_cx)),
+								std::max(abs(cam_cy), abs(grid.h - 1 - cam_cy)));
+
+		for (int ring = min_ring ; ring <= max_ring ; ring++)
+		{
+			// any point in the view has a depth of at least its distance
+			// divided by sqrt(2), and cells of this ring are at least
+			// (ring - 1) cells away.
+			if (covered > col2 - col1 && ring >= 2)
+			{
+				double far_iz = *std::min_element(depth_x.begin() + col1, depth_x.begin() + col2 + 1);
+				double near_depth = (ring - 1) * grid.cell_size * M_SQRT1_2;
+
+				if (near_depth * far_iz > 1.0)
+					break;
+			}
+
+			size_t first_wall = walls.size();
+
+			int cy1 = std::max(cam_cy - ring, 0);
+			int cy2 = std::min(cam_cy + ring, grid.h - 1);
+
+			for (int cy = cy1 ; cy <= cy2 ; cy++)
+			{
+				// only the edge of the square, except on its top and bottom rows
+				int step = (cy == cam_cy - ring || cy == cam_cy + ring) ? 1 : std::max(1, 2 * ring);
+
+				for (int cx = cam_cx - ring ; cx <= cam_cx + ring ; cx += step)
+				{
+					if (cx < 0)
+					{
+						// skip ahead to the grid
+						if (step == 1)
+							cx = -1;
+						continue;
+					}
+
+					if (cx >= grid.w)
+						break;
+
+					double bx = grid.x0 + cx * static_cast<double>(grid.cell_size);
+					double by = grid.y0 + cy * static_cast<double>(grid.cell_size);
+
+					if (! BoxInView(bx, by, bx + grid.cell_size, by + grid.cell_size))
+						continue;
+
+					size_t cell = static_cast<size_t>(cy) * grid.w + cx;
+
+					for (int i = grid.start[cell] ; i < grid.start[cell + 1] ; i++)
+					{
+						int ld_index = grid.lines[i];
+
+						if (grid.line_visit[ld_index] == grid.frame)
+							continue;
+
+						grid.line_visit[ld_index] = grid.frame;
+
+						AddLine(ld_index);
+					}
+				}
+			}
+
+			// one-sided walls hide everything behind them
+			for (size_t i = first_wall ; i < walls.size() ; i++)
+			{
+				const DrawWall *dw = walls[i];
+
+				if (inst.level.getLeft(*dw->ld))
+					continue;
+
+				int x1 = std::max(dw->sx1, col1);
+				int x2 = std::min(dw->sx2, col2);
+
+				for (int x = x1 ; x <= x2 ; x++)
+				{
+					double iz = dw->iz1 + (dw->diz * (x - dw->sx1));
+
+					if (iz <= 0)
+						continue;
+
+					if (depth_x[x] == 0)
+						covered++;
+
+					if (iz > depth_x[x])
+						depth_x[x] = iz;
+				}
+			}
+		}
+	}
+
 	void AddThing(int th_index)
 	{
 		const auto th = inst.level.things[th_index];
@@ -953,7 +1362,7 @@ public:
 
 		// create drawwall structure
 
-		DrawWall *dw = new DrawWall(inst);
+		DrawWall *dw = arena.New(inst);
 
 		dw->th  = th_index;
 		dw->ld_index = -1;
@@ -1026,6 +1435,98 @@ public:
 			query_map_x = 0.01f;
 	}
 
+	void QueryWallSurface(const DrawWall *dw, ObjType what, int part)
+	{
+		if (what == ObjType::linedefs)
+		{
+			if (dw->side == Side::left)
+				part <<= 4;
+
+			query_result = Objid(what, dw->ld_index, part);
+		}
+		else if (dw->sd != NULL)
+		{
+			query_result = Objid(what, dw->sd->sector, part);
+		}
+
+		QueryCalcCoord(dw, what, part);
+	}
+
+	void QuerySprite(const DrawWall *dw)
+	{
+		if (inst.edit.mode == ObjType::things)
+			query_result = Objid(ObjType::things, dw->th);
+	}
+
+	void QueryMidMasker(const DrawWall *dw)
+	{
+		if (inst.edit.mode == ObjType::linedefs)
+		{
+			int part = (dw->side == Side::left) ? PART_LF_RAIL : PART_RT_RAIL;
+			query_result = Objid(ObjType::linedefs, dw->ld_index, part);
+		}
+	}
+
+	PickKey CurrentPickKey() const
+	{
+		PickKey key;
+
+		key.map_revision = inst.map_revision;
+		key.x = inst.r_view.x;
+		key.y = inst.r_view.y;
+		key.z = inst.r_view.z;
+		key.angle = inst.r_view.angle;
+		key.screen_w = inst.r_view.screen_w;
+		key.screen_h = inst.r_view.screen_h;
+		key.sprites = inst.r_view.sprites;
+		key.mode = inst.edit.mode;
+
+		return key;
+	}
+
+	//
+	// Answers a query from the picking buffer of the last frame, giving
+	// the same result as Query() would.  Returns false when the view or
+	// the map has changed since that frame.
+	//
+	bool Pick(int qx, int qy)
+	{
+		if (! pick_valid || ! (pick_key == CurrentPickKey()))
+			return false;
+
+		query_result.clear();
+		query_map_x = 0;
+		query_map_y = 0;
+		query_map_z = 0;
+
+		if (qx < 0 || qx >= inst.r_view.screen_w || qy < 0 || qy >= inst.r_view.screen_h)
+			return true;
+
+		query_sx = qx;
+		query_sy = qy;
+
+		const PickPixel &pick = pick_pixels[qx * inst.r_view.screen_h + qy];
+
+		if (pick.surf >= 0)
+		{
+			DrawWall *dw = walls[pick.surf];
+
+			dw->cur_iz = dw->iz1 + dw->diz * (qx - dw->sx1);
+
+			QueryWallSurface(dw, pick.surf_type, pick.surf_part);
+		}
+
+		if (pick.masked >= 0)
+		{
+			if (pick.masked_type == ObjType::things)
+				QuerySprite(walls[pick.masked]);
+			else
+				QueryMidMasker(walls[pick.masked]);
+		}
+
+		return true;
+	}
+
 	void HighlightWallBit(const DrawWall *dw, int ld_index, int part)
 	{
 		// check the part is on the side facing the camera
@@ -1423,10 +1924,7 @@ public:
 			}
 
 			if (vis_count == 0)
-			{
-				delete dw;
 				(*S) = NULL;
-			}
 		}
 
 		// remove null pointers
@@ -1455,6 +1953,10 @@ public:
 		dest += x + y1 * inst.r_view.screen_w;
 
 		int light = dw->sec->light;
+		bool lit = inst.r_view.lighting && ! surf.fullbright;
+
+		LightRemap remap;
+		int cur_map = -1;
 
 		for ( ; y1 <= y2 ; y1++, dest += inst.r_view.screen_w)
 		{
@@ -1465,8 +1967,18 @@ public:
 
 			*dest = src[ty * tw + tx];
 
-			if (inst.r_view.lighting && ! surf.fullbright)
-				*dest = DoomLightRemap(inst, light, dist, *dest);
+			if (lit)
+			{
+				int map = R_DoomLightingEquation(light, dist);
+
+				if (map != cur_map)
+				{
+					remap.Set(inst, map);
+					cur_map = map;
+				}
+
+				*dest = remap(*dest);
+			}
 		}
 	}
 
@@ -1480,9 +1992,11 @@ public:
 		int tw = surf.img->width();
 		int th = surf.img->height();
 
-		int  light = dw->wall_light;
+		bool lit = inst.r_view.lighting && ! surf.fullbright;
 		float dist = static_cast<float>(1.0 / dw->cur_iz);
 
+		LightRemap remap(inst, dw->wall_light, dist);
+
 		/* compute texture X coord */
 
 		float cur_ang = dw->delta_ang - XToAngle(x);
@@ -1514,10 +2028,7 @@ public:
 			if (pix == TRANS_PIXEL)
 				continue;
 
-			if (inst.r_view.lighting && ! surf.fullbright)
-				*dest = DoomLightRemap(inst, light, dist, pix);
-			else
-				*dest = pix;
+			*dest = lit ? remap(pix) : pix;
 		}
 	}
 
@@ -1534,7 +2045,7 @@ public:
 			float dist = YToDist(y1, surf.tex_h);
 
 			if (inst.r_view.lighting && ! surf.fullbright)
-				*dest = DoomLightRemap(inst, light, dist, surf.col);
+				*dest = LightRemap(inst, light, dist)(surf.col);
 			else
 				*dest = surf.col;
 		}
@@ -1542,20 +2053,19 @@ public:
 
 	void SolidTexColumn(DrawWall *dw, DrawSurf& surf, int x, int y1, int y2)
 	{
-		int  light = dw->wall_light;
 		float dist = static_cast<float>(1.0 / dw->cur_iz);
 
+		img_pixel_t col = surf.col;
+
+		if (inst.r_view.lighting && ! surf.fullbright)
+			col = LightRemap(inst, dw->wall_light, dist)(col);
+
 		img_pixel_t *dest = inst.r_view.screen;
 
 		dest += x + y1 * inst.r_view.screen_w;
 
 		for ( ; y1 <= y2 ; y1++, dest += inst.r_view.screen_w)
-		{
-			if (inst.r_view.lighting && ! surf.fullbright)
-				*dest = DoomLightRemap(inst, light, dist, surf.col);
-			else
-				*dest = surf.col;
-		}
+			*dest = col;
 	}
 
 	inline void RenderWallSurface(DrawWall *dw, DrawSurf& surf, int x, ObjType what, int part)
@@ -1588,22 +2098,23 @@ public:
 		if (query_mode)
 		{
 			if (y1 <= query_sy && query_sy <= y2)
-			{
-				if (what == ObjType::linedefs)
-				{
-					if (dw->side == Side::left)
-						part <<= 4;
+				QueryWallSurface(dw, what, part);
+			return;
+		}
 
-					query_result = Objid(what, dw->ld_index, part);
-				}
-				else if (dw->sd != NULL)
-				{
-					query_result = Objid(what, dw->sd->sector, part);
-				}
+		if (pick_buf)
+		{
+			PickPixel *pick = pick_buf + x * inst.r_view.screen_h;
 
-				QueryCalcCoord(dw, what, part);
+			for (int y = y1 ; y <= y2 ; y++)
+			{
+				pick[y].surf = dw->pick_index;
+				pick[y].surf_type = what;
+				pick[y].surf_part = static_cast<byte>(part);
 			}
-			return;
+
+			if (pick_only)
+				return;
 		}
 
 		/* fill pixels */
@@ -1627,6 +2138,22 @@ public:
 		}
 	}
 
+	// like the queries, only remembers what the edit mode can pick, so
+	// that e.g. a railing does not hide a sprite behind it in things mode.
+	inline void PickMasked(const DrawWall *dw, ObjType what, int x, int y1, int y2)
+	{
+		if (inst.edit.mode != what)
+			return;
+
+		PickPixel *pick = pick_buf + x * inst.r_view.screen_h;
+
+		for (int y = y1 ; y <= y2 ; y++)
+		{
+			pick[y].masked = dw->pick_index;
+			pick[y].masked_type = what;
+		}
+	}
+
 	inline void RenderSprite(DrawWall *dw, int x)
 	{
 		int y1 = DistToY(dw->cur_iz, dw->ceil.h2);
@@ -1643,13 +2170,19 @@ public:
 
 		if (query_mode)
 		{
-			if (y1 <= query_sy && query_sy <= y2 && inst.edit.mode == ObjType::things)
-			{
-				query_result = Objid(ObjType::things, dw->th);
-			}
+			if (y1 <= query_sy && query_sy <= y2)
+				QuerySprite(dw);
 			return;
 		}
 
+		if (pick_buf)
+		{
+			PickMasked(dw, ObjType::things, x, y1, y2);
+
+			if (pick_only)
+				return;
+		}
+
 		int tw = dw->ceil.img->width();
 		int th = dw->ceil.img->height();
 
@@ -1669,6 +2202,10 @@ public:
 		int light = inst.level.isSector(thsec) ? inst.level.sectors[thsec]->light : 255;
 		float dist = static_cast<float>(1.0 / dw->cur_iz);
 
+		bool lit = inst.r_view.lighting && ! (dw->thingFlags & THINGDEF_LIT);
+
+		LightRemap remap(inst, light, dist);
+
 		/* fill pixels */
 
 		img_pixel_t *dest = inst.r_view.screen;
@@ -1698,10 +2235,7 @@ public:
 				continue;
 			}
 
-			*dest = pix;
-
-			if (inst.r_view.lighting && ! (dw->thingFlags & THINGDEF_LIT))
-				*dest = DoomLightRemap(inst, light, dist, *dest);
+			*dest = lit ? remap(pix) : pix;
 		}
 	}
 
@@ -1727,14 +2261,19 @@ public:
 
 		if (query_mode)
 		{
-			if (y1 <= query_sy && query_sy <= y2 && inst.edit.mode == ObjType::linedefs)
-			{
-				int part = (dw->side == Side::left) ? PART_LF_RAIL : PART_RT_RAIL;
-				query_result = Objid(ObjType::linedefs, dw->ld_index, part);
-			}
+			if (y1 <= query_sy && query_sy <= y2)
+				QueryMidMasker(dw);
 			return;
 		}
 
+		if (pick_buf)
+		{
+			PickMasked(dw, ObjType::linedefs, x, y1, y2);
+
+			if (pick_only)
+				return;
+		}
+
 		/* fill pixels */
 
 		RenderTexColumn(dw, surf, x, y1, y2);
@@ -1931,15 +2470,30 @@ public:
 		}
 	}
 
-	void RenderWalls()
+	void RenderColumns(int x1, int x2)
 	{
-		// sort walls by their starting column, to allow binary search.
+		active.clear();
 
-		std::sort(walls.begin(), walls.end(), DrawWall::SX1Cmp());
+		// walls which began left of this range are already visible at x1
+		if (x1 > 0)
+		{
+			DrawWall::vec_t::iterator E = std::lower_bound(walls.begin(), walls.end(), x1, DrawWall::SX1Cmp());
 
-		active.clear();
+			for (DrawWall::vec_t::iterator S = walls.begin() ; S != E ; S++)
+			{
+				DrawWall *dw = (*S);
+
+				if (dw->sx2 >= x1)
+				{
+					dw->cur_iz = dw->iz1 + dw->diz * (x1 - dw->sx1);
+					active.push_back(dw);
+				}
+			}
+
+			SortActiveList();
+		}
 
-		for (int x=0 ; x < inst.r_view.screen_w ; x++)
+		for (int x = x1 ; x < x2 ; x++)
 		{
 			// clear vertical depth buffer
 
@@ -1952,6 +2506,13 @@ public:
 			if (query_mode && x != query_sx)
 				continue;
 
+			if (pick_buf)
+			{
+				PickPixel *pick = pick_buf + x * inst.r_view.screen_h;
+
+				std::fill_n(pick, inst.r_view.screen_h, PickPixel{ -1, ObjType::sectors, 0, -1, ObjType::things });
+			}
+
 			// render, front to back
 
 			int activeSize = (int)active.size();
@@ -1997,6 +2558,63 @@ public:
 		}
 	}
 
+	//
+	// Draws the columns from x1 to x2 (exclusive) on the calling thread.
+	// The walls keep their per-column state (depth, open space for sprites)
+	// in the DrawWall itself, so each strip works on its own copies of the
+	// walls it crosses, with its own active list and clip window.
+	//
+	void RenderStrip(RendInfo &strip, int x1, int x2) const
+	{
+		strip.Reset();
+		strip.pick_buf = pick_buf;
+		strip.pick_only = pick_only;
+
+		for (const DrawWall *dw : walls)
+		{
+			if (dw->sx1 >= x2)
+				break;
+
+			if (dw->sx2 >= x1)
+				strip.walls.push_back(strip.arena.New(*dw));
+		}
+
+		strip.RenderColumns(x1, x2);
+	}
+
+	void RenderWalls()
+	{
+		// sort walls by their starting column, to allow binary search.
+
+		std::sort(walls.begin(), walls.end(), DrawWall::SX1Cmp());
+
+		for (size_t i = 0 ; i < walls.size() ; i++)
+			walls[i]->pick_index = (int)i;
+
+		int screen_w = inst.r_view.screen_w;
+
+		// queries look at a single column and store their result here,
+		// so they always run serially.
+		int strips = 1;
+
+		if (! query_mode)
+			strips = std::min(ParallelThreadCount() * STRIPS_PER_THREAD, screen_w / MIN_STRIP_WIDTH);
+
+		if (strips <= 1)
+		{
+			RenderColumns(0, screen_w);
+			return;
+		}
+
+		while ((int)strip_rends.size() < strips)
+			strip_rends.push_back(std::make_unique<RendInfo>(inst));
+
+		ParallelFor(strips, [this, screen_w, strips](int n)
+		{
+			RenderStrip(*strip_rends[n], screen_w * n / strips, screen_w * (n + 1) / strips);
+		});
+	}
+
 	void ClearScreen()
 	{
 		// color #0 is black (DOOM, Heretic, Hexen)
@@ -2010,13 +2628,24 @@ public:
 
 	void Render()
 	{
+		Reset();
+
+		// a query renders over the walls which the buffer refers to
+		pick_valid = false;
+		pick_buf = nullptr;
+
 		if (! query_mode)
-			ClearScreen();
+		{
+			if (! pick_only)
+				ClearScreen();
+
+			pick_pixels.resize(static_cast<size_t>(inst.r_view.screen_w) * inst.r_view.screen_h);
+			pick_buf = pick_pixels.data();
+		}
 
 		InitDepthBuf(inst.r_view.screen_w);
 
-		for (int i=0 ; i < inst.level.numLinedefs(); i++)
-			AddLine(i);
+		AddVisibleLines();
 
 		if (inst.r_view.sprites)
 			for (int k=0 ; k < inst.level.numThings() ; k++)
@@ -2027,6 +2656,12 @@ public:
 		ComputeSurfaces();
 
 		RenderWalls();
+
+		if (! query_mode)
+		{
+			pick_key = CurrentPickKey();
+			pick_valid = true;
+		}
 	}
 
 	void Query(int qx, int qy)
@@ -2043,63 +2678,88 @@ public:
 
 		query_mode = 0;
 	}
+
+	//
+	// Fills the picking buffer for the current view without drawing
+	// anything, for views which do not come from Render() (OpenGL).
+	//
+	void RenderPicks()
+	{
+		pick_only = true;
+
+		Render();
+
+		pick_only = false;
+	}
 };
 
 
-static void BlitHires(const Instance &inst, int ox, int oy, int ow, int oh)
+//
+// The whole frame is converted into r_view.screen_rgb and handed to FLTK
+// with a single fl_draw_image() call.
+//
+static void BlitHires(Instance &inst, int ox, int oy, int ow, int oh)
 {
-	uint8_t *line_rgb = new uint8_t[inst.r_view.screen_w * 3];
+	int sw = inst.r_view.screen_w;
+	int sh = inst.r_view.screen_h;
 
-	for (int ry = 0 ; ry < inst.r_view.screen_h ; ry++)
-	{
-		uint8_t *dest = line_rgb;
-		uint8_t *dest_end = line_rgb + inst.r_view.screen_w * 3;
+	std::vector<byte> &rgb = inst.r_view.screen_rgb;
 
-		const img_pixel_t *src = inst.r_view.screen + ry * inst.r_view.screen_w;
+	rgb.resize(static_cast<size_t>(sw) * sh * 3);
 
-		for ( ; dest < dest_end  ; dest += 3, src++)
-		{
-			inst.wad.palette.decodePixel(*src, dest[0], dest[1], dest[2]);
-		}
+	inst.wad.palette.decodePixels(inst.r_view.screen, rgb.data(), sw * sh);
 
-		fl_draw_image(line_rgb, ox, oy+ry, inst.r_view.screen_w, 1);
-	}
-	delete[] line_rgb;
+	fl_draw_image(rgb.data(), ox, oy, sw, sh);
 }
 
 
-static void BlitLores(const Instance &inst, int ox, int oy, int ow, int oh)
+static void BlitLores(Instance &inst, int ox, int oy, int ow, int oh)
 {
-	// if destination width is odd, we store an extra pixel here
-	uint8_t *line_rgb = new uint8_t[(ow + 1) * 3];
+	int sw = inst.r_view.screen_w;
 
-	for (int ry = 0 ; ry < inst.r_view.screen_h ; ry++)
-	{
-		const img_pixel_t *src = inst.r_view.screen + ry * inst.r_view.screen_w;
+	// if destination width is odd, we store an extra pixel per row
+	// (the screen covers it), it just won't be drawn.
+	int stride = sw * 2 * 3;
 
-		uint8_t *dest = line_rgb;
-		uint8_t *dest_end = line_rgb + ow * 3;
+	std::vector<byte> &rgb = inst.r_view.screen_rgb;
 
-		for (; dest < dest_end ; dest += 6, src++)
-		{
-			inst.wad.palette.decodePixel(*src, dest[0], dest[1], dest[2]);
-			inst.wad.palette.decodePixel(*src, dest[3], dest[4], dest[5]);
-		}
+	rgb.resize(static_cast<size_t>(stride) * oh);
 
-		fl_draw_image(line_rgb, ox, oy + ry*2, ow, 1);
+	for (int dy = 0 ; dy < oh ; dy++)
+	{
+		byte *dest = rgb.data() + static_cast<size_t>(dy) * stride;
 
-		if (ry * 2 + 1 < oh)
+		// odd rows are a copy of the row above
+		if (dy & 1)
 		{
-			fl_draw_image(line_rgb, ox, oy + ry*2 + 1, ow, 1);
+			memcpy(dest, dest - stride, stride);
+			continue;
 		}
+
+		const img_pixel_t *src = inst.r_view.screen + (dy / 2) * sw;
+
+		inst.wad.palette.decodePixelsDoubled(src, dest, sw);
 	}
-	delete[] line_rgb;
+
+	fl_draw_image(rgb.data(), ox, oy, ow, oh, 3, stride);
+}
+
+
+//
+// The renderer is kept between frames (and queries) to reuse its memory.
+//
+static RendInfo &SW_Renderer(Instance &inst)
+{
+	if (! inst.r_view.sw_renderer)
+		inst.r_view.sw_renderer = std::make_shared<RendInfo>(inst);
+
+	return *inst.r_view.sw_renderer;
 }
 
 
 void Instance::SW_RenderWorld(int ox, int oy, int ow, int oh)
 {
-	RendInfo rend(*this);
+	RendInfo &rend = SW_Renderer(*this);
 
 	fl_push_clip(ox, oy, ow, oh);
 
@@ -2124,10 +2784,22 @@ bool Instance::SW_QueryPoint(Objid& hl, int qx, int qy)
 		qy = qy / 2;
 	}
 
-	RendInfo rend(*this);
+	RendInfo &rend = SW_Renderer(*this);
 
-	// this runs the renderer, but *no* drawing is done
-	rend.Query(qx, qy);
+	// use what the last frame drew when possible.  When the view has
+	// changed since (or was drawn by OpenGL), the picking buffer is
+	// filled again so that further queries of this view are cheap.
+	// [ dragging changes what is drawn without changing the map, so
+	//   that runs the renderer for the single column instead ]
+	if (edit.action == EditorAction::drag)
+	{
+		rend.Query(qx, qy);
+	}
+	else if (! rend.Pick(qx, qy))
+	{
+		rend.RenderPicks();
+		rend.Pick(qx, qy);
+	}
 
 	if (rend.query_map_x != 0)
 	{
@@ -149,36 +149,37 @@ struct sector_edge_t
 //
 void sector_info_cache_c::Update()
 {
-   if (total != inst.level.numSectors())
-   {
-	   total = inst.level.numSectors();
+	if (total != inst.level.numSectors() ||
+		line_sectors.size() != (size_t)inst.level.numLinedefs())
+	{
+		total = inst.level.numSectors();
+
+		infos.resize((size_t) total);
+
+		Rebuild();
+		return;
+	}
 
-	   infos.resize((size_t) total);
+	if (sides_changed || !dirty_vertices.empty() || !dirty_lines.empty())
+		UpdateGeometry();
 
-	   Rebuild();
-   }
+	if (floors_changed || !dirty_sectors.empty())
+		UpdateFloors();
 }
 
 void sector_info_cache_c::Rebuild()
 {
-	int sec;
+	for (sector_extra_info_t &info : infos)
+		info.ClearGeometry();
 
-	for (sec = 0 ; sec < total ; sec++)
-	{
-		const auto S = inst.level.sectors[sec];
-
-		infos[sec].Clear();
-		infos[sec].floors.f_plane.Init(static_cast<float>(S->floorh));
-		infos[sec].floors.c_plane.Init(static_cast<float>(S->ceilh));
-	}
+	line_sectors.resize((size_t)inst.level.numLinedefs());
 
 	for (int n = 0 ; n < inst.level.numLinedefs(); n++)
 	{
 		const auto L = inst.level.linedefs[n];
 
-		CheckBoom242(*L.get(), n);
-		CheckExtraFloor(L.get(), n);
-		CheckLineSlope(L.get());
+		line_sectors[n] = { inst.level.getSectorID(*L, Side::right),
+							inst.level.getSectorID(*L, Side::left) };
 
 		for (int side = 0 ; side < 2 ; side++)
 		{
@@ -186,7 +187,7 @@ void sector_info_cache_c::Rebuild()
 			if (sd_num < 0)
 				continue;
 
-			sec = inst.level.sidedefs[sd_num]->sector;
+			int sec = inst.level.sidedefs[sd_num]->sector;
 
 			sector_extra_info_t& info = infos[sec];
 
@@ -197,19 +198,236 @@ void sector_info_cache_c::Rebuild()
 		}
 	}
 
-	for (const auto &thing : inst.level.things)
+	dirty_vertices.clear();
+	dirty_lines.clear();
+	sides_changed = false;
+
+	RescanFloors();
+}
+
+//
+// Finds the sectors affected by the pending vertex and linedef changes,
+// and recomputes the line range and bounds of only those. Their polygons
+// get rebuilt lazily, like after a full rebuild.
+//
+void sector_info_cache_c::UpdateGeometry()
+{
+	std::vector<char> moved_verts((size_t)inst.level.numVertices(), 0);
+	std::vector<char> moved_lines(line_sectors.size(), 0);
+	std::vector<char> changed((size_t)total, 0);
+
+	for (int v : dirty_vertices)
+		if (v < inst.level.numVertices())
+			moved_verts[v] = 1;
+
+	for (int ld : dirty_lines)
+		if (ld < (int)moved_lines.size())
+			moved_lines[ld] = 1;
+
+	auto mark = [this, &changed](int sec)
+	{
+		if (sec >= 0 && sec < total)
+			changed[sec] = 1;
+	};
+
+	for (int n = 0 ; n < inst.level.numLinedefs(); n++)
+	{
+		const auto L = inst.level.linedefs[n];
+
+		std::pair<int, int> secs = { inst.level.getSectorID(*L, Side::right),
+									 inst.level.getSectorID(*L, Side::left) };
+
+		bool moved = moved_lines[n] || moved_verts[L->start] || moved_verts[L->end];
+
+		if (secs != line_sectors[n])
+		{
+			// both the sectors which lost the line and which gained it
+			mark(line_sectors[n].first);
+			mark(line_sectors[n].second);
+
+			line_sectors[n] = secs;
+			moved = true;
+		}
+
+		if (moved)
+		{
+			mark(secs.first);
+			mark(secs.second);
+		}
+	}
+
+	dirty_vertices.clear();
+	dirty_lines.clear();
+	sides_changed = false;
+
+	bool any = false;
+
+	for (int sec = 0 ; sec < total ; sec++)
+	{
+		if (changed[sec])
+		{
+			infos[sec].ClearGeometry();
+			dirty_sectors.push_back(sec);
+			any = true;
+		}
+	}
+
+	if (! any)
+		return;
+
+	for (int n = 0 ; n < inst.level.numLinedefs(); n++)
+	{
+		for (int sec : { line_sectors[n].first, line_sectors[n].second })
+		{
+			if (sec < 0 || sec >= total || ! changed[sec])
+				continue;
+
+			const auto L = inst.level.linedefs[n];
+
+			sector_extra_info_t& info = infos[sec];
+
+			info.AddLine(n);
+
+			info.AddVertex(&inst.level.getStart(*L));
+			info.AddVertex(&inst.level.getEnd(*L));
+		}
+	}
+}
+
+//
+// Without any slope or 3D floor specials, the planes of a sector only
+// depend on its own heights. Otherwise the specials are applied again
+// (but the level isn't scanned for them).
+//
+void sector_info_cache_c::UpdateFloors()
+{
+	if (floors_changed)
+	{
+		RescanFloors();
+		return;
+	}
+
+	if (special_lines.empty() && special_things.empty())
+	{
+		for (int sec : dirty_sectors)
+		{
+			if (sec >= total)
+				continue;
+
+			const auto S = inst.level.sectors[sec];
+
+			infos[sec].floors.Clear();
+			infos[sec].floors.f_plane.Init(static_cast<float>(S->floorh));
+			infos[sec].floors.c_plane.Init(static_cast<float>(S->ceilh));
+		}
+	}
+	else
+	{
+		ApplyFloors();
+	}
+
+	dirty_sectors.clear();
+}
+
+void sector_info_cache_c::RescanFloors()
+{
+	special_lines.clear();
+	special_things.clear();
+
+	for (int n = 0 ; n < inst.level.numLinedefs(); n++)
 	{
-		CheckSlopeThing(thing.get());
+		const linetype_t &type = inst.conf.getLineType(inst.level.linedefs[n]->type);
+		const auto *simpleInfo = std::get_if<linetype_t::SimpleInfo>(&type.specialHandling);
+
+		if (! simpleInfo || *simpleInfo != linetype_t::SimpleInfo::none)
+			special_lines.push_back(n);
 	}
-	for (const auto &thing : inst.level.things)
+
+	for (int n = 0 ; n < inst.level.numThings(); n++)
 	{
-		CheckSlopeCopyThing(thing.get());
+		if (Subdiv_IsSlopeThing(inst.level.things[n]->type))
+			special_things.push_back(n);
 	}
 
-	for (const auto &linedef : inst.level.linedefs)
+	ApplyFloors();
+
+	floors_changed = false;
+	dirty_sectors.clear();
+}
+
+void sector_info_cache_c::ApplyFloors()
+{
+	for (int sec = 0 ; sec < total ; sec++)
 	{
-		CheckPlaneCopy(linedef.get());
+		const auto S = inst.level.sectors[sec];
+
+		infos[sec].floors.Clear();
+		infos[sec].floors.f_plane.Init(static_cast<float>(S->floorh));
+		infos[sec].floors.c_plane.Init(static_cast<float>(S->ceilh));
 	}
+
+	for (int n : special_lines)
+	{
+		const auto L = inst.level.linedefs[n];
+
+		CheckBoom242(*L.get(), n);
+		CheckExtraFloor(L.get(), n);
+		CheckLineSlope(L.get());
+	}
+
+	for (int n : special_things)
+	{
+		CheckSlopeThing(inst.level.things[n].get());
+	}
+	for (int n : special_things)
+	{
+		CheckSlopeCopyThing(inst.level.things[n].get());
+	}
+
+	for (int n : special_lines)
+	{
+		CheckPlaneCopy(inst.level.linedefs[n].get());
+	}
+}
+
+bool Subdiv_IsSlopeThing(int type)
+{
+	switch (type)
+	{
+	case 9502: case 9503:
+	case 9510: case 9511:
+		return true;
+	default:
+		return false;
+	}
+}
+
+void sector_info_cache_c::InvalidateVertex(int vert)
+{
+	dirty_vertices.push_back(vert);
+}
+
+void sector_info_cache_c::InvalidateLineDef(int ld)
+{
+	dirty_lines.push_back(ld);
+}
+
+void sector_info_cache_c::InvalidateSector(int sec)
+{
+	dirty_sectors.push_back(sec);
+}
+
+void sector_info_cache_c::InvalidateThing(int th)
+{
+	// a thing which is, or was, a slope thing
+	if (th < inst.level.numThings() && Subdiv_IsSlopeThing(inst.level.things[th]->type))
+	{
+		floors_changed = true;
+		return;
+	}
+
+	if (std::find(special_things.begin(), special_things.end(), th) != special_things.end())
+		floors_changed = true;
 }
 
 void sector_info_cache_c::CheckBoom242(const LineDef &L, int ld_num)
@@ -811,7 +1029,14 @@ fprintf(stderr, "E1 @ x=%1.2f side=%d  |  E2 @ x=%1.2f side=%d\n",
 void Instance::Subdiv_InvalidateAll() noexcept
 {
 	// invalidate everything
-	sector_info_cache.total = -1;
+	sector_info_cache.InvalidateAll();
+
+	// the 2D view draws the sectors from this
+	map_revision++;
+
+	// so does the OpenGL 3D view, also with the images from the resources
+	r_view.gl_dirty.all = true;
+	r_view.gl_dirty.images = true;
 }
 
 
@@ -50,6 +50,9 @@ public:
 
 sector_subdivision_c *Subdiv_PolygonsForSector(Instance &inst, int num);
 
+// things which define a slope, or copy one, in Eternity and ZDoom
+bool Subdiv_IsSlopeThing(int type);
+
 
 class extrafloor_c
 {
@@ -146,6 +149,13 @@ struct sector_extra_info_t
 	bool built;
 
 	void Clear()
+	{
+		ClearGeometry();
+		floors.Clear();
+	}
+
+	// forget the lines, bounds and polygons, but keep the 3D floors
+	void ClearGeometry()
 	{
 		first_line = last_line = -1;
 
@@ -155,7 +165,6 @@ struct sector_extra_info_t
 		bound_y2 = -32767;
 
 		sub.Clear();
-		floors.Clear();
 
 		built = false;
 	}
@@ -189,14 +198,51 @@ public:
 	{
 		total = other.total;
 		infos = other.infos;
+		line_sectors = other.line_sectors;
+		dirty_vertices = other.dirty_vertices;
+		dirty_lines = other.dirty_lines;
+		dirty_sectors = other.dirty_sectors;
+		sides_changed = other.sides_changed;
+		floors_changed = other.floors_changed;
+		special_lines = other.special_lines;
+		special_things = other.special_things;
 		return *this;
 	}
 
 public:
 	void Update();
-	
+
+	//
+	// Edit notifications. Only the sectors touched by these get
+	// subdivided again on the next Update().
+	//
+	void InvalidateAll() noexcept
+	{
+		total = -1;
+	}
+	void InvalidateVertex(int vert);
+	void InvalidateLineDef(int ld);
+	void InvalidateSector(int sec);
+	void InvalidateThing(int th);
+
+	// some sidedef changed its sector, or some linedef its sidedefs
+	void InvalidateSides() noexcept
+	{
+		sides_changed = true;
+	}
+
+	// something which may define a slope or 3D floor changed
+	void InvalidateFloors() noexcept
+	{
+		floors_changed = true;
+	}
+
 private:
 	void Rebuild();
+	void UpdateGeometry();
+	void UpdateFloors();
+	void RescanFloors();
+	void ApplyFloors();
 	void CheckBoom242(const LineDef &L, int ld_num);
 	void CheckExtraFloor(const LineDef *L, int ld_num);
 	void CheckLineSlope(const LineDef *L);
@@ -212,6 +258,20 @@ private:
 					   double x2, double y2, double z2);
 
 	const Instance &inst;
+
+	// the right and left sector of each linedef, as of the last update
+	std::vector<std::pair<int, int>> line_sectors;
+
+	// pending changes since the last update
+	std::vector<int> dirty_vertices;
+	std::vector<int> dirty_lines;
+	std::vector<int> dirty_sectors;	// only their planes need updating
+	bool sides_changed = false;
+	bool floors_changed = false;
+
+	// the linedefs and things which may affect the planes of sectors
+	std::vector<int> special_lines;
+	std::vector<int> special_things;
 };
 
 #endif  /* __EUREKA_R_SUBDIV_H__ */
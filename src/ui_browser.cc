@@ -733,7 +733,7 @@ SString TidyLineDesc(const char *name)
 }
 
 
-void UI_Browser_Box::Populate_Images(BrowserMode imkind, const std::map<SString, Img_c> & img_list)
+void UI_Browser_Box::Populate_Images(BrowserMode imkind, const ImageMap & img_list)
 {
 	/* Note: the side-by-side packing is done in Filter() method */
 
@@ -743,18 +743,16 @@ void UI_Browser_Box::Populate_Images(BrowserMode imkind, const std::map<SString,
 	scroll->resize_horiz(false);
 	scroll->Line_size(98);
 
-	std::map<SString, Img_c>::const_iterator TI;
-
 	int cx = scroll->x() + SBAR_W;
 	int cy = scroll->y();
 
 	char full_desc[256];
 
-	for (TI = img_list.begin() ; TI != img_list.end() ; TI++)
+	for (const ImageMap::Entry *entry : img_list.sorted())
 	{
-		const SString &name = TI->first;
+		const SString &name = entry->name;
 
-		const Img_c &image = TI->second;
+		const Img_c &image = entry->img;
 
 		if ((false)) /* NO PICS */
 			snprintf(full_desc, sizeof(full_desc), "%-8s : %3dx%d", name.c_str(),
@@ -29,6 +29,7 @@
 class Browser_Button;
 class Fl_Check_Button;
 class Fl_Choice;
+class ImageMap;
 
 enum class BrowserMode
 {
@@ -159,7 +160,7 @@ private:
 
 	bool SearchMatch(Browser_Item *item) const;
 
-	void Populate_Images(BrowserMode imkind, const std::map<SString, Img_c> & img_list);
+	void Populate_Images(BrowserMode imkind, const ImageMap & img_list);
 	void Populate_Sprites();
 
 	void Populate_ThingTypes();
@@ -83,6 +83,10 @@ rgb_color_t config::normal_small_col = rgbMake(60, 60, 120);
 
 int config::highlight_line_info = (int)LINFO_Length;
 
+// below this zoom factor, object numbers, line info and the direction
+// ticks of lines are not drawn, and tiny objects become dots.
+static constexpr double LOD_SCALE = 0.25;
+
 
 int vertex_radius(double scale);
 
@@ -140,6 +144,12 @@ void UI_Canvas::draw()
 		// belongs to a context which was (probably) just deleted and
 		// hence refer to textures which no longer exist.
 		inst.wad.images.W_UnloadAllTextures();
+		RGL_ForgetContext(inst);
+
+		// same for the map layer
+		map_layer_tex = 0;
+		map_layer_tw = map_layer_th = 0;
+		map_layer_valid = false;
 	}
 
 #ifndef _WIN32	// TODO: #56: reenable this for Windows
@@ -321,13 +331,10 @@ int UI_Canvas::ApproxBoxSize(int mx1, int my1, int mx2, int my2)
 
 void UI_Canvas::DrawEverything()
 {
-	// setup for drawing sector numbers
-	if (inst.edit.show_object_numbers && inst.edit.mode == ObjType::sectors)
-	{
-		seen_sectors.clear_all();
-	}
+	DrawMapLayer();
 
-	DrawMap();
+	if (inst.grid.snaps() && config::grid_snap_indicator)
+		DrawSnapPoint();
 
 	DrawSelection(&*inst.edit.Selected);
 
@@ -417,6 +424,8 @@ void UI_Canvas::DrawEverything()
 //
 void UI_Canvas::DrawMap()
 {
+	lod_active = (inst.grid.getScale() < LOD_SCALE);
+
 	RenderColor(FL_BLACK);
 	RenderRect(xx, yy, w(), h());
 
@@ -443,9 +452,6 @@ void UI_Canvas::DrawMap()
 	if (inst.edit.mode != ObjType::things)
 		DrawThings();
 
-	if (inst.grid.snaps() && config::grid_snap_indicator)
-		DrawSnapPoint();
-
 	DrawLinedefs();
 
 	if (inst.edit.mode == ObjType::vertices)
@@ -467,6 +473,78 @@ void UI_Canvas::DrawMap()
 }
 
 
+//
+// draw the map from the cached layer, unless something shown in it has
+// changed since it was made
+//
+void UI_Canvas::DrawMapLayer()
+{
+	map_layer_key_t key = MapLayerKey();
+
+	if (map_layer_valid && key == map_layer_key)
+	{
+		RestoreMapLayer();
+		return;
+	}
+
+	// setup for drawing sector numbers
+	if (inst.edit.show_object_numbers && inst.edit.mode == ObjType::sectors)
+	{
+		seen_sectors.clear_all();
+	}
+
+	DrawMap();
+
+	SaveMapLayer();
+
+	map_layer_key = key;
+	map_layer_valid = true;
+}
+
+
+UI_Canvas::map_layer_key_t UI_Canvas::MapLayerKey()
+{
+	map_layer_key_t key;
+
+	key.w = w();
+	key.h = h();
+#ifndef NO_OPENGL
+	key.pixel_w = pixel_w();
+	key.pixel_h = pixel_h();
+#endif
+
+	key.orig_x = inst.grid.getOrig().x;
+	key.orig_y = inst.grid.getOrig().y;
+	key.scale = inst.grid.getScale();
+	key.step = inst.grid.getStep();
+	key.grid_shown = inst.grid.isShown();
+
+	key.mode = inst.edit.mode;
+	key.sector_render_mode = inst.edit.sector_render_mode;
+	key.thing_render_mode = inst.edit.thing_render_mode;
+	key.error_mode = inst.edit.error_mode;
+	key.show_object_numbers = inst.edit.show_object_numbers;
+	key.debugging = global::Debugging;
+
+	key.split_line = inst.edit.split_line.valid() ? inst.edit.split_line.num : -1;
+
+	if (inst.edit.sector_render_mode == SREND_SoundProp && inst.edit.mode == ObjType::sectors &&
+		inst.edit.highlight.valid())
+	{
+		key.sound_origin = inst.edit.highlight.num;
+	}
+
+	v2double_t camera;
+	inst.Render3D_GetCameraPos(camera, &key.camera_angle);
+	key.camera_x = camera.x;
+	key.camera_y = camera.y;
+
+	key.map_revision = inst.map_revision;
+
+	return key;
+}
+
+
 //
 //  draw the grid in the background of the inst.edit window
 //
@@ -683,18 +761,24 @@ void UI_Canvas::DrawVertices()
 
 	RenderColor(FL_GREEN);
 
+	if (lod_active)
+		lod_pixels.clear_all();
+
 	for (const auto &vertex : inst.level.vertices)
 	{
 		double x = vertex->x();
 		double y = vertex->y();
 
-		if (Vis(x, y, r))
-		{
+		if (! Vis(x, y, r))
+			continue;
+
+		if (lod_active)
+			DrawDot(SCREENX(x), SCREENY(y));
+		else
 			DrawVertex(x, y, r);
-		}
 	}
 
-	if (inst.edit.show_object_numbers)
+	if (inst.edit.show_object_numbers && ! lod_active)
 	{
 		for (int n = 0 ; n < inst.level.numVertices(); n++)
 		{
@@ -718,6 +802,9 @@ void UI_Canvas::DrawVertices()
 //
 void UI_Canvas::DrawLinedefs()
 {
+	if (lod_active)
+		lod_pixels.clear_all();
+
 	for (int n = 0 ; n < inst.level.numLinedefs(); n++)
 	{
 		const auto L = inst.level.linedefs[n];
@@ -730,6 +817,20 @@ void UI_Canvas::DrawLinedefs()
 		if (! Vis(std::min(x1,x2), std::min(y1,y2), std::max(x1,x2), std::max(y1,y2)))
 			continue;
 
+		// a line within a single pixel becomes a dot, and further
+		// lines on that pixel are skipped
+		bool dot = false;
+
+		if (lod_active && SCREENX(x1) == SCREENX(x2) && SCREENY(y1) == SCREENY(y2))
+		{
+			int pix = LOD_Pixel(SCREENX(x1), SCREENY(y1));
+
+			if (pix < 0 || lod_pixels.get(pix))
+				continue;
+
+			dot = true;
+		}
+
 		bool one_sided = (! inst.level.getLeft(*L));
 
 		Fl_Color col = LIGHTGREY;
@@ -757,7 +858,7 @@ void UI_Canvas::DrawLinedefs()
 
 				// show info of last four added lines
 				if (n != inst.edit.split_line.num && n >= (inst.level.numLinedefs() - 4) &&
-					!inst.edit.show_object_numbers)
+					!inst.edit.show_object_numbers && !lod_active)
 				{
 					DrawLineInfo(x1, y1, x2, y2, false);
 				}
@@ -838,7 +939,7 @@ void UI_Canvas::DrawLinedefs()
 						col = WHITE;
 				}
 
-				if (inst.edit.show_object_numbers)
+				if (inst.edit.show_object_numbers && !lod_active)
 				{
 					if (s1 != NIL_OBJ)
 						DrawSectorNum(static_cast<int>(x1), static_cast<int>(y1), static_cast<int>(x2), static_cast<int>(y2), Side::right, s1);
@@ -860,6 +961,16 @@ void UI_Canvas::DrawLinedefs()
 
 		RenderColor(col);
 
+		if (dot)
+		{
+			DrawDot(SCREENX(x1), SCREENY(y1));
+			continue;
+		}
+
+		// no direction ticks when zoomed out
+		if (lod_active && line_kind == 'k')
+			line_kind = 'p';
+
 		switch (line_kind)
 		{
 			case 'p':
@@ -877,7 +988,7 @@ void UI_Canvas::DrawLinedefs()
 	}
 
 	// draw the linedef numbers
-	if (inst.edit.mode == ObjType::linedefs && inst.edit.show_object_numbers)
+	if (inst.edit.mode == ObjType::linedefs && inst.edit.show_object_numbers && !lod_active)
 	{
 		for (int n = 0 ; n < inst.level.numLinedefs(); n++)
 		{
@@ -931,6 +1042,9 @@ void UI_Canvas::DrawThings()
 	else if (inst.edit.error_mode)
 		RenderColor(LIGHTGREY);
 
+	if (lod_active)
+		lod_pixels.clear_all();
+
 	for (const auto &thing : inst.level.things)
 	{
 		double x = thing->x();
@@ -941,19 +1055,37 @@ void UI_Canvas::DrawThings()
 
 		const thingtype_t &info = inst.conf.getThingType(thing->type);
 
+		int r = info.radius;
+
+		// tiny things become dots, showing where they are dense
+		bool dot = (lod_active && r * inst.grid.getScale() < 2);
+
+		// another dot is already shown there
+		if (dot)
+		{
+			int pix = LOD_Pixel(SCREENX(x), SCREENY(y));
+
+			if (pix < 0 || lod_pixels.get(pix))
+				continue;
+		}
+
 		if (inst.edit.mode == ObjType::things && !inst.edit.error_mode)
 		{
 			Fl_Color col = (Fl_Color)info.color;
 			RenderColor(col);
 		}
 
-		int r = info.radius;
+		if (dot)
+		{
+			DrawDot(SCREENX(x), SCREENY(y));
+			continue;
+		}
 
 		DrawThing(x, y, r, thing->angle, false);
 	}
 
 	// draw the thing numbers
-	if (inst.edit.mode == ObjType::things && inst.edit.show_object_numbers)
+	if (inst.edit.mode == ObjType::things && inst.edit.show_object_numbers && !lod_active)
 	{
 		for (int n = 0 ; n < inst.level.numThings(); n++)
 		{
@@ -992,11 +1124,15 @@ void UI_Canvas::DrawThingBodies()
 
 		const thingtype_t &info = inst.conf.getThingType(thing->type);
 
+		int r = info.radius;
+
+		// DrawThings() shows these as dots
+		if (lod_active && r * inst.grid.getScale() < 2)
+			continue;
+
 		Fl_Color col = (Fl_Color)info.color;
 		RenderColor(DarkerColor(DarkerColor(col)));
 
-		int r = info.radius;
-
 		int sx1 = SCREENX(x - r);
 		int sy1 = SCREENY(y + r);
 		int sx2 = SCREENX(x + r);
@@ -1041,6 +1177,8 @@ static int calcThingRotation(int angle)
 void UI_Canvas::DrawThingSprites()
 {
 #ifndef NO_OPENGL
+	FlushBatch();
+
 	glEnable(GL_TEXTURE_2D);
 	glEnable(GL_ALPHA_TEST);
 
@@ -1058,6 +1196,10 @@ void UI_Canvas::DrawThingSprites()
 		const thingtype_t &info = inst.conf.getThingType(thing->type);
 		float scale = info.scale;
 
+		// DrawThings() shows these as dots
+		if (lod_active && info.radius * inst.grid.getScale() < 2)
+			continue;
+
 		Img_c *sprite = inst.wad.getMutableSprite(inst.conf, thing->type, inst.loaded, calcThingRotation(thing->angle));
 
 		if (! sprite)
@@ -1315,6 +1457,34 @@ void UI_Canvas::DrawLineInfo(double map_x1, double map_y1, double map_x2, double
 }
 
 
+//
+// index of a screen pixel in lod_pixels, or -1 when off the canvas
+//
+int UI_Canvas::LOD_Pixel(int sx, int sy) const
+{
+	int px = sx - xx;
+	int py = sy - yy;
+
+	if (px < 0 || py < 0 || px >= w() || py >= h())
+		return -1;
+
+	return px + py * w();
+}
+
+
+void UI_Canvas::DrawDot(int sx, int sy)
+{
+	int pix = LOD_Pixel(sx, sy);
+
+	if (pix < 0 || lod_pixels.get(pix))
+		return;
+
+	lod_pixels.set(pix);
+
+	RenderRect(sx, sy, 1, 1);
+}
+
+
 //
 //  draw a number centered at screen coordinate (x, y)
 //
@@ -1983,6 +2153,8 @@ void UI_Canvas::DrawSplitPoint(const v2double_t &map_pos)
 #ifdef NO_OPENGL
 	RenderRect(sx - size/2, sy - size/2, size, size);
 #else
+	FlushBatch();
+
 	glPointSize(static_cast<GLfloat>(size));
 
 	glBegin(GL_POINTS);
@@ -2303,6 +2475,16 @@ void UI_Canvas::RenderSector(int num)
 	if (! inst.Subdiv_SectorOnScreen(num, map_lx, map_ly, map_hx, map_hy))
 		return;
 
+	// skip sectors smaller than a pixel, their lines cover them
+	if (lod_active)
+	{
+		const sector_extra_info_t &info = inst.sector_info_cache.infos[num];
+
+		if ((info.bound_x2 - info.bound_x1) * inst.grid.getScale() < 1 &&
+			(info.bound_y2 - info.bound_y1) * inst.grid.getScale() < 1)
+			return;
+	}
+
 	sector_subdivision_c *subdiv = inst.Subdiv_PolygonsForSector(num);
 
 	if (! subdiv)
@@ -2314,7 +2496,7 @@ void UI_Canvas::RenderSector(int num)
 	rgb_color_t light_col = SectorLightColor(inst.level.sectors[num]->light);
 	bool light_and_tex = false;
 
-	SString tex_name;
+	StringID tex_name;
 
 	Img_c * img = NULL;
 
@@ -2344,22 +2526,23 @@ void UI_Canvas::RenderSector(int num)
 
 		if (inst.edit.sector_render_mode == SREND_Ceiling ||
 			inst.edit.sector_render_mode == SREND_CeilBright)
-			tex_name = inst.level.sectors[num]->CeilTex();
+			tex_name = inst.level.sectors[num]->ceil_tex;
 		else
-			tex_name = inst.level.sectors[num]->FloorTex();
+			tex_name = inst.level.sectors[num]->floor_tex;
+
+		ResolvedImage res = inst.wad.images.resolveFlat(inst.conf, tex_name);
 
-		if (inst.is_sky(tex_name))
+		if (res.how == ImageResolve::sky)
 		{
 			RenderColor(inst.wad.palette.getPaletteColor(inst.conf.miscInfo.sky_color));
 		}
+		else if (res.how == ImageResolve::unknown)
+		{
+			img = &inst.wad.images.getMutableUnknownTexture(inst.conf);
+		}
 		else
 		{
-			img = inst.wad.images.getMutableFlat(inst.conf, tex_name);
-
-			if (! img)
-			{
-				img = &inst.wad.images.getMutableUnknownTexture(inst.conf);
-			}
+			img = res.img;
 		}
 	}
 
@@ -2493,25 +2676,34 @@ void UI_Canvas::RenderSector(int num)
 	}
 
 #else // OpenGL
-	if (img)
+	if (! img)
 	{
-		if (light_and_tex)
-			RenderColor(light_col);
-		else
-			glColor3f(1, 1, 1);
-
-		glEnable(GL_TEXTURE_2D);
-		glEnable(GL_ALPHA_TEST);
+		// color was set above, batch the polygons as triangles
+		for (const sector_polygon_t &poly : subdiv->polygons)
+		{
+			for (int p = 2 ; p < poly.count ; p++)
+			{
+				BatchVertex(GL_TRIANGLES, SCREENX(poly.mx[0]),   SCREENY(poly.my[0]));
+				BatchVertex(GL_TRIANGLES, SCREENX(poly.mx[p-1]), SCREENY(poly.my[p-1]));
+				BatchVertex(GL_TRIANGLES, SCREENX(poly.mx[p]),   SCREENY(poly.my[p]));
+			}
+		}
+		return;
+	}
 
-		glAlphaFunc(GL_GREATER, 0.5);
+	FlushBatch();
 
-		img->bind_gl(inst.wad);
-	}
+	if (light_and_tex)
+		RenderColor(light_col);
 	else
-	{
-		// color was set above, set texture to solid white
-		glBindTexture(GL_TEXTURE_2D, 0);
-	}
+		glColor3f(1, 1, 1);
+
+	glEnable(GL_TEXTURE_2D);
+	glEnable(GL_ALPHA_TEST);
+
+	glAlphaFunc(GL_GREATER, 0.5);
+
+	img->bind_gl(inst.wad);
 
 	for (unsigned int i = 0 ; i < subdiv->polygons.size() ; i++)
 	{
@@ -2525,10 +2717,7 @@ void UI_Canvas::RenderSector(int num)
 			int sx = SCREENX(poly->mx[p]);
 			int sy = SCREENY(poly->my[p]);
 
-			if (img)
-			{
-				glTexCoord2f(poly->mx[p] / static_cast<float>(img_w), poly->my[p] / static_cast<float>(img_h));
-			}
+			glTexCoord2f(poly->mx[p] / static_cast<float>(img_w), poly->my[p] / static_cast<float>(img_h));
 
 			glVertex2i(sx, sy);
 		}
@@ -2536,11 +2725,8 @@ void UI_Canvas::RenderSector(int num)
 		glEnd();
 	}
 
-	if (img)
-	{
-		glDisable(GL_TEXTURE_2D);
-		glDisable(GL_ALPHA_TEST);
-	}
+	glDisable(GL_TEXTURE_2D);
+	glDisable(GL_ALPHA_TEST);
 #endif
 }
 
@@ -2573,6 +2759,72 @@ void UI_Canvas::Blit()
 {
 #ifdef NO_OPENGL
 	fl_draw_image(rgb_buf, x(), y(), w(), h());
+#else
+	FlushBatch();
+#endif
+}
+
+
+void UI_Canvas::SaveMapLayer()
+{
+#ifdef NO_OPENGL
+	map_layer.assign(rgb_buf, rgb_buf + rgb_w * rgb_h * 3);
+
+#else // OpenGL
+	FlushBatch();
+
+	int pw = pixel_w();
+	int ph = pixel_h();
+
+	int tw = global::use_npot_textures ? pw : RoundPOW2(pw);
+	int th = global::use_npot_textures ? ph : RoundPOW2(ph);
+
+	if (map_layer_tex == 0)
+		glGenTextures(1, &map_layer_tex);
+
+	glBindTexture(GL_TEXTURE_2D, map_layer_tex);
+
+	if (map_layer_tw != tw || map_layer_th != th)
+	{
+		map_layer_tw = tw;
+		map_layer_th = th;
+
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, tw, th, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
+	}
+
+	// copy what was just drawn into the back buffer
+	glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, pw, ph);
+#endif
+}
+
+
+void UI_Canvas::RestoreMapLayer()
+{
+#ifdef NO_OPENGL
+	memcpy(rgb_buf, map_layer.data(), map_layer.size());
+
+#else // OpenGL
+	float tx = (float)pixel_w() / (float)map_layer_tw;
+	float ty = (float)pixel_h() / (float)map_layer_th;
+
+	glEnable(GL_TEXTURE_2D);
+	glBindTexture(GL_TEXTURE_2D, map_layer_tex);
+
+	glColor3f(1, 1, 1);
+
+	glBegin(GL_QUADS);
+
+	glTexCoord2f( 0,  0); glVertex2i(  0,   0);
+	glTexCoord2f( 0, ty); glVertex2i(  0, h());
+	glTexCoord2f(tx, ty); glVertex2i(w(), h());
+	glTexCoord2f(tx,  0); glVertex2i(w(),   0);
+
+	glEnd();
+
+	glDisable(GL_TEXTURE_2D);
 #endif
 }
 
@@ -2582,7 +2834,9 @@ void UI_Canvas::RenderColor(Fl_Color c)
 #ifdef NO_OPENGL
 	Fl::get_color(c, cur_col.r, cur_col.g, cur_col.b);
 #else
-	gl_color(c);
+	Fl::get_color(c, batch_col[0], batch_col[1], batch_col[2]);
+
+	glColor3ubv(batch_col);
 #endif
 }
 
@@ -2597,6 +2851,8 @@ void UI_Canvas::RenderThickness(int w)
 #ifdef NO_OPENGL
 	thickness = (w < 2) ? 1 : 2;
 #else
+	FlushBatch();
+
 	glLineWidth(static_cast<GLfloat>(w));
 #endif
 }
@@ -2605,7 +2861,13 @@ void UI_Canvas::RenderThickness(int w)
 void UI_Canvas::RenderRect(int rx, int ry, int rw, int rh)
 {
 #ifndef NO_OPENGL
-	gl_rectf(rx, ry, rw, rh);
+	BatchVertex(GL_TRIANGLES, rx,      ry);
+	BatchVertex(GL_TRIANGLES, rx + rw, ry);
+	BatchVertex(GL_TRIANGLES, rx + rw, ry + rh);
+
+	BatchVertex(GL_TRIANGLES, rx,      ry);
+	BatchVertex(GL_TRIANGLES, rx + rw, ry + rh);
+	BatchVertex(GL_TRIANGLES, rx,      ry + rh);
 
 #else
 	// software version
@@ -2689,10 +2951,8 @@ int UI_Canvas::Calc_Outcode(int x, int y)
 void UI_Canvas::RenderLine(int x1, int y1, int x2, int y2)
 {
 #ifndef NO_OPENGL
-	glBegin(GL_LINE_STRIP);
-	glVertex2i(x1, y1);
-	glVertex2i(x2, y2);
-	glEnd();
+	BatchVertex(GL_LINES, x1, y1);
+	BatchVertex(GL_LINES, x2, y2);
 #else
 	// software line drawing
 	if (x1 == x2)
@@ -2851,6 +3111,49 @@ void UI_Canvas::RenderLine(int x1, int y1, int x2, int y2)
 }
 
 
+#ifndef NO_OPENGL
+void UI_Canvas::BatchVertex(GLenum mode, int x, int y)
+{
+	// keep the drawing order when switching between lines and triangles
+	if (mode != batch_mode)
+	{
+		FlushBatch();
+		batch_mode = mode;
+	}
+
+	batch_coords.push_back(x);
+	batch_coords.push_back(y);
+
+	batch_colors.insert(batch_colors.end(), batch_col, batch_col + 3);
+}
+
+
+void UI_Canvas::FlushBatch()
+{
+	if (batch_coords.empty())
+		return;
+
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_COLOR_ARRAY);
+
+	glVertexPointer(2, GL_INT, 0, batch_coords.data());
+	glColorPointer(3, GL_UNSIGNED_BYTE, 0, batch_colors.data());
+
+	glDrawArrays(batch_mode, 0, (GLsizei)(batch_coords.size() / 2));
+
+	glDisableClientState(GL_COLOR_ARRAY);
+	glDisableClientState(GL_VERTEX_ARRAY);
+
+	// the color array leaves the current color undefined
+	glColor3ubv(batch_col);
+
+	// keep the memory for the next batch
+	batch_coords.clear();
+	batch_colors.clear();
+}
+#endif
+
+
 void UI_Canvas::RenderNumString(int x, int y, const char *s)
 {
 	// NOTE: string is limited to the digits '0' to '9', spaces,
@@ -2877,6 +3180,8 @@ void UI_Canvas::RenderNumString(int x, int y, const char *s)
 	}
 
 #ifndef NO_OPENGL
+	FlushBatch();
+
 	glEnable(GL_TEXTURE_2D);
 	glEnable(GL_ALPHA_TEST);
 
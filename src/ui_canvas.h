@@ -23,6 +23,7 @@
 
 #ifndef NO_OPENGL
 #include <FL/Fl_Gl_Window.H>
+#include <FL/gl.h>
 #else
 #include <FL/Fl_Widget.H>
 #endif
@@ -63,6 +64,11 @@ private:
 
 	bitvec_c seen_sectors;
 
+	// when zoomed out (see LOD_SCALE), objects smaller than a pixel are
+	// drawn as dots, and only once per pixel for each kind of object.
+	bool lod_active = false;
+	bitvec_c lod_pixels;
+
 	// a copy of x() and y() for software renderer, 0 for OpenGL
 	int xx, yy;
 
@@ -73,9 +79,57 @@ private:
 	int rgb_w, rgb_h;
 	int thickness;
 	struct { byte r, g, b; } cur_col;
+#else
+	// untextured lines and rectangles are collected here, and drawn
+	// with vertex arrays instead of a glBegin/glEnd for each one.
+	GLenum batch_mode = GL_LINES;
+	std::vector<GLint> batch_coords;
+	std::vector<GLubyte> batch_colors;
+	GLubyte batch_col[3] = {};
 #endif
 	int cur_font;  // 14 or 19
 
+	// everything which the cached map layer depends on
+	struct map_layer_key_t
+	{
+		int w = 0, h = 0;
+		int pixel_w = 0, pixel_h = 0;
+
+		double orig_x = 0, orig_y = 0;
+		double scale = 0;
+		int step = 0;
+		bool grid_shown = false;
+
+		ObjType mode = ObjType::things;
+		int sector_render_mode = 0;
+		int thing_render_mode = 0;
+		bool error_mode = false;
+		bool show_object_numbers = false;
+		bool debugging = false;
+
+		int split_line = -1;
+		int sound_origin = -1;	// highlighted sector for SREND_SoundProp
+
+		double camera_x = 0, camera_y = 0;
+		float camera_angle = 0;
+
+		unsigned map_revision = 0;
+
+		bool operator == (const map_layer_key_t &other) const = default;
+	};
+
+	// the map drawn by DrawMap() is kept here, so that moving the
+	// highlight (etc) only needs to draw the overlays on top of it.
+	map_layer_key_t map_layer_key;
+	bool map_layer_valid = false;
+#ifdef NO_OPENGL
+	std::vector<byte> map_layer;
+#else
+	GLuint map_layer_tex = 0;
+	int map_layer_tw = 0;
+	int map_layer_th = 0;
+#endif
+
 public:
 	UI_Canvas(Instance &inst, int X, int Y, int W, int H, const char *label = NULL);
 	virtual ~UI_Canvas();
@@ -93,6 +147,12 @@ public:
 
 	void DrawEverything();
 
+	// force the map layer to be drawn again, e.g. after changing colors
+	void InvalidateMapLayer()
+	{
+		map_layer_valid = false;
+	}
+
 	void UpdateHighlight();
 
 	void CheckGridSnap();
@@ -121,6 +181,10 @@ private:
 	void draw();
 
 	void DrawMap();
+	void DrawMapLayer();
+	map_layer_key_t MapLayerKey();
+	void SaveMapLayer();
+	void RestoreMapLayer();
 
 	void DrawGrid_Dotty();
 	void DrawGrid_Normal();
@@ -148,6 +212,8 @@ private:
 	void DrawLineNumber(int mx1, int my1, int mx2, int my2, Side side, int n);
 	void DrawLineInfo(double map_x1, double map_y1, double map_x2, double map_y2, bool force_ratio);
 	void DrawNumber(int x, int y, int num);
+	int  LOD_Pixel(int sx, int sy) const;
+	void DrawDot(int sx, int sy);
 	void DrawCurrentLine();
 	void DrawSnapPoint();
 
@@ -203,6 +269,11 @@ private:
 	void RenderSprite(int sx, int sy, float scale, Img_c *img);
 	void RenderSector(int num);
 
+#ifndef NO_OPENGL
+	void BatchVertex(GLenum mode, int x, int y);
+	void FlushBatch();
+#endif
+
 #ifdef NO_OPENGL
 	int Calc_Outcode(int x, int y);
 
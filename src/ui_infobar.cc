@@ -414,6 +414,7 @@ void UI_InfoBar::UpdateSnapText()
 
 #define INFO_TEXT_COL	fl_rgb_color(192, 192, 192)
 #define INFO_DIM_COL	fl_rgb_color(128, 128, 128)
+#define INFO_ERROR_COL	fl_rgb_color(255, 112, 112)
 
 
 UI_StatusBar::UI_StatusBar(Instance &inst, int X, int Y, int W, int H, const char *label) :
@@ -517,10 +518,36 @@ void UI_StatusBar::draw()
 		break;
 	}
 
+	IB_ShowProblems(cy);
+
 	fl_pop_clip();
 }
 
 
+//
+// Show the live validation counts on the right side
+//
+void UI_StatusBar::IB_ShowProblems(int cy)
+{
+	const LiveValidator::Totals &totals = inst.level.validator.totals();
+
+	if (totals.major == 0 && totals.minor == 0)
+		return;
+
+	char buffer[256];
+	snprintf(buffer, sizeof(buffer), " problems: %d major, %d minor", totals.major, totals.minor);
+
+	int cx = x() + w() - 10 - static_cast<int>(fl_width(buffer));
+
+	// keep it readable when overlapping a long status message
+	fl_color(fl_rgb_color(64, 64, 64));
+	fl_rectf(cx, y(), x() + w() - cx, h() - 1);
+
+	fl_color(totals.major ? INFO_ERROR_COL : INFO_TEXT_COL);
+	fl_draw(buffer, cx, cy);
+}
+
+
 void UI_StatusBar::IB_ShowDrag(int cx, int cy)
 {
 	if (inst.edit.render3d && inst.edit.mode == ObjType::sectors)
@@ -1742,6 +1742,8 @@ void UI_Preferences::SaveValues()
 	config::normal_flat_col  = (rgb_color_t) normal_flat ->color();
 	config::normal_small_col = (rgb_color_t) normal_small->color();
 
+	gInstance->main_win->canvas->InvalidateMapLayer();
+
 	/* Nodes Tab */
 
 	config::bsp_on_save = nod_on_save->value() ? true : false;
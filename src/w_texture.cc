@@ -24,6 +24,7 @@
 //
 //------------------------------------------------------------------------
 
+#include "e_basis.h"
 #include "Errors.h"
 #include "Instance.h"
 #include "main.h"
@@ -47,6 +48,7 @@ void ImageSet::W_ClearTextures()
 	textures.clear();
 
 	medusa_textures.clear();
+	resolved.clear();
 }
 
 
@@ -54,8 +56,9 @@ void ImageSet::W_AddTexture(const SString &name, Img_c &&img, bool is_medusa)
 {
 	// free any existing one with the same name
 
-	textures[name] = std::move(img);
+	textures.set(name, std::move(img));
 	medusa_textures[name] = is_medusa ? 1 : 0;
+	resolved.clear();
 }
 
 
@@ -367,26 +370,12 @@ const Img_c * ImageSet::getTexture(const ConfigData &config, const SString &name
 	if (name.empty())
 		return NULL;
 
-	SString t_str = name;
-	std::map<SString, Img_c>::const_iterator P = textures.find(t_str);
+	const Img_c *img = textures.find(name, try_uppercase);
 
-	if (P != textures.end())
-		return &P->second;
+	if (! img && config.features.mix_textures_flats)
+		img = flats.find(name, try_uppercase);
 
-	if (try_uppercase)
-	{
-		return getTexture(config, NormalizeTex(name), false);
-	}
-
-	if (config.features.mix_textures_flats)
-	{
-		std::map<SString, Img_c>::const_iterator P = flats.find(t_str);
-
-		if (P != flats.end())
-			return &P->second;
-	}
-
-	return NULL;
+	return img;
 }
 
 
@@ -409,20 +398,10 @@ bool ImageSet::W_TextureIsKnown(const ConfigData &config, const SString &name) c
 	if (name.empty())
 		return false;
 
-	std::map<SString, Img_c>::const_iterator P = textures.find(name);
-
-	if (P != textures.end())
+	if (textures.find(name))
 		return true;
 
-	if (config.features.mix_textures_flats)
-	{
-		std::map<SString, Img_c>::const_iterator P = flats.find(name);
-
-		if (P != flats.end())
-			return true;
-	}
-
-	return false;
+	return config.features.mix_textures_flats && flats.find(name);
 }
 
 
@@ -463,13 +442,15 @@ SString NormalizeTex(const SString &name)
 void ImageSet::W_ClearFlats()
 {
 	flats.clear();
+	resolved.clear();
 }
 
 
 void ImageSet::W_AddFlat(const SString &name, Img_c &&img)
 {
 	// find any existing one with same name, and free it
-	flats[name] = std::move(img);
+	flats.set(name, std::move(img));
+	resolved.clear();
 }
 
 
@@ -536,25 +517,12 @@ void WadData::W_LoadFlats()
 
 const Img_c * ImageSet::W_GetFlat(const ConfigData &config, const SString &name, bool try_uppercase) const noexcept
 {
-	std::map<SString, Img_c>::const_iterator P = flats.find(name);
-
-	if (P != flats.end())
-		return &P->second;
+	const Img_c *img = flats.find(name, try_uppercase);
 
-	if (config.features.mix_textures_flats)
-	{
-		std::map<SString, Img_c>::const_iterator P = textures.find(name);
-
-		if (P != textures.end())
-			return &P->second;
-	}
-
-	if (try_uppercase)
-	{
-		return W_GetFlat(config, NormalizeTex(name), false);
-	}
+	if (! img && config.features.mix_textures_flats)
+		img = textures.find(name, try_uppercase);
 
-	return NULL;
+	return img;
 }
 
 
@@ -567,20 +535,10 @@ bool ImageSet::W_FlatIsKnown(const ConfigData &config, const SString &name) cons
 	if (name.empty())
 		return false;
 
-	std::map<SString, Img_c>::const_iterator P = flats.find(name);
-
-	if (P != flats.end())
+	if (flats.find(name))
 		return true;
 
-	if (config.features.mix_textures_flats)
-	{
-		std::map<SString, Img_c>::const_iterator P = textures.find(name);
-
-		if (P != textures.end())
-			return true;
-	}
-
-	return false;
+	return config.features.mix_textures_flats && textures.find(name);
 }
 
 
@@ -648,7 +606,7 @@ static std::vector<SpriteLumpRef> Sprite_loc_by_root (const MasterDir &master, c
 const Img_c *WadData::getSprite(const ConfigData &config, int type, const LoadingData &loading, int rotation)
 {
 	assert(rotation >= 1 && rotation <= 8);
-	const std::vector<Img_c> *existing = get(images.sprites, type);
+	const std::vector<Img_c> *existing = images.sprites.find(type);
 	if(existing)
 	{
 		assert(existing->size() <= 1 || existing->size() == 8);
@@ -819,8 +777,7 @@ const Img_c *WadData::getSprite(const ConfigData &config, int type, const Loadin
 	// note that a NULL image is OK.  Our renderer will just ignore the
 	// missing sprite.
 	
-	images.sprites[type] = result;
-	std::vector<Img_c> &sprites = images.sprites[type];
+	std::vector<Img_c> &sprites = images.sprites.set(type, std::move(result));
 	
 	return sprites.empty() ? nullptr : sprites.size() == 8 ? &sprites[rotation - 1] : &sprites[0];
 }
@@ -828,30 +785,121 @@ const Img_c *WadData::getSprite(const ConfigData &config, int type, const Loadin
 
 //----------------------------------------------------------------------
 
-static void UnloadTex(std::map<SString, Img_c>::value_type& P)
+static void UnloadImage(ImageMap::Entry &entry)
 {
-	P.second.unload_gl(false);
+	entry.img.unload_gl(false);
 }
 
-static void UnloadFlat(std::map<SString, Img_c>::value_type& P)
+static void UnloadSprite(std::vector<Img_c> &images)
 {
-	P.second.unload_gl(false);
-}
-
-static void UnloadSprite(sprite_map_t::value_type& P)
-{
-	for(Img_c &img : P.second)
+	for(Img_c &img : images)
 		img.unload_gl(false);
 }
 
 void ImageSet::W_UnloadAllTextures()
 {
-	std::for_each(textures.begin(), textures.end(), UnloadTex);
-	std::for_each(flats.begin(),    flats.end(), UnloadFlat);
+	std::for_each(textures.begin(), textures.end(), UnloadImage);
+	std::for_each(flats.begin(),    flats.end(), UnloadImage);
 	std::for_each(sprites.begin(), sprites.end(), UnloadSprite);
 
 	IM_UnloadDummyTextures();
 }
 
+
+//----------------------------------------------------------------------
+//    RENDERER LOOKUPS
+//----------------------------------------------------------------------
+
+//
+// Gets the cache slot of a string ID, growing the table when the string
+// table has grown since. Bad IDs get a scratch slot which is never kept.
+//
+static ResolvedImage &ResolveSlot(std::vector<ResolvedImage> &table, StringID name)
+{
+	static ResolvedImage scratch;
+
+	if (name.isInvalid())
+	{
+		scratch = ResolvedImage();
+		return scratch;
+	}
+
+	if (name.get() >= (int)table.size())
+		table.resize(name.get() + 1);
+
+	return table[name.get()];
+}
+
+
+//
+// Finds the image to draw for a sidedef texture, remembering the result
+// until the images get reloaded. Never returns a NULL image.
+//
+ResolvedImage ImageSet::resolveTexture(const ConfigData &config, const Palette &palette, StringID name)
+{
+	ResolvedImage &res = ResolveSlot(resolved.textures, name);
+
+	if (res.how != ImageResolve::unresolved)
+		return res;
+
+	SString tname = BA_GetString(name);
+
+	if (is_null_tex(tname))
+	{
+		res.img = &getMutableMissingTexture(config);
+		res.how = ImageResolve::missing;
+	}
+	else if (is_special_tex(tname))
+	{
+		res.img = &getMutableSpecialTexture(palette);
+		res.how = ImageResolve::special;
+	}
+	else
+	{
+		res.img = getMutableTexture(config, tname);
+		res.how = ImageResolve::found;
+
+		if (! res.img)
+		{
+			res.img = &getMutableUnknownTexture(config);
+			res.how = ImageResolve::unknown;
+		}
+	}
+
+	return res;
+}
+
+
+//
+// Same for a sector flat, except sky flats have no image.
+//
+ResolvedImage ImageSet::resolveFlat(const ConfigData &config, StringID name)
+{
+	ResolvedImage &res = ResolveSlot(resolved.flats, name);
+
+	if (res.how != ImageResolve::unresolved)
+		return res;
+
+	SString fname = BA_GetString(name);
+
+	if (fname.noCaseEqual(config.miscInfo.sky_flat))
+	{
+		res.img = nullptr;
+		res.how = ImageResolve::sky;
+		return res;
+	}
+
+	res.img = getMutableFlat(config, fname);
+	res.how = ImageResolve::found;
+
+	if (! res.img)
+	{
+		res.img = &getMutableUnknownFlat(config);
+		res.how = ImageResolve::unknown;
+	}
+
+	return res;
+}
+
 //--- editor settings ---
 // vi:ts=4:sw=4:noexpandtab
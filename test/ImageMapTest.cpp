@@ -0,0 +1,120 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 Ioan Chera
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "ImageMap.h"
+#include "gtest/gtest.h"
+
+TEST(ImageMap, FindExactAndUppercase)
+{
+	ImageMap map;
+	ASSERT_FALSE(map.find("STARTAN3"));
+
+	const Img_c *upper = &map.set("STARTAN3", Img_c(64, 128));
+	const Img_c *lower = &map.set("startan3", Img_c(32, 32));
+	map.set("BIGDOOR\"", Img_c(16, 16));
+	map.set("BIGDOOR_", Img_c(8, 8));
+
+	ASSERT_EQ(map.size(), 4);
+	ASSERT_EQ(ImageMap::nameKey("startan3"), ImageMap::nameKey("STARTAN3"));
+
+	// exact names win
+	ASSERT_EQ(map.find("STARTAN3"), upper);
+	ASSERT_EQ(map.find("startan3"), lower);
+	ASSERT_EQ(map.find("startan3", true), lower);
+
+	// other spellings only with try_uppercase
+	ASSERT_FALSE(map.find("StartAn3"));
+	ASSERT_EQ(map.find("StartAn3", true), upper);
+	ASSERT_EQ(map.find("bigdoor\"", true)->width(), 8);
+	ASSERT_EQ(map.find("STARTAN3XYZ", true), upper);
+	ASSERT_FALSE(map.find("STARTAN", true));
+
+	// replacing keeps the image in place
+	ASSERT_EQ(&map.set("STARTAN3", Img_c(128, 128)), upper);
+	ASSERT_EQ(upper->width(), 128);
+	ASSERT_EQ(map.size(), 4);
+
+	map.clear();
+	ASSERT_EQ(map.size(), 0);
+	ASSERT_FALSE(map.find("STARTAN3", true));
+}
+
+TEST(ImageMap, PointersSurviveGrowth)
+{
+	ImageMap map;
+	const Img_c *first = &map.set("FLAT0", Img_c(64, 64));
+
+	for (int i = 1; i < 1000; i++)
+		map.set(SString::printf("FLAT%d", i), Img_c(64, 64));
+
+	ASSERT_EQ(map.size(), 1000);
+	ASSERT_EQ(map.find("FLAT0"), first);
+	for (int i = 0; i < 1000; i++)
+		ASSERT_TRUE(map.find(SString::printf("flat%d", i), true));
+}
+
+TEST(ImageMap, SortedAndCopied)
+{
+	ImageMap map;
+	map.set("ZZWOLF1", Img_c(1, 1));
+	map.set("AASHITZ", Img_c(2, 2));
+	map.set("MIDGRATE", Img_c(3, 3));
+
+	// insertion order
+	auto it = map.begin();
+	ASSERT_EQ(it->name, "ZZWOLF1");
+
+	const std::vector<const ImageMap::Entry *> &sorted = map.sorted();
+	ASSERT_EQ(sorted.size(), 3);
+	ASSERT_EQ(sorted[0]->name, "AASHITZ");
+	ASSERT_EQ(sorted[1]->name, "MIDGRATE");
+	ASSERT_EQ(sorted[2]->name, "ZZWOLF1");
+
+	// new entries show up in the sorted list
+	map.set("BRICK1", Img_c(4, 4));
+	ASSERT_EQ(map.sorted().size(), 4);
+	ASSERT_EQ(map.sorted()[1]->name, "BRICK1");
+
+	// copies point to their own entries
+	ImageMap copy = map;
+	ASSERT_NE(copy.find("BRICK1"), map.find("BRICK1"));
+	ASSERT_EQ(copy.sorted()[1]->name, "BRICK1");
+	ASSERT_EQ(&copy.sorted()[1]->img, copy.find("BRICK1"));
+}
+
+TEST(ImageMap, Sprites)
+{
+	SpriteMap map;
+	ASSERT_FALSE(map.find(3004));
+
+	std::vector<Img_c> &possessed = map.set(3004, std::vector<Img_c>(8));
+	map.set(-1, {});
+
+	for (int type = 0; type < 500; type++)
+		map.set(type + 10000, std::vector<Img_c>(1));
+
+	ASSERT_EQ(map.find(3004), &possessed);
+	ASSERT_EQ(map.find(3004)->size(), 8);
+	ASSERT_TRUE(map.find(-1));
+	ASSERT_TRUE(map.find(-1)->empty());
+	ASSERT_EQ(map.find(10499)->size(), 1);
+	ASSERT_FALSE(map.find(10500));
+
+	map.clear();
+	ASSERT_FALSE(map.find(3004));
+}
@@ -26,7 +26,9 @@
 #include "LineDef.h"
 #include "m_select.h"
 #include "Sector.h"
+#include "SideDef.h"
 #include "ui_window.h"
+#include "w_rawdef.h"
 
 //==============================================================================
 //
@@ -278,3 +280,338 @@ TEST(EChecks, TagsApplyNewValue)
 
 	ASSERT_EQ(inst.tagInMemory, 1);	// changed again
 }
+
+//
+// Test Things_FindStuckies, including things far apart and walls
+//
+TEST(EChecks, ThingsFindStuckies)
+{
+	Instance inst;
+	inst.loaded.levelFormat = MapFormat::doom;
+
+	thingtype_t monster = {};
+	monster.group = 'm';
+	monster.radius = 20;
+	monster.desc = "Imp";
+	inst.conf.thing_types[3001] = monster;
+
+	thingtype_t decor = {};
+	decor.group = 'd';
+	decor.flags = THINGDEF_PASS;
+	decor.radius = 16;
+	decor.desc = "Candle";
+	inst.conf.thing_types[34] = decor;
+
+	auto addThing = [&inst](int type, double x, double y)
+	{
+		auto thing = std::make_shared<Thing>();
+		thing->type = type;
+		thing->options = 7;	// all skills
+		thing->xf = x;
+		thing->yf = y;
+		inst.level.things.push_back(std::move(thing));
+	};
+	auto addVertex = [&inst](double x, double y)
+	{
+		auto vertex = std::make_shared<Vertex>();
+		vertex->xf = x;
+		vertex->yf = y;
+		inst.level.vertices.push_back(std::move(vertex));
+	};
+
+	selection_c list;
+
+	// Nothing at all
+	Things_FindStuckies(list, inst);
+	ASSERT_EQ(list.what_type(), ObjType::things);
+	ASSERT_TRUE(list.empty());
+
+	addThing(3001, 0, 0);		// 0: overlaps 1, so it's marked
+	addThing(3001, 10, 0);		// 1: only the earlier one gets marked
+	addThing(3001, 500, 500);	// 2: free
+	addThing(34, 500, 500);		// 3: non-blocking, ignored
+	addThing(3001, 1000, 0);	// 4: crossed by the wall below
+	addThing(3001, 30000, -30000);	// 5: far away, free
+	addThing(3001, 30032, -30000);	// 6: free, only touching 5
+
+	// a whole crowd of free things
+	for (int i = 0; i < 20; ++i)
+		for (int j = 0; j < 20; ++j)
+			addThing(3001, -4000 + i * 60, -4000 + j * 60);
+
+	// one-sided wall
+	addVertex(1005, -100);
+	addVertex(1005, 100);
+	auto line = std::make_shared<LineDef>();
+	line->start = 0;
+	line->end = 1;
+	line->right = 0;
+	line->left = -1;
+	inst.level.linedefs.push_back(std::move(line));
+
+	// diagonal virtual line (no sides) doesn't block
+	addVertex(0, 400);
+	addVertex(1000, 600);
+	line = std::make_shared<LineDef>();
+	line->start = 2;
+	line->end = 3;
+	line->right = -1;
+	line->left = -1;
+	inst.level.linedefs.push_back(std::move(line));
+
+	Things_FindStuckies(list, inst);
+	ASSERT_EQ(list.count_obj(), 2);
+	ASSERT_TRUE(list.get(0));
+	ASSERT_TRUE(list.get(4));
+
+	// Move the wall onto the crowd
+	inst.level.vertices[0]->xf = inst.level.vertices[1]->xf = -4000 + 3 * 60 + 5;
+	inst.level.vertices[0]->yf = -4000;
+	inst.level.vertices[1]->yf = -4000 + 60;
+	Things_FindStuckies(list, inst);
+	ASSERT_EQ(list.count_obj(), 3);
+	ASSERT_TRUE(list.get(0));
+	ASSERT_TRUE(list.get(7 + 3 * 20));
+	ASSERT_TRUE(list.get(7 + 3 * 20 + 1));
+
+	// Different skills never get stuck
+	inst.level.things[1]->options = 4;
+	inst.level.things[0]->options = 3;
+	Things_FindStuckies(list, inst);
+	ASSERT_EQ(list.count_obj(), 2);
+	ASSERT_FALSE(list.get(0));
+}
+
+//
+// Test that the live validator follows the edits, matching a full re-check
+//
+TEST(EChecks, LiveValidator)
+{
+	Instance inst;
+	inst.Editor_Init();
+	inst.loaded.levelFormat = MapFormat::doom;
+
+	thingtype_t player = {};
+	player.radius = 16;
+	player.desc = "Player 1 start";
+	inst.conf.thing_types[1] = player;
+
+	Document &doc = inst.level;
+	LiveValidator &validator = doc.validator;
+
+	auto problems = [&validator](ObjType type)
+	{
+		selection_c list;
+		validator.selectProblems(list, type);
+		return list;
+	};
+
+	// compare the incremental results with a full re-check
+	auto expectConsistent = [&]()
+	{
+		LiveValidator::Totals live = validator.totals();
+		selection_c liveLists[5];
+		for (int t = 0; t < 5; ++t)
+			liveLists[t] = problems((ObjType)t);
+
+		validator.invalidate();
+		LiveValidator::Totals full = validator.totals();
+		ASSERT_EQ(live.major, full.major);
+		ASSERT_EQ(live.minor, full.minor);
+
+		for (int t = 0; t < 5; ++t)
+		{
+			selection_c fullList = problems((ObjType)t);
+			ASSERT_EQ(liveLists[t].count_obj(), fullList.count_obj());
+			for (sel_iter_c it(fullList); !it.done(); it.next())
+				ASSERT_TRUE(liveLists[t].get(*it));
+		}
+	};
+
+	ASSERT_EQ(validator.totals().major, 0);
+	ASSERT_EQ(validator.totals().minor, 0);
+
+	// a lone vertex is unused (minor)
+	int v0;
+	{
+		EditOperation op(doc.basis);
+		v0 = op.addNew(ObjType::vertices);
+	}
+	ASSERT_EQ(validator.totals().major, 0);
+	ASSERT_EQ(validator.totals().minor, 1);
+	ASSERT_TRUE(problems(ObjType::vertices).get(v0));
+	expectConsistent();
+
+	// a line to another vertex: both dangle, and it has no right side
+	int v1, line;
+	{
+		EditOperation op(doc.basis);
+		v1 = op.addNew(ObjType::vertices);
+		op.changeVertex(v1, &Vertex::xf, 64);
+		line = op.addNew(ObjType::linedefs);
+		op.changeLinedef(line, &LineDef::start, v0);
+		op.changeLinedef(line, &LineDef::end, v1);
+	}
+	ASSERT_TRUE(problems(ObjType::linedefs).get(line));
+	ASSERT_EQ(problems(ObjType::vertices).count_obj(), 2);
+	expectConsistent();
+
+	// an unknown thing
+	{
+		EditOperation op(doc.basis);
+		int thing = op.addNew(ObjType::things);
+		op.changeThing(thing, Thing::F_TYPE, 1);
+		thing = op.addNew(ObjType::things);
+		op.changeThing(thing, Thing::F_TYPE, 9999);
+	}
+	ASSERT_EQ(problems(ObjType::things).count_obj(), 1);
+	ASSERT_TRUE(problems(ObjType::things).get(1));
+	expectConsistent();
+
+	// collapse the line, then undo it
+	{
+		EditOperation op(doc.basis);
+		op.changeVertex(v1, &Vertex::xf, 0);
+	}
+	expectConsistent();
+	ASSERT_TRUE(doc.basis.undo());
+	expectConsistent();
+
+	// deleting the first vertex renumbers the others
+	{
+		EditOperation op(doc.basis);
+		op.del(ObjType::linedefs, line);
+		op.del(ObjType::vertices, v0);
+	}
+	ASSERT_EQ(doc.numVertices(), 1);
+	ASSERT_EQ(problems(ObjType::vertices).count_obj(), 1);
+	expectConsistent();
+
+	// and bring them back in the middle
+	ASSERT_TRUE(doc.basis.undo());
+	ASSERT_EQ(doc.numVertices(), 2);
+	ASSERT_EQ(problems(ObjType::vertices).count_obj(), 2);
+	expectConsistent();
+
+	// sectors with ceiling under the floor
+	{
+		EditOperation op(doc.basis);
+		int sector = op.addNew(ObjType::sectors);
+		op.changeSector(sector, Sector::F_CEILH, -8);
+	}
+	ASSERT_EQ(problems(ObjType::sectors).count_obj(), 1);
+	expectConsistent();
+
+	ASSERT_TRUE(doc.basis.undo());
+	ASSERT_TRUE(problems(ObjType::sectors).empty());
+	expectConsistent();
+
+	// give the line two sides, in sectors of the same height
+	int back, left;
+	{
+		EditOperation op(doc.basis);
+		int front = op.addNew(ObjType::sectors);
+		back = op.addNew(ObjType::sectors);
+		int right = op.addNew(ObjType::sidedefs);
+		left = op.addNew(ObjType::sidedefs);
+		op.changeSidedef(right, SideDef::F_SECTOR, front);
+		op.changeSidedef(left, SideDef::F_SECTOR, back);
+		op.changeSidedef(left, SideDef::F_LOWER_TEX, BA_InternaliseString("-"));
+		op.changeLinedef(line, &LineDef::right, right);
+		op.changeLinedef(line, &LineDef::left, left);
+		op.changeLinedef(line, &LineDef::flags, static_cast<int>(MLF_TwoSided));
+	}
+	expectConsistent();
+	int minor = validator.totals().minor;
+
+	// raising the front floor leaves the line without a lower texture,
+	// found through the sector and its sidedef
+	{
+		EditOperation op(doc.basis);
+		op.changeSector(0, Sector::F_FLOORH, 32);
+	}
+	ASSERT_EQ(validator.totals().minor, minor + 1);
+	expectConsistent();
+
+	// with the back sidedef moved into the front sector, the sector it
+	// left no longer matters
+	{
+		EditOperation op(doc.basis);
+		op.changeSidedef(left, SideDef::F_SECTOR, 0);
+	}
+	ASSERT_EQ(validator.totals().minor, minor);
+	expectConsistent();
+
+	{
+		EditOperation op(doc.basis);
+		op.changeSector(back, Sector::F_FLOORH, 64);
+	}
+	ASSERT_EQ(validator.totals().minor, minor);
+	expectConsistent();
+}
+
+//
+// Overlapping vertices and linedefs, found by their coordinates
+//
+TEST(EChecks, FindOverlaps)
+{
+	Instance inst;
+	Document &doc = inst.level;
+
+	auto addVertex = [&doc](double x, double y)
+	{
+		auto vertex = std::make_shared<Vertex>();
+		vertex->xf = x;
+		vertex->yf = y;
+		doc.vertices.push_back(std::move(vertex));
+	};
+	auto addLine = [&doc](int start, int end)
+	{
+		auto line = std::make_shared<LineDef>();
+		line->start = start;
+		line->end = end;
+		doc.linedefs.push_back(std::move(line));
+	};
+
+	// a column of vertices sharing the same X
+	for (int i = 0; i < 100; ++i)
+		addVertex(64, i * 8);
+
+	addVertex(64, 16);		// 100: on 2
+	addVertex(64, 16);		// 101: on 2 as well
+	addVertex(-0.0, 0);		// 102: -0 is 0
+	addVertex(0, 0);		// 103: on 102
+	addVertex(64.5, 16);	// 104: not quite
+
+	selection_c sel;
+	std::vector<int> bases;
+	Vertex_FindOverlaps(sel, doc, &bases);
+
+	ASSERT_EQ(sel.what_type(), ObjType::vertices);
+	ASSERT_EQ(sel.count_obj(), 3);
+	ASSERT_TRUE(sel.get(100));
+	ASSERT_TRUE(sel.get(101));
+	ASSERT_TRUE(sel.get(103));
+
+	ASSERT_EQ(bases.size(), 105u);
+	ASSERT_EQ(bases[100], 2);
+	ASSERT_EQ(bases[101], 2);
+	ASSERT_EQ(bases[103], 102);
+	ASSERT_EQ(bases[2], -1);
+	ASSERT_EQ(bases[104], -1);
+
+	addLine(0, 1);		// 0
+	addLine(1, 0);		// 1: same as 0, reversed
+	addLine(1, 2);		// 2
+	addLine(1, 100);	// 3: same as 2 through the overlapping vertex
+	addLine(2, 100);	// 4: zero-length
+	addLine(100, 2);	// 5: zero-length, ignored even if it overlaps 4
+	addLine(0, 104);	// 6
+
+	LineDefs_FindOverlaps(sel, doc);
+
+	ASSERT_EQ(sel.what_type(), ObjType::linedefs);
+	ASSERT_EQ(sel.count_obj(), 2);
+	ASSERT_TRUE(sel.get(1));
+	ASSERT_TRUE(sel.get(3));
+}
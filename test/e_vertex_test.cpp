@@ -0,0 +1,99 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 Ioan Chera
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "Instance.h"
+
+#include "e_basis.h"
+#include "e_vertex.h"
+#include "Vertex.h"
+
+#include "gtest/gtest.h"
+
+//
+// findExact() keeps its coordinate index in step with the edits
+//
+TEST(EVertex, FindExactFollowsEdits)
+{
+	Instance inst;
+	inst.loaded.levelFormat = MapFormat::udmf;
+	Document &doc = inst.level;
+
+	ASSERT_EQ(doc.vertmod.findExact(0, 0), -1);
+
+	// added directly, as when loading
+	for (int i = 0; i < 4; ++i)
+	{
+		auto vertex = std::make_shared<Vertex>();
+		vertex->xf = i * 32;
+		vertex->yf = 16;
+		doc.vertices.push_back(std::move(vertex));
+	}
+
+	ASSERT_EQ(doc.vertmod.findExact(64, 16), 2);
+	ASSERT_EQ(doc.vertmod.findExact(64, 17), -1);
+
+	// new vertices get their position after adding
+	int added;
+	{
+		EditOperation op(doc.basis);
+		added = op.addNew(ObjType::vertices);
+		doc.vertices[added]->SetRawXY(MapFormat::udmf, { 64, 16 });
+	}
+	ASSERT_EQ(added, 4);
+
+	// the lowest number wins
+	ASSERT_EQ(doc.vertmod.findExact(64, 16), 2);
+
+	{
+		EditOperation op(doc.basis);
+		op.changeVertex(2, &Vertex::xf, 500);
+	}
+	ASSERT_EQ(doc.vertmod.findExact(64, 16), 4);
+	ASSERT_EQ(doc.vertmod.findExact(500, 16), 2);
+
+	// deleting in the middle renumbers the others
+	{
+		EditOperation op(doc.basis);
+		op.del(ObjType::vertices, 0);
+	}
+	ASSERT_EQ(doc.vertmod.findExact(64, 16), 3);
+	ASSERT_EQ(doc.vertmod.findExact(500, 16), 1);
+	ASSERT_EQ(doc.vertmod.findExact(0, 16), -1);
+
+	// and undoing puts them back
+	ASSERT_TRUE(doc.basis.undo());
+	ASSERT_EQ(doc.vertmod.findExact(0, 16), 0);
+	ASSERT_EQ(doc.vertmod.findExact(64, 16), 4);
+
+	ASSERT_TRUE(doc.basis.undo());
+	ASSERT_EQ(doc.vertmod.findExact(64, 16), 2);
+	ASSERT_EQ(doc.vertmod.findExact(500, 16), -1);
+
+	// deleting the last one
+	{
+		EditOperation op(doc.basis);
+		op.del(ObjType::vertices, 4);
+	}
+	ASSERT_EQ(doc.vertmod.findExact(64, 16), 2);
+	ASSERT_TRUE(doc.basis.undo());
+	ASSERT_EQ(doc.vertmod.findExact(64, 16), 2);
+
+	// moved behind its back
+	doc.vertices[2]->xf = 1000;
+	ASSERT_EQ(doc.vertmod.findExact(64, 16), 4);
+}
@@ -17,7 +17,9 @@
 //------------------------------------------------------------------------
 
 #include "im_color.h"
+#include "im_img.h"
 #include "w_wad.h"
+#include "testUtils/Benchmark.hpp"
 #include "testUtils/Palette.hpp"
 #include "gtest/gtest.h"
 #include <vector>
@@ -68,3 +70,113 @@ TEST(Palette, FindPaletteColor)
 	ASSERT_EQ(palette.findPaletteColor(63, 64, 65), 64);
 	ASSERT_EQ(palette.findPaletteColor(255, 255, 255), 254);	// not the trans pixel
 }
+
+static std::vector<img_pixel_t> makeTestPixels()
+{
+	std::vector<img_pixel_t> pixels;
+
+	for (int c = 0; c < 256; ++c)
+		pixels.push_back(static_cast<img_pixel_t>(c));
+	for (int c = 0; c < 32768; ++c)
+		pixels.push_back(static_cast<img_pixel_t>(IS_RGB_PIXEL | c));
+
+	return pixels;
+}
+
+TEST(Palette, DecodePixels)
+{
+	Palette palette;
+	makeCommonPalette(palette);
+
+	std::vector<img_pixel_t> pixels = makeTestPixels();
+	int count = (int)pixels.size();
+
+	std::vector<byte> rgb(count * 3);
+	std::vector<byte> doubled(count * 6);
+
+	for (int gamma : { 0, 4 })
+	{
+		ASSERT_TRUE(palette.updateGamma(gamma, 2));
+
+		palette.decodePixels(pixels.data(), rgb.data(), count);
+		palette.decodePixelsDoubled(pixels.data(), doubled.data(), count);
+
+		for (int i = 0; i < count; ++i)
+		{
+			byte r, g, b;
+			palette.decodePixel(pixels[i], r, g, b);
+
+			ASSERT_EQ(rgb[i * 3 + 0], r);
+			ASSERT_EQ(rgb[i * 3 + 1], g);
+			ASSERT_EQ(rgb[i * 3 + 2], b);
+
+			for (int k = 0; k < 6; k += 3)
+			{
+				ASSERT_EQ(doubled[i * 6 + k + 0], r);
+				ASSERT_EQ(doubled[i * 6 + k + 1], g);
+				ASSERT_EQ(doubled[i * 6 + k + 2], b);
+			}
+		}
+	}
+}
+
+TEST(Palette, DecodePixelsBGRA)
+{
+	Palette palette;
+	makeCommonPalette(palette);
+	ASSERT_TRUE(palette.updateGamma(2, 2));
+
+	std::vector<img_pixel_t> pixels = makeTestPixels();
+	int count = (int)pixels.size();
+
+	std::vector<byte> bgra(count * 4);
+	palette.decodePixelsBGRA(pixels.data(), bgra.data(), count);
+
+	for (int i = 0; i < count; ++i)
+	{
+		const byte *dest = &bgra[i * 4];
+
+		if (pixels[i] == TRANS_PIXEL)
+		{
+			ASSERT_EQ(dest[0] | dest[1] | dest[2] | dest[3], 0);
+			continue;
+		}
+
+		byte r, g, b;
+		palette.decodePixel(pixels[i], r, g, b);
+
+		ASSERT_EQ(dest[0], b);
+		ASSERT_EQ(dest[1], g);
+		ASSERT_EQ(dest[2], r);
+		ASSERT_EQ(dest[3], 255);
+	}
+}
+
+//
+// Micro-benchmark of decodePixels() against a decodePixel() loop, over a
+// 1920x1080 frame of mixed pixels. Run with --gtest_also_run_disabled_tests.
+//
+TEST(Palette, DISABLED_DecodePixelsBenchmark)
+{
+	Palette palette;
+	makeCommonPalette(palette);
+
+	const int count = 1920 * 1080;
+	std::vector<img_pixel_t> frame(count);
+	for (int i = 0; i < count; ++i)
+		frame[i] = static_cast<img_pixel_t>((i & 1) ? (i * 7) & 255 : IS_RGB_PIXEL | (i & 0x7fff));
+
+	std::vector<byte> rgb(count * 3);
+
+	benchmark("decodePixel loop", 20, [&]()
+	{
+		byte *dest = rgb.data();
+		for (int i = 0; i < count; ++i, dest += 3)
+			palette.decodePixel(frame[i], dest[0], dest[1], dest[2]);
+	});
+
+	benchmark("decodePixels", 20, [&]()
+	{
+		palette.decodePixels(frame.data(), rgb.data(), count);
+	});
+}
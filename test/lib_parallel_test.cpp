@@ -0,0 +1,80 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 Ioan Chera
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "lib_parallel.h"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+TEST(LibParallel, ThreadCount)
+{
+	ASSERT_GE(ParallelThreadCount(), 1);
+}
+
+TEST(LibParallel, VisitsEveryIndexOnce)
+{
+	for (int count : { 0, 1, 2, 7, 1000 })
+	{
+		std::vector<std::atomic<int>> hits(count);
+		ParallelFor(count, [&hits](int index)
+		{
+			hits[index]++;
+		});
+
+		for (int i = 0; i < count; ++i)
+			ASSERT_EQ(hits[i], 1) << "count " << count << " index " << i;
+	}
+}
+
+TEST(LibParallel, Nested)
+{
+	std::atomic<int> total = 0;
+	ParallelFor(8, [&total](int outer)
+	{
+		ParallelFor(10, [&total, outer](int inner)
+		{
+			total += outer * 10 + inner;
+		});
+	});
+
+	ASSERT_EQ(total, 79 * 80 / 2);
+}
+
+TEST(LibParallel, RethrowsError)
+{
+	std::atomic<int> done = 0;
+	ASSERT_THROW(ParallelFor(50, [&done](int index)
+	{
+		if (index == 17)
+			throw std::runtime_error("bad index");
+		done++;
+	}), std::runtime_error);
+
+	// the other calls still ran
+	ASSERT_EQ(done, 49);
+
+	// and the pool is still usable
+	done = 0;
+	ParallelFor(20, [&done](int)
+	{
+		done++;
+	});
+	ASSERT_EQ(done, 20);
+}
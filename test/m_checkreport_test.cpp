@@ -0,0 +1,104 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 Ioan Chera
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "m_checkreport.h"
+
+#include "gtest/gtest.h"
+
+#include <stdexcept>
+
+static std::vector<LevelCheckReport> makeReports()
+{
+	std::vector<LevelCheckReport> reports(2);
+
+	reports[0].wadPath = "maps/test.wad";
+	reports[0].levelName = "MAP01";
+	reports[0].loadMillis = 1.5;
+	reports[0].checkMillis = 2.25;
+
+	CheckReportEntry entry;
+	entry.category = "vertices";
+	entry.name = "dangling vertices";
+	entry.severity = 2;
+	entry.type = ObjType::vertices;
+	entry.objects = { 3, 7 };
+	entry.millis = 0.5;
+	reports[0].findings.push_back(entry);
+
+	entry = CheckReportEntry();
+	entry.category = "textures";
+	entry.name = "unknown textures";
+	entry.severity = 2;
+	entry.type = ObjType::sidedefs;
+	entry.objects = { 1 };
+	entry.details = { "BAD\"TEX", "X,Y" };
+	reports[0].findings.push_back(entry);
+
+	reports[1].wadPath = "maps/test.wad";
+	reports[1].levelName = "MAP02";
+	reports[1].error = "No such map";
+
+	return reports;
+}
+
+TEST(MCheckReport, ParseFormat)
+{
+	ASSERT_EQ(M_ParseCheckReportFormat("json"), CheckReportFormat::json);
+	ASSERT_EQ(M_ParseCheckReportFormat("CSV"), CheckReportFormat::csv);
+	ASSERT_THROW(M_ParseCheckReportFormat("xml"), std::runtime_error);
+}
+
+TEST(MCheckReport, JSON)
+{
+	SString text = M_FormatCheckReport(makeReports(), CheckReportFormat::json);
+
+	ASSERT_NE(text.find("\"level\": \"MAP01\""), std::string::npos);
+	ASSERT_NE(text.find("\"check\": \"dangling vertices\", \"severity\": \"major\", \"count\": 2, "
+						"\"type\": \"vertices\", \"objects\": [3, 7]"), std::string::npos);
+	ASSERT_NE(text.find("\"details\": [\"BAD\\\"TEX\", \"X,Y\"]"), std::string::npos);
+	ASSERT_NE(text.find("\"error\": \"No such map\""), std::string::npos);
+	ASSERT_NE(text.find("\"load_ms\": 1.500"), std::string::npos);
+
+	// empty report is still valid
+	text = M_FormatCheckReport({}, CheckReportFormat::json);
+	ASSERT_EQ(text, "{\n\t\"levels\":\n\t[\n\t]\n}\n");
+}
+
+TEST(MCheckReport, CSV)
+{
+	SString text = M_FormatCheckReport(makeReports(), CheckReportFormat::csv);
+
+	ASSERT_EQ(text,
+			  "wad,level,error,bad_refs,load_ms,check_ms,category,check,severity,count,type,objects,details,ms\n"
+			  "maps/test.wad,MAP01,,0,1.500,2.250,vertices,dangling vertices,major,2,vertices,3 7,,0.500\n"
+			  "maps/test.wad,MAP01,,0,1.500,2.250,textures,unknown textures,major,1,sidedefs,1,\"BAD\"\"TEX X,Y\",0.000\n"
+			  "maps/test.wad,MAP02,No such map,0,0.000,0.000,,,,,,,,\n");
+}
+
+TEST(MCheckReport, ExitCode)
+{
+	std::vector<LevelCheckReport> reports = makeReports();
+	ASSERT_EQ(M_CheckReportExitCode(reports), 2);
+
+	reports.pop_back();
+	ASSERT_EQ(M_CheckReportExitCode(reports), 1);
+
+	for (CheckReportEntry &entry : reports[0].findings)
+		entry.severity = 1;
+	ASSERT_EQ(M_CheckReportExitCode(reports), 0);
+}
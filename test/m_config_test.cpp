@@ -744,6 +744,7 @@ bool config::show_full_one_sided = false;
 int  config::thing_render_default = 1;
 bool config::render_missing_bright = true;
 bool config::render_unknown_bright = true;
+bool config::render_gl_shaders = true;
 int config::sector_render_default = (int)SREND_Floor;
 bool config::grid_hide_in_free_mode = false;
 bool config::sidedef_add_del_buttons = false;
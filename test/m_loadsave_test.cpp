@@ -0,0 +1,216 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 Ioan Chera
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "Instance.h"
+
+#include "e_basis.h"
+#include "LineDef.h"
+#include "m_loadsave.h"
+#include "Sector.h"
+#include "SideDef.h"
+#include "Thing.h"
+#include "Vertex.h"
+#include "w_rawdef.h"
+#include "w_wad.h"
+
+#include "testUtils/Benchmark.hpp"
+#include "testUtils/LevelWads.hpp"
+
+#include "gtest/gtest.h"
+
+#include <string.h>
+
+//
+// Raw records of a classic format level
+//
+struct RawLevel
+{
+	std::vector<raw_thing_t> things;
+	std::vector<raw_linedef_t> linedefs;
+	std::vector<raw_sidedef_t> sidedefs;
+	std::vector<raw_vertex_t> vertices;
+	std::vector<raw_sector_t> sectors;
+};
+
+template<typename T>
+static void addLump(Wad_file &wad, const char *name, const std::vector<T> &records)
+{
+	Lump_c &lump = wad.AddLump(name);
+	if (! records.empty())
+		lump.Write(records.data(), static_cast<int>(records.size() * sizeof(T)));
+}
+
+static std::shared_ptr<Wad_file> makeClassicWad(const RawLevel &level)
+{
+	auto wad = Wad_file::Open("dummy.wad", WadOpenMode::write);
+	wad->AddLevel("MAP01");
+	addLump(*wad, "THINGS", level.things);
+	addLump(*wad, "LINEDEFS", level.linedefs);
+	addLump(*wad, "SIDEDEFS", level.sidedefs);
+	addLump(*wad, "VERTEXES", level.vertices);
+	addLump(*wad, "SECTORS", level.sectors);
+	return wad;
+}
+
+static void loadClassic(const Instance &inst, const Wad_file &wad, Document &doc)
+{
+	BadCount bad = {};
+	doc.LoadThings(0, &wad);
+	doc.LoadVertices(0, &wad);
+	doc.LoadSectors(0, &wad);
+	doc.LoadSideDefs(0, &wad, inst.conf, bad);
+	doc.LoadLineDefs(0, &wad, inst.conf, bad);
+}
+
+static void setName(char (&dest)[8], const char *name)
+{
+	memset(dest, 0, sizeof(dest));
+	memcpy(dest, name, std::min(strlen(name), sizeof(dest)));
+}
+
+static raw_sidedef_t makeSide(const char *upper, const char *lower, const char *mid, int sector)
+{
+	raw_sidedef_t side = {};
+	setName(side.upper_tex, upper);
+	setName(side.lower_tex, lower);
+	setName(side.mid_tex, mid);
+	side.sector = static_cast<uint16_t>(sector);
+	return side;
+}
+
+TEST(MLoadSave, LoadClassicLumps)
+{
+	RawLevel level;
+
+	level.things.push_back({ -64, 32, 90, 3004, 7 });
+	level.vertices.push_back({ 0, 0 });
+	level.vertices.push_back({ 64, -32 });
+
+	raw_sector_t sector = {};
+	sector.floorh = -8;
+	sector.ceilh = 128;
+	memcpy(sector.floor_tex, "flat1\0ab", 8);	// junk after the end
+	setName(sector.ceil_tex, "F_SKY1");
+	sector.light = 160;
+	sector.type = 9;
+	sector.tag = -1;
+	level.sectors.push_back(sector);
+
+	level.sidedefs.push_back(makeSide("-", "startan3", "STARTAN3", 0));
+	level.sidedefs.push_back(makeSide("LONGNAME", "-", "flat1", 0));
+	level.sidedefs.back().x_offset = -3;
+
+	level.linedefs.push_back({ 0, 1, 4, 11, 5, 0, 0xFFFF });
+	level.linedefs.push_back({ 1, 0, 0, 0, 0, 1, 0xFFFF });
+
+	Instance inst;
+	auto wad = makeClassicWad(level);
+
+	Document doc(inst);
+	loadClassic(inst, *wad, doc);
+
+	ASSERT_EQ(doc.numThings(), 1);
+	ASSERT_DOUBLE_EQ(doc.things[0]->x(), -64);
+	ASSERT_DOUBLE_EQ(doc.things[0]->y(), 32);
+	ASSERT_EQ(doc.things[0]->angle, 90);
+	ASSERT_EQ(doc.things[0]->type, 3004);
+	ASSERT_EQ(doc.things[0]->options, 7);
+
+	ASSERT_EQ(doc.numVertices(), 2);
+	ASSERT_DOUBLE_EQ(doc.vertices[1]->x(), 64);
+	ASSERT_DOUBLE_EQ(doc.vertices[1]->y(), -32);
+
+	ASSERT_EQ(doc.numSectors(), 1);
+	ASSERT_EQ(doc.sectors[0]->floorh, -8);
+	ASSERT_EQ(doc.sectors[0]->ceilh, 128);
+	ASSERT_EQ(doc.sectors[0]->FloorTex(), "FLAT1");
+	ASSERT_EQ(doc.sectors[0]->CeilTex(), "F_SKY1");
+	ASSERT_EQ(doc.sectors[0]->light, 160);
+	ASSERT_EQ(doc.sectors[0]->type, 9);
+	ASSERT_EQ(doc.sectors[0]->tag, -1);
+
+	ASSERT_EQ(doc.numSidedefs(), 2);
+	ASSERT_EQ(doc.sidedefs[0]->UpperTex(), "-");
+	ASSERT_EQ(doc.sidedefs[0]->LowerTex(), "STARTAN3");
+	ASSERT_EQ(doc.sidedefs[0]->lower_tex, doc.sidedefs[0]->mid_tex);
+	ASSERT_EQ(doc.sidedefs[1]->UpperTex(), "LONGNAME");
+	ASSERT_EQ(doc.sidedefs[1]->mid_tex, doc.sectors[0]->floor_tex);
+	ASSERT_EQ(doc.sidedefs[1]->x_offset, -3);
+
+	ASSERT_EQ(doc.numLinedefs(), 2);
+	ASSERT_EQ(doc.linedefs[0]->start, 0);
+	ASSERT_EQ(doc.linedefs[0]->end, 1);
+	ASSERT_EQ(doc.linedefs[0]->flags, 4);
+	ASSERT_EQ(doc.linedefs[0]->type, 11);
+	ASSERT_EQ(doc.linedefs[0]->arg1, 5);
+	ASSERT_EQ(doc.linedefs[0]->right, 0);
+	ASSERT_EQ(doc.linedefs[0]->left, -1);
+	ASSERT_EQ(doc.linedefs[1]->right, 1);
+}
+
+//
+// Loading time of a large vanilla format level. Run with
+// --gtest_also_run_disabled_tests.
+//
+TEST(MLoadSave, DISABLED_LoadBenchmark)
+{
+	const int side = 100;
+	const int tex_count = 300;
+
+	RawLevel level;
+
+	forEachGridVertex(side, [&level](int x, int y)
+	{
+		level.vertices.push_back({ static_cast<int16_t>(x * 64), static_cast<int16_t>(y * 64) });
+	});
+
+	forEachGridSquare(side, [&level](const GridSquare &square)
+	{
+		int sec = square.sector;
+
+		raw_sector_t sector = {};
+		setName(sector.floor_tex, SString::printf("FLAT%d", sec % 40).c_str());
+		setName(sector.ceil_tex, "CEIL1_1");
+		sector.ceilh = 128;
+		sector.light = 160;
+		level.sectors.push_back(sector);
+
+		for (int k = 0; k < 4; ++k)
+		{
+			SString tex = SString::printf("WALL%d", (sec * 4 + k) % tex_count);
+			level.linedefs.push_back({ static_cast<uint16_t>(square.corners[k]), static_cast<uint16_t>(square.corners[k + 1]),
+									   1, 0, 0, static_cast<uint16_t>(level.sidedefs.size()), 0xFFFF });
+			level.sidedefs.push_back(makeSide("-", "-", tex.c_str(), sec));
+		}
+
+		level.things.push_back({ static_cast<int16_t>(square.x * 64 + 32), static_cast<int16_t>(square.y * 64 + 32), 0, 3001, 7 });
+	});
+
+	auto wad = makeClassicWad(level);
+	printf("%d sidedefs, %d linedefs\n", static_cast<int>(level.sidedefs.size()), static_cast<int>(level.linedefs.size()));
+
+	Instance inst;
+
+	benchmark("Classic load", 3, [&inst, &wad, side]()
+	{
+		Document doc(inst);
+		loadClassic(inst, *wad, doc);
+
+		ASSERT_EQ(doc.numSidedefs(), side * side * 4);
+	});
+}
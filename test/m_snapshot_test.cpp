@@ -0,0 +1,256 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 Ioan Chera
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "Instance.h"
+
+#include "e_basis.h"
+#include "lib_file.h"
+#include "LineDef.h"
+#include "m_loadsave.h"
+#include "m_snapshot.h"
+#include "main.h"
+#include "Sector.h"
+#include "SideDef.h"
+#include "Thing.h"
+#include "Vertex.h"
+#include "w_wad.h"
+
+#include "testUtils/LevelWads.hpp"
+#include "testUtils/TempDirContext.hpp"
+
+static const char s_textmap[] =
+	"namespace = \"zdoom\";\n"
+	"thing { x = 32; y = 32; angle = 90; type = 3004; skill1 = true; id = 5; arg0 = 2; }\n"
+	"vertex { x = 0; y = 0; }\n"
+	"vertex { x = 64; y = 0; }\n"
+	"vertex { x = 64.5; y = 64; }\n"
+	"linedef { v1 = 0; v2 = 1; sidefront = 0; blocking = true; special = 80; arg1 = 4; }\n"
+	"linedef { v1 = 1; v2 = 2; sidefront = 1; }\n"
+	"linedef { v1 = 2; v2 = 0; sidefront = 2; }\n"
+	"sidedef { sector = 0; texturemiddle = \"STARTAN3\"; offsetx = 8; }\n"
+	"sidedef { sector = 0; texturemiddle = \"STARTAN3\"; texturetop = \"BIGDOOR2\"; }\n"
+	"sidedef { sector = 0; texturebottom = \"FLAT1\"; }\n"
+	"sector { heightceiling = 128; texturefloor = \"FLAT1\"; textureceiling = \"F_SKY1\";"
+	" lightlevel = 144; id = 3; }\n";
+
+class MSnapshot : public TempDirContext
+{
+protected:
+	void SetUp() override
+	{
+		TempDirContext::SetUp();
+		oldCacheDir = global::cache_dir;
+		global::cache_dir = mTempDir;
+	}
+
+	void TearDown() override
+	{
+		global::cache_dir = oldCacheDir;
+		std::error_code ec;
+		fs::remove_all(getSubPath("snapshots"), ec);
+		TempDirContext::TearDown();
+	}
+
+	fs::path oldCacheDir;
+};
+
+static void expectSameLevel(const Document &a, const Document &b)
+{
+	ASSERT_EQ(a.numThings(), b.numThings());
+	for (int n = 0; n < a.numThings(); ++n)
+	{
+		const Thing &A = *a.things[n], &B = *b.things[n];
+		ASSERT_DOUBLE_EQ(A.x(), B.x());
+		ASSERT_DOUBLE_EQ(A.y(), B.y());
+		ASSERT_EQ(A.angle, B.angle);
+		ASSERT_EQ(A.type, B.type);
+		ASSERT_EQ(A.options, B.options);
+		ASSERT_EQ(A.tid, B.tid);
+		ASSERT_EQ(A.arg1, B.arg1);
+	}
+
+	ASSERT_EQ(a.numVertices(), b.numVertices());
+	for (int n = 0; n < a.numVertices(); ++n)
+	{
+		ASSERT_DOUBLE_EQ(a.vertices[n]->x(), b.vertices[n]->x());
+		ASSERT_DOUBLE_EQ(a.vertices[n]->y(), b.vertices[n]->y());
+	}
+
+	ASSERT_EQ(a.numSectors(), b.numSectors());
+	for (int n = 0; n < a.numSectors(); ++n)
+	{
+		const Sector &A = *a.sectors[n], &B = *b.sectors[n];
+		ASSERT_EQ(A.ceilh, B.ceilh);
+		ASSERT_EQ(A.FloorTex(), B.FloorTex());
+		ASSERT_EQ(A.CeilTex(), B.CeilTex());
+		ASSERT_EQ(A.light, B.light);
+		ASSERT_EQ(A.tag, B.tag);
+	}
+
+	ASSERT_EQ(a.numSidedefs(), b.numSidedefs());
+	for (int n = 0; n < a.numSidedefs(); ++n)
+	{
+		const SideDef &A = *a.sidedefs[n], &B = *b.sidedefs[n];
+		ASSERT_EQ(A.x_offset, B.x_offset);
+		ASSERT_EQ(A.UpperTex(), B.UpperTex());
+		ASSERT_EQ(A.MidTex(), B.MidTex());
+		ASSERT_EQ(A.LowerTex(), B.LowerTex());
+		ASSERT_EQ(A.sector, B.sector);
+	}
+
+	ASSERT_EQ(a.numLinedefs(), b.numLinedefs());
+	for (int n = 0; n < a.numLinedefs(); ++n)
+	{
+		const LineDef &A = *a.linedefs[n], &B = *b.linedefs[n];
+		ASSERT_EQ(A.start, B.start);
+		ASSERT_EQ(A.end, B.end);
+		ASSERT_EQ(A.right, B.right);
+		ASSERT_EQ(A.left, B.left);
+		ASSERT_EQ(A.flags, B.flags);
+		ASSERT_EQ(A.type, B.type);
+		ASSERT_EQ(A.arg2, B.arg2);
+	}
+}
+
+TEST_F(MSnapshot, ReopenFromSnapshot)
+{
+	Instance inst;
+	auto wad = makeUDMFWad(s_textmap);
+
+	SnapshotKey key = Snapshot_LevelKey(*wad, 0);
+	ASSERT_FALSE(FileExists(Snapshot_Path(key)));
+
+	NewDocument first = inst.openDocument(inst.loaded, *wad, 0);
+	ASSERT_TRUE(FileExists(Snapshot_Path(key)));
+	ASSERT_EQ(first.loading.udmfNamespace, "zdoom");
+
+	// the namespace comes from the snapshot too
+	LoadingData loading = inst.loaded;
+	loading.udmfNamespace = "eternity";
+
+	NewDocument second = inst.openDocument(loading, *wad, 0);
+	ASSERT_EQ(second.loading.udmfNamespace, "zdoom");
+	ASSERT_FALSE(second.bad.exists());
+	ASSERT_FALSE(second.doc.hasChanges());
+	expectSameLevel(first.doc, second.doc);
+
+	Document doc(inst);
+	SString udmf_namespace;
+	ASSERT_TRUE(Snapshot_Load(key, MapFormat::udmf, doc, udmf_namespace));
+	ASSERT_EQ(udmf_namespace, "zdoom");
+	expectSameLevel(first.doc, doc);
+
+	// it's only good for the same format
+	Document other(inst);
+	ASSERT_FALSE(Snapshot_Load(key, MapFormat::hexen, other, udmf_namespace));
+	ASSERT_EQ(other.numThings(), 0);
+}
+
+TEST_F(MSnapshot, KeyFollowsLumps)
+{
+	auto wad = makeUDMFWad(s_textmap);
+	auto same = makeUDMFWad(s_textmap);
+
+	SString changed_text = s_textmap;
+	changed_text += "vertex { x = 128; y = 0; }\n";
+	auto changed = makeUDMFWad(changed_text);
+
+	SnapshotKey key = Snapshot_LevelKey(*wad, 0);
+	ASSERT_EQ(key.hash, Snapshot_LevelKey(*same, 0).hash);
+	ASSERT_EQ(key.level_bytes, strlen(s_textmap));
+	ASSERT_NE(key.hash, Snapshot_LevelKey(*changed, 0).hash);
+	ASSERT_EQ(Snapshot_LevelKey(*changed, 0).level_bytes, changed_text.length());
+
+	// lumps which don't get loaded, like the nodes, don't count
+	same->InsertPoint(same->LevelLastLump(0));
+	Lump_c &nodes = same->AddLump("ZNODES");
+	nodes.Write("XGLN", 4);
+	ASSERT_EQ(key.hash, Snapshot_LevelKey(*same, 0).hash);
+	ASSERT_EQ(key.level_bytes, Snapshot_LevelKey(*same, 0).level_bytes);
+}
+
+TEST_F(MSnapshot, LevelSizeMustMatch)
+{
+	Instance inst;
+	auto wad = makeUDMFWad(s_textmap);
+	SnapshotKey key = Snapshot_LevelKey(*wad, 0);
+
+	NewDocument first = inst.openDocument(inst.loaded, *wad, 0);
+	ASSERT_TRUE(FileExists(Snapshot_Path(key)));
+
+	// as if another level had the same hash
+	SnapshotKey collision = key;
+	collision.level_bytes += 1;
+
+	Document doc(inst);
+	SString udmf_namespace;
+	ASSERT_FALSE(Snapshot_Load(collision, MapFormat::udmf, doc, udmf_namespace));
+	ASSERT_EQ(doc.numLinedefs(), 0);
+	ASSERT_TRUE(Snapshot_Load(key, MapFormat::udmf, doc, udmf_namespace));
+}
+
+TEST_F(MSnapshot, DamagedSnapshotIsIgnored)
+{
+	Instance inst;
+	auto wad = makeUDMFWad(s_textmap);
+	SnapshotKey key = Snapshot_LevelKey(*wad, 0);
+
+	NewDocument first = inst.openDocument(inst.loaded, *wad, 0);
+
+	fs::path path = Snapshot_Path(key);
+	std::vector<uint8_t> data;
+	ASSERT_TRUE(FileLoad(path, data));
+	fs::resize_file(path, data.size() - 1);
+
+	Document doc(inst);
+	SString udmf_namespace;
+	ASSERT_FALSE(Snapshot_Load(key, MapFormat::udmf, doc, udmf_namespace));
+	ASSERT_EQ(doc.numLinedefs(), 0);
+
+	// falls back to parsing, and writes a good one again
+	NewDocument second = inst.openDocument(inst.loaded, *wad, 0);
+	expectSameLevel(first.doc, second.doc);
+	ASSERT_TRUE(Snapshot_Load(key, MapFormat::udmf, doc, udmf_namespace));
+}
+
+TEST_F(MSnapshot, NoSnapshotOfBadLevel)
+{
+	Instance inst;
+
+	// the sidedef refers to a missing sector
+	auto wad = makeUDMFWad("namespace = \"doom\";\n"
+						   "vertex { x = 0; y = 0; }\n"
+						   "vertex { x = 64; y = 0; }\n"
+						   "linedef { v1 = 0; v2 = 1; sidefront = 0; }\n"
+						   "sidedef { sector = 4; }\n");
+
+	NewDocument newdoc = inst.openDocument(inst.loaded, *wad, 0);
+	ASSERT_TRUE(newdoc.bad.exists());
+	ASSERT_FALSE(FileExists(Snapshot_Path(Snapshot_LevelKey(*wad, 0))));
+}
+
+TEST_F(MSnapshot, NoSnapshotWhenAskedNotTo)
+{
+	Instance inst;
+	auto wad = makeUDMFWad(s_textmap);
+
+	NewDocument newdoc = inst.openDocument(inst.loaded, *wad, 0, false);
+	ASSERT_FALSE(newdoc.bad.exists());
+	ASSERT_EQ(newdoc.doc.numLinedefs(), 3);
+	ASSERT_FALSE(FileExists(Snapshot_Path(Snapshot_LevelKey(*wad, 0))));
+}
@@ -0,0 +1,467 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 Ioan Chera
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "Instance.h"
+
+#include "e_basis.h"
+#include "LineDef.h"
+#include "m_loadsave.h"
+#include "Sector.h"
+#include "SideDef.h"
+#include "Thing.h"
+#include "Vertex.h"
+#include "w_rawdef.h"
+#include "w_wad.h"
+
+#include "testUtils/Benchmark.hpp"
+#include "testUtils/LevelWads.hpp"
+
+#include "gtest/gtest.h"
+
+static void loadUDMF(const Instance &inst, const Wad_file &wad, Document &doc, LoadingData &loading)
+{
+	BadCount bad = {};
+	inst.UDMF_LoadLevel(0, &wad, doc, loading, bad);
+}
+
+static std::string saveUDMF(const Instance &inst)
+{
+	LoadingData loading;
+	loading.udmfNamespace = "zdoom";
+
+	auto wad = Wad_file::Open("dummy.wad", WadOpenMode::write);
+	wad->AddLevel("MAP01");
+	inst.UDMF_SaveLevel(loading, *wad);
+
+	const std::vector<byte> &data = wad->GetLump(wad->LevelLookupLump(0, "TEXTMAP"))->getData();
+	return std::string(data.begin(), data.end());
+}
+
+TEST(MUdmf, ParseLevel)
+{
+	static const char textmap[] =
+		"// a comment\n"
+		"namespace = \"zdoom\";\n"
+		"ee_compat = true; /* block\n"
+		"comment { } */\n"
+		"THING // 0\n"
+		"{\n"
+		"\tX = -32.5; y = +64;\n"
+		"\theight = 8; type = 3004; angle = 90;\n"
+		"\tskill2 = true; skill3 = true; skill4 = false; ambush = true;\n"
+		"\tcoop = true;\n"
+		"\tid = 7; special = 80; arg0 = 1; arg4 = 5;\n"
+		"\tunknownfield = \"}\";\n"
+		"}\n"
+		"vertex { x = 1.25; y = 2; }\n"
+		"vertex { x = 64; y = 2e1; }\n"
+		"linedef\n"
+		"{\n"
+		"\tv1 = 0; v2 = 1; sidefront = 0; sideback = 1;\n"
+		"\tspecial = 11; arg0 = 3; id = 12;\n"
+		"\tblocking = true; twosided = true; dontpegbottom = false;\n"
+		"\tplayeruse = true; repeatspecial = true; passuse = true;\n"
+		"}\n"
+		"sidedef { sector = 0; texturetop = \"startan3\"; texturemiddle = \"VERYLONGNAME\";\n"
+		"\toffsetx = -4; offsety = 3; }\n"
+		"sidedef { sector = 0; texturebottom = \"QU\\\"OTE\"; }\n"
+		"sector\n"
+		"{\n"
+		"\theightfloor = -8; heightceiling = 128;\n"
+		"\ttexturefloor = \"FLOOR0_1\"; textureceiling = \"f_sky1\";\n"
+		"\tspecial = 9; id = 3;\n"
+		"}\n"
+		"mystery { a = 1; }\n"
+		"sector { lightlevel = 192; }\n";
+
+	Instance inst;
+	auto wad = makeUDMFWad(textmap);
+
+	Document doc(inst);
+	LoadingData loading;
+	loadUDMF(inst, *wad, doc, loading);
+
+	ASSERT_EQ(loading.udmfNamespace, "zdoom");
+
+	ASSERT_EQ(doc.numThings(), 1);
+	const Thing &thing = *doc.things[0];
+	ASSERT_DOUBLE_EQ(thing.x(), -32.5);
+	ASSERT_DOUBLE_EQ(thing.y(), 64);
+	ASSERT_DOUBLE_EQ(thing.h(), 8);
+	ASSERT_EQ(thing.type, 3004);
+	ASSERT_EQ(thing.angle, 90);
+	ASSERT_EQ(thing.options, MTF_Easy | MTF_Medium | MTF_Ambush | MTF_Not_SP | MTF_Not_DM);
+	ASSERT_EQ(thing.tid, 7);
+	ASSERT_EQ(thing.special, 80);
+	ASSERT_EQ(thing.arg1, 1);
+	ASSERT_EQ(thing.arg5, 5);
+
+	ASSERT_EQ(doc.numVertices(), 2);
+	ASSERT_DOUBLE_EQ(doc.vertices[0]->x(), 1.25);
+	ASSERT_DOUBLE_EQ(doc.vertices[1]->y(), 20);
+
+	ASSERT_EQ(doc.numLinedefs(), 1);
+	const LineDef &line = *doc.linedefs[0];
+	ASSERT_EQ(line.start, 0);
+	ASSERT_EQ(line.end, 1);
+	ASSERT_EQ(line.right, 0);
+	ASSERT_EQ(line.left, 1);
+	ASSERT_EQ(line.type, 11);
+	ASSERT_EQ(line.arg1, 3);
+	ASSERT_EQ(line.lineid, 12);
+	ASSERT_EQ(line.flags, MLF_Blocking | MLF_TwoSided | MLF_Boom_PassThru);
+	ASSERT_EQ(line.udmfFlags, MLF_UDMF_playeruse | MLF_UDMF_repeatspecial);
+
+	ASSERT_EQ(doc.numSidedefs(), 2);
+	ASSERT_EQ(doc.sidedefs[0]->UpperTex(), "STARTAN3");
+	ASSERT_EQ(doc.sidedefs[0]->MidTex(), "VERYLONG");
+	ASSERT_EQ(doc.sidedefs[0]->LowerTex(), "-");
+	ASSERT_EQ(doc.sidedefs[0]->x_offset, -4);
+	ASSERT_EQ(doc.sidedefs[0]->y_offset, 3);
+	ASSERT_EQ(doc.sidedefs[1]->LowerTex(), "QU\\_OTE");
+
+	ASSERT_EQ(doc.numSectors(), 2);
+	const Sector &sector = *doc.sectors[0];
+	ASSERT_EQ(sector.floorh, -8);
+	ASSERT_EQ(sector.ceilh, 128);
+	ASSERT_EQ(sector.FloorTex(), "FLOOR0_1");
+	ASSERT_EQ(sector.CeilTex(), "F_SKY1");
+	ASSERT_EQ(sector.light, 160);
+	ASSERT_EQ(sector.type, 9);
+	ASSERT_EQ(sector.tag, 3);
+	ASSERT_EQ(doc.sectors[1]->light, 192);
+}
+
+TEST(MUdmf, UnterminatedInput)
+{
+	Instance inst;
+
+	for (const char *textmap : { "thing { x = 1; y = ", "vertex { x = 1; } /* open", "sidedef { texturetop = \"AB" })
+	{
+		auto wad = makeUDMFWad(textmap);
+
+		Document doc(inst);
+		LoadingData loading;
+		loadUDMF(inst, *wad, doc, loading);
+
+		ASSERT_EQ(doc.numThings() + doc.numVertices() + doc.numSidedefs(), 1);
+	}
+}
+
+TEST(MUdmf, SaveAndLoad)
+{
+	Instance inst;
+	inst.conf.features.friend_flag = 1;
+	inst.conf.features.pass_through = 1;
+
+	Document &doc = inst.level;
+	for (int i = 0; i < 3; ++i)
+	{
+		auto vertex = std::make_unique<Vertex>();
+		vertex->SetRawXY(MapFormat::udmf, { i * 64.125, -i * 0.5 });
+		doc.vertices.push_back(std::move(vertex));
+	}
+
+	auto thing = std::make_unique<Thing>();
+	thing->SetRawX(MapFormat::udmf, 0.1);
+	thing->SetRawY(MapFormat::udmf, -1234.0625);
+	thing->SetRawH(MapFormat::udmf, 16);
+	thing->type = 9;
+	thing->angle = 270;
+	thing->options = MTF_Hard | MTF_Friend | MTF_Not_DM;
+	doc.things.push_back(std::move(thing));
+
+	auto sector = std::make_shared<Sector>();
+	sector->floorh = -16;
+	sector->ceilh = 200;
+	sector->floor_tex = BA_InternaliseString("NUKAGE1");
+	sector->ceil_tex = BA_InternaliseString("F_SKY1");
+	sector->light = 144;
+	sector->type = 7;
+	sector->tag = 99;
+	doc.sectors.push_back(std::move(sector));
+
+	auto side = std::make_shared<SideDef>();
+	side->upper_tex = BA_InternaliseString("-");
+	side->mid_tex = BA_InternaliseString("STARTAN3");
+	side->lower_tex = BA_InternaliseString("BROWN1");
+	side->x_offset = 5;
+	side->y_offset = -6;
+	doc.sidedefs.push_back(std::move(side));
+
+	auto line = std::make_shared<LineDef>();
+	line->start = 0;
+	line->end = 2;
+	line->right = 0;
+	line->type = 62;
+	line->arg2 = 4;
+	line->lineid = 17;
+	line->flags = MLF_Blocking | MLF_Secret | MLF_Boom_PassThru;
+	line->udmfFlags = MLF_UDMF_monstercross | MLF_UDMF_impact;
+	doc.linedefs.push_back(std::move(line));
+
+	LoadingData loading;
+	loading.udmfNamespace = "eternity";
+
+	auto wad = Wad_file::Open("dummy.wad", WadOpenMode::write);
+	wad->AddLevel("MAP01");
+	inst.UDMF_SaveLevel(loading, *wad);
+
+	Document loaded(inst);
+	LoadingData loaded_info;
+	loadUDMF(inst, *wad, loaded, loaded_info);
+
+	ASSERT_EQ(loaded_info.udmfNamespace, "eternity");
+
+	ASSERT_EQ(loaded.numVertices(), 3);
+	for (int i = 0; i < 3; ++i)
+	{
+		ASSERT_DOUBLE_EQ(loaded.vertices[i]->x(), doc.vertices[i]->x());
+		ASSERT_DOUBLE_EQ(loaded.vertices[i]->y(), doc.vertices[i]->y());
+	}
+
+	ASSERT_EQ(loaded.numThings(), 1);
+	ASSERT_DOUBLE_EQ(loaded.things[0]->x(), doc.things[0]->x());
+	ASSERT_DOUBLE_EQ(loaded.things[0]->y(), doc.things[0]->y());
+	ASSERT_DOUBLE_EQ(loaded.things[0]->h(), 16);
+	ASSERT_EQ(loaded.things[0]->type, 9);
+	ASSERT_EQ(loaded.things[0]->angle, 270);
+	ASSERT_EQ(loaded.things[0]->options, doc.things[0]->options);
+
+	ASSERT_EQ(loaded.numSectors(), 1);
+	ASSERT_EQ(loaded.sectors[0]->floorh, -16);
+	ASSERT_EQ(loaded.sectors[0]->ceilh, 200);
+	ASSERT_EQ(loaded.sectors[0]->FloorTex(), "NUKAGE1");
+	ASSERT_EQ(loaded.sectors[0]->CeilTex(), "F_SKY1");
+	ASSERT_EQ(loaded.sectors[0]->light, 144);
+	ASSERT_EQ(loaded.sectors[0]->type, 7);
+	ASSERT_EQ(loaded.sectors[0]->tag, 99);
+
+	ASSERT_EQ(loaded.numSidedefs(), 1);
+	ASSERT_EQ(loaded.sidedefs[0]->UpperTex(), "-");
+	ASSERT_EQ(loaded.sidedefs[0]->MidTex(), "STARTAN3");
+	ASSERT_EQ(loaded.sidedefs[0]->LowerTex(), "BROWN1");
+	ASSERT_EQ(loaded.sidedefs[0]->x_offset, 5);
+	ASSERT_EQ(loaded.sidedefs[0]->y_offset, -6);
+
+	ASSERT_EQ(loaded.numLinedefs(), 1);
+	ASSERT_EQ(loaded.linedefs[0]->start, 0);
+	ASSERT_EQ(loaded.linedefs[0]->end, 2);
+	ASSERT_EQ(loaded.linedefs[0]->right, 0);
+	ASSERT_EQ(loaded.linedefs[0]->left, -1);
+	ASSERT_EQ(loaded.linedefs[0]->type, 62);
+	ASSERT_EQ(loaded.linedefs[0]->arg2, 4);
+	ASSERT_EQ(loaded.linedefs[0]->lineid, 17);
+	ASSERT_EQ(loaded.linedefs[0]->flags, doc.linedefs[0]->flags);
+	ASSERT_EQ(loaded.linedefs[0]->udmfFlags, doc.linedefs[0]->udmfFlags);
+}
+
+TEST(MUdmf, SaveFormat)
+{
+	Instance inst;
+	inst.conf.features.friend_flag = 1;
+
+	Document &doc = inst.level;
+
+	auto vertex = std::make_unique<Vertex>();
+	vertex->SetRawXY(MapFormat::udmf, { 64.125, -0.5 });
+	doc.vertices.push_back(std::move(vertex));
+
+	auto thing = std::make_unique<Thing>();
+	thing->SetRawX(MapFormat::udmf, 0.1 + 0.2);	// needs 17 digits
+	thing->SetRawY(MapFormat::udmf, -1234.0625);
+	thing->SetRawH(MapFormat::udmf, 1 / 3.0);
+	thing->type = 9;
+	thing->angle = 270;
+	thing->options = MTF_Hard | MTF_Friend | MTF_Not_DM;
+	doc.things.push_back(std::move(thing));
+
+	auto sector = std::make_shared<Sector>();
+	sector->floorh = -16;
+	sector->ceilh = 200;
+	sector->floor_tex = BA_InternaliseString("NUKAGE1");
+	sector->ceil_tex = BA_InternaliseString("f_sky1");
+	sector->light = 144;
+	sector->tag = 99;
+	doc.sectors.push_back(std::move(sector));
+
+	auto side = std::make_shared<SideDef>();
+	side->upper_tex = BA_InternaliseString("-");
+	side->mid_tex = BA_InternaliseString("-");
+	side->lower_tex = BA_InternaliseString("QU\"OTE");
+	side->x_offset = -5;
+	doc.sidedefs.push_back(std::move(side));
+
+	auto line = std::make_shared<LineDef>();
+	line->end = 0;
+	line->left = 0;
+	line->type = 62;
+	line->arg5 = -4;
+	line->flags = MLF_Blocking | MLF_Secret;
+	line->udmfFlags = MLF_UDMF_impact;
+	doc.linedefs.push_back(std::move(line));
+
+	ASSERT_EQ(saveUDMF(inst),
+			  "namespace = \"zdoom\";\n\n"
+			  "thing // 0\n{\nx = 0.30000000000000004;\ny = -1234.0625;\nheight = 0.3333333333333333;\nangle = 270;\ntype = 9;\n"
+			  "skill4 = true;\nskill5 = true;\nsingle = true;\ncoop = true;\nfriend = true;\n}\n\n"
+			  "vertex // 0\n{\nx = 64.125;\ny = -0.500;\n}\n\n"
+			  "linedef // 0\n{\nv1 = 0;\nv2 = 0;\nsideback = 0;\nspecial = 62;\narg4 = -4;\n"
+			  "blocking = true;\nsecret = true;\nimpact = true;\n}\n\n"
+			  "sidedef // 0\n{\nsector = 0;\noffsetx = -5;\ntexturebottom = \"QU_OTE\";\n}\n\n"
+			  "sector // 0\n{\nheightfloor = -16;\nheightceiling = 200;\ntexturefloor = \"NUKAGE1\";\n"
+			  "textureceiling = \"F_SKY1\";\nlightlevel = 144;\nid = 99;\n}\n\n");
+}
+
+//
+// Thing positions are written exactly, but never with an exponent
+//
+TEST(MUdmf, SaveNumbersWithoutExponent)
+{
+	Instance inst;
+
+	auto thing = std::make_unique<Thing>();
+	thing->SetRawX(MapFormat::udmf, 100000.0);
+	thing->SetRawY(MapFormat::udmf, 0.0001);
+	thing->SetRawH(MapFormat::udmf, -0.5);
+	inst.level.things.push_back(std::move(thing));
+
+	std::string saved = saveUDMF(inst);
+	ASSERT_NE(saved.find("\nx = 100000;\n"), std::string::npos);
+	ASSERT_NE(saved.find("\ny = 0.0001;\n"), std::string::npos);
+	ASSERT_NE(saved.find("\nheight = -0.5;\n"), std::string::npos);
+}
+
+//
+// Big enough to be parsed in several chunks (given several threads), with
+// comments and strings which look like block boundaries
+//
+TEST(MUdmf, ParseInChunks)
+{
+	const int count = 8000;
+
+	SString text = "namespace = \"zdoom\";\n";
+	for (int i = 0; i < count; ++i)
+	{
+		text += SString::printf("/* } sector { */ sidedef // %d }\n{\nsector = 0;\ntexturemiddle = \"P%07d\";\n"
+								"comment = \"} vertex { // ;\\\" }\";\n}\n", i, i);
+		text += SString::printf("vertex { x = %d; y = -%d; }\n", i, i);
+	}
+	text += "sector { texturefloor = \"FLOOR0_1\"; }\n";
+
+	Instance inst;
+	auto wad = makeUDMFWad(text);
+
+	Document doc(inst);
+	LoadingData loading;
+	loadUDMF(inst, *wad, doc, loading);
+
+	ASSERT_EQ(loading.udmfNamespace, "zdoom");
+	ASSERT_EQ(doc.numSidedefs(), count);
+	ASSERT_EQ(doc.numVertices(), count);
+	ASSERT_EQ(doc.numSectors(), 1);
+	ASSERT_EQ(doc.sectors[0]->FloorTex(), "FLOOR0_1");
+
+	for (int i = 0; i < count; ++i)
+	{
+		ASSERT_DOUBLE_EQ(doc.vertices[i]->x(), i);
+		ASSERT_DOUBLE_EQ(doc.vertices[i]->y(), -i);
+		ASSERT_EQ(doc.sidedefs[i]->MidTex(), SString::printf("P%07d", i));
+		ASSERT_EQ(doc.sidedefs[i]->UpperTex(), "-");
+
+		// interned in file order, like a serial parse does
+		if (i > 0)
+		{
+			ASSERT_GT(doc.sidedefs[i]->mid_tex.get(), doc.sidedefs[i - 1]->mid_tex.get());
+		}
+	}
+}
+
+//
+// A missing semicolon makes the first block swallow all the others. Any
+// chunks can't line up, so it's parsed serially instead.
+//
+TEST(MUdmf, ParseInChunksFallsBack)
+{
+	SString text;
+	for (int i = 0; i < 40000; ++i)
+		text += SString::printf("vertex { x = %d; y = %d }\n", i, i);
+
+	Instance inst;
+	auto wad = makeUDMFWad(text);
+
+	Document doc(inst);
+	LoadingData loading;
+	loadUDMF(inst, *wad, doc, loading);
+
+	ASSERT_EQ(doc.numVertices(), 1);
+	ASSERT_DOUBLE_EQ(doc.vertices[0]->x(), 0);
+}
+
+//
+// Loading time of a large TEXTMAP (about 17 MB). Run with
+// --gtest_also_run_disabled_tests.
+//
+TEST(MUdmf, DISABLED_LoadBenchmark)
+{
+	const int side = 130;
+	auto wad = makeUDMFWad(makeGridTextmap(side));
+	printf("TEXTMAP size: %d bytes\n", wad->GetLump(wad->LevelLookupLump(0, "TEXTMAP"))->Length());
+
+	Instance inst;
+
+	benchmark("UDMF load", 3, [&inst, &wad, side]()
+	{
+		Document doc(inst);
+		LoadingData loading;
+		loadUDMF(inst, *wad, doc, loading);
+
+		ASSERT_EQ(doc.numSectors(), side * side);
+		ASSERT_EQ(doc.numLinedefs(), side * side * 4);
+	});
+}
+
+//
+// Enough objects to be formatted in several batches (given several threads)
+//
+TEST(MUdmf, SaveInBatches)
+{
+	const int side = 40;
+
+	Instance inst;
+	LoadingData loading;
+	loadUDMF(inst, *makeUDMFWad(makeGridTextmap(side)), inst.level, loading);
+	ASSERT_EQ(inst.level.numLinedefs(), side * side * 4);
+
+	std::string saved = saveUDMF(inst);
+
+	Instance reloaded;
+	loadUDMF(reloaded, *makeUDMFWad(saved.c_str()), reloaded.level, loading);
+	ASSERT_EQ(saveUDMF(reloaded), saved);
+
+	size_t prev = 0;
+	for (int i = 0; i < inst.level.numLinedefs(); ++i)
+	{
+		size_t pos = saved.find(SString::printf("linedef // %d\n", i).c_str(), prev);
+		ASSERT_NE(pos, std::string::npos);
+		prev = pos;
+
+		ASSERT_EQ(reloaded.level.sidedefs[i]->MidTex(), inst.level.sidedefs[i]->MidTex());
+		ASSERT_EQ(reloaded.level.linedefs[i]->start, inst.level.linedefs[i]->start);
+	}
+}
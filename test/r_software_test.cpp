@@ -0,0 +1,160 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 Ioan Chera
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "Instance.h"
+
+#include "m_config.h"
+#include "m_loadsave.h"
+#include "w_wad.h"
+
+#include "testUtils/LevelWads.hpp"
+
+#include "gtest/gtest.h"
+
+//
+// A room split in two by a railing (a two-sided line with a middle
+// texture) at x = 256. Thing 0 stands between the camera and the railing,
+// thing 1 behind it.
+//
+static const char railRoom[] =
+	"namespace = \"zdoom\";\n"
+	"vertex { x = -64; y = -256; }\n"
+	"vertex { x = 256; y = -256; }\n"
+	"vertex { x = 512; y = -256; }\n"
+	"vertex { x = 512; y = 256; }\n"
+	"vertex { x = 256; y = 256; }\n"
+	"vertex { x = -64; y = 256; }\n"
+	"linedef { v1 = 0; v2 = 5; sidefront = 0; blocking = true; }\n"
+	"linedef { v1 = 5; v2 = 4; sidefront = 0; blocking = true; }\n"
+	"linedef { v1 = 1; v2 = 0; sidefront = 0; blocking = true; }\n"
+	"linedef { v1 = 4; v2 = 3; sidefront = 1; blocking = true; }\n"
+	"linedef { v1 = 3; v2 = 2; sidefront = 1; blocking = true; }\n"
+	"linedef { v1 = 2; v2 = 1; sidefront = 1; blocking = true; }\n"
+	"linedef { v1 = 4; v2 = 1; sidefront = 2; sideback = 3; twosided = true; "
+		"dontpegbottom = true; }\n"
+	"sidedef { sector = 0; texturemiddle = \"WALL\"; }\n"
+	"sidedef { sector = 1; texturemiddle = \"WALL\"; }\n"
+	"sidedef { sector = 0; texturemiddle = \"RAIL\"; }\n"
+	"sidedef { sector = 1; texturemiddle = \"RAIL\"; }\n"
+	"sector { heightfloor = 0; heightceiling = 128; texturefloor = \"FLAT\"; "
+		"textureceiling = \"FLAT\"; lightlevel = 160; }\n"
+	"sector { heightfloor = 0; heightceiling = 128; texturefloor = \"FLAT\"; "
+		"textureceiling = \"FLAT\"; lightlevel = 160; }\n"
+	"thing { x = 224; y = 0; type = 2014; }\n"
+	"thing { x = 384; y = 24; type = 2014; }\n";
+
+static const int RAIL_LINE = 6;
+
+class RSoftware : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		config::render_high_detail = true;
+
+		auto wad = makeUDMFWad(railRoom);
+		LoadingData loading;
+		BadCount bad = {};
+		inst.UDMF_LoadLevel(0, wad.get(), inst.level, loading, bad);
+
+		inst.r_view.x = 0;
+		inst.r_view.y = 0;
+		inst.r_view.z = 41;
+		inst.r_view.SetAngle(0);
+		inst.r_view.texturing = true;
+		inst.r_view.sprites = true;
+		inst.r_view.gravity = false;
+
+		inst.r_view.PrepareToRender(WIDTH, HEIGHT);
+	}
+
+	void TearDown() override
+	{
+		config::render_high_detail = initialHighDetail;
+	}
+
+	// what the mouse hits, from the picking buffer or by rendering the
+	// single column (as done while dragging)
+	bool query(Objid &hl, int x, int y, bool picking)
+	{
+		inst.edit.action = picking ? EditorAction::nothing : EditorAction::drag;
+
+		bool hit = inst.SW_QueryPoint(hl, x, y);
+
+		inst.edit.action = EditorAction::nothing;
+		return hit;
+	}
+
+	static const int WIDTH = 160;
+	static const int HEIGHT = 100;
+
+	Instance inst;
+
+private:
+	bool initialHighDetail = config::render_high_detail;
+};
+
+TEST_F(RSoftware, PickMatchesQuery)
+{
+	for (ObjType mode : { ObjType::things, ObjType::linedefs, ObjType::sectors })
+	{
+		inst.edit.mode = mode;
+
+		for (int x = 0; x < WIDTH; ++x)
+			for (int y = 0; y < HEIGHT; ++y)
+			{
+				Objid queried, picked;
+
+				bool queryHit = query(queried, x, y, false);
+				bool pickHit = query(picked, x, y, true);
+
+				ASSERT_EQ(pickHit, queryHit) << "mode " << (int)mode << " at " << x << "," << y;
+				ASSERT_EQ(picked, queried) << "mode " << (int)mode << " at " << x << "," << y;
+			}
+	}
+}
+
+TEST_F(RSoftware, SpriteInFrontOfRailing)
+{
+	// where thing 0 covers the railing, the railing is still picked in
+	// linedef mode, since sprites can't be picked there
+	int railQueried = 0;
+	int railPicked = 0;
+
+	for (int x = 0; x < WIDTH; ++x)
+		for (int y = 0; y < HEIGHT; ++y)
+		{
+			Objid hl;
+
+			inst.edit.mode = ObjType::things;
+			if (! query(hl, x, y, false) || ! (hl == Objid(ObjType::things, 0)))
+				continue;
+
+			ASSERT_TRUE(query(hl, x, y, true));
+			ASSERT_EQ(hl, Objid(ObjType::things, 0));
+
+			inst.edit.mode = ObjType::linedefs;
+			if (query(hl, x, y, false) && hl.num == RAIL_LINE)
+				++railQueried;
+			if (query(hl, x, y, true) && hl.num == RAIL_LINE)
+				++railPicked;
+		}
+
+	ASSERT_GT(railQueried, 0);
+	ASSERT_EQ(railPicked, railQueried);
+}
@@ -0,0 +1,157 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 Ioan Chera
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "Instance.h"
+
+#include "e_basis.h"
+#include "LineDef.h"
+#include "r_subdiv.h"
+#include "Sector.h"
+#include "SideDef.h"
+#include "Vertex.h"
+
+#include "gtest/gtest.h"
+
+static double PolygonArea(const sector_subdivision_c &sub)
+{
+	double area = 0;
+
+	for (const sector_polygon_t &poly : sub.polygons)
+	{
+		for (int i = 0; i < poly.count; ++i)
+		{
+			int k = (i + 1) % poly.count;
+			area += poly.mx[i] * poly.my[k] - poly.mx[k] * poly.my[i];
+		}
+	}
+
+	return fabs(area) / 2;
+}
+
+//
+// Only the sectors touched by an edit get subdivided again
+//
+TEST(RSubdiv, InvalidatesOnlyTouchedSectors)
+{
+	Instance inst;
+	inst.loaded.levelFormat = MapFormat::doom;
+	Document &doc = inst.level;
+
+	// two 64x64 squares sharing the line at x = 64
+	static const int coords[6][2] =
+	{
+		{ 0, 0 }, { 64, 0 }, { 64, 64 }, { 0, 64 }, { 128, 0 }, { 128, 64 }
+	};
+	// start, end, right sector, left sector
+	static const int lines[7][4] =
+	{
+		{ 0, 3, 0, -1 }, { 3, 2, 0, -1 }, { 2, 1, 0, 1 }, { 1, 0, 0, -1 },
+		{ 2, 5, 1, -1 }, { 5, 4, 1, -1 }, { 4, 1, 1, -1 }
+	};
+
+	{
+		EditOperation op(doc.basis);
+
+		for (const auto &xy : coords)
+		{
+			int v = op.addNew(ObjType::vertices);
+			op.changeVertex(v, &Vertex::xf, xy[0]);
+			op.changeVertex(v, &Vertex::yf, xy[1]);
+		}
+
+		for (int sec = 0; sec < 2; ++sec)
+		{
+			op.addNew(ObjType::sectors);
+			op.changeSector(sec, Sector::F_CEILH, 128);
+		}
+
+		for (const auto &line : lines)
+		{
+			int ld = op.addNew(ObjType::linedefs);
+			op.changeLinedef(ld, &LineDef::start, line[0]);
+			op.changeLinedef(ld, &LineDef::end, line[1]);
+
+			for (int side = 0; side < 2; ++side)
+			{
+				if (line[2 + side] < 0)
+					continue;
+
+				int sd = op.addNew(ObjType::sidedefs);
+				op.changeSidedef(sd, SideDef::F_SECTOR, line[2 + side]);
+				op.changeLinedef(ld, side ? &LineDef::left : &LineDef::right, sd);
+			}
+		}
+	}
+
+	const std::vector<sector_extra_info_t> &infos = inst.sector_info_cache.infos;
+
+	ASSERT_DOUBLE_EQ(PolygonArea(*inst.Subdiv_PolygonsForSector(0)), 64 * 64);
+	ASSERT_DOUBLE_EQ(PolygonArea(*inst.Subdiv_PolygonsForSector(1)), 64 * 64);
+
+	// move a vertex of the second sector only
+	{
+		EditOperation op(doc.basis);
+		op.changeVertex(4, &Vertex::xf, 160);
+	}
+
+	ASSERT_DOUBLE_EQ(inst.Subdiv_3DFloorsForSector(0)->FloorZ(0, 0), 0);
+	ASSERT_TRUE(infos[0].built);
+	ASSERT_FALSE(infos[1].built);
+	ASSERT_DOUBLE_EQ(infos[1].bound_x2, 160);
+	ASSERT_DOUBLE_EQ(PolygonArea(*inst.Subdiv_PolygonsForSector(1)), (96 + 64) / 2 * 64);
+
+	// heights only update the planes
+	{
+		EditOperation op(doc.basis);
+		op.changeSector(1, Sector::F_FLOORH, 24);
+	}
+
+	ASSERT_DOUBLE_EQ(inst.Subdiv_3DFloorsForSector(1)->FloorZ(100, 10), 24);
+	ASSERT_DOUBLE_EQ(inst.Subdiv_3DFloorsForSector(0)->FloorZ(10, 10), 0);
+	ASSERT_TRUE(infos[0].built);
+	ASSERT_TRUE(infos[1].built);
+
+	// a shared vertex affects both
+	{
+		EditOperation op(doc.basis);
+		op.changeVertex(1, &Vertex::xf, 32);
+	}
+
+	inst.Subdiv_3DFloorsForSector(0);
+	ASSERT_FALSE(infos[0].built);
+	ASSERT_FALSE(infos[1].built);
+	ASSERT_DOUBLE_EQ(PolygonArea(*inst.Subdiv_PolygonsForSector(0)), (32 + 64) / 2 * 64);
+	ASSERT_DOUBLE_EQ(PolygonArea(*inst.Subdiv_PolygonsForSector(1)), (128 + 64) / 2 * 64);
+
+	// giving the second sector's sidedefs to the first merges them
+	{
+		EditOperation op(doc.basis);
+		for (int sd = 0; sd < doc.numSidedefs(); ++sd)
+			op.changeSidedef(sd, SideDef::F_SECTOR, 0);
+	}
+
+	ASSERT_DOUBLE_EQ(PolygonArea(*inst.Subdiv_PolygonsForSector(1)), 0);
+	ASSERT_EQ(infos[1].first_line, -1);
+	ASSERT_DOUBLE_EQ(PolygonArea(*inst.Subdiv_PolygonsForSector(0)), (160 + 128) / 2 * 64);
+	ASSERT_DOUBLE_EQ(infos[0].bound_x2, 160);
+
+	// undo brings back the separate sectors
+	ASSERT_TRUE(doc.basis.undo());
+	ASSERT_DOUBLE_EQ(PolygonArea(*inst.Subdiv_PolygonsForSector(0)), (32 + 64) / 2 * 64);
+	ASSERT_DOUBLE_EQ(PolygonArea(*inst.Subdiv_PolygonsForSector(1)), (128 + 64) / 2 * 64);
+}
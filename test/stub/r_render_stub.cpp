@@ -25,11 +25,11 @@ void Render3D_NotifyBegin()
 {
 }
 
-void Render3D_NotifyChange(ObjType type, int objnum, int field)
+void Render3D_NotifyChange(Instance &inst, ObjType type, int objnum, int field)
 {
 }
 
-void Render3D_NotifyDelete(const Document &doc, ObjType type, int objnum)
+void Render3D_NotifyDelete(Instance &inst, ObjType type, int objnum)
 {
 }
 
@@ -37,6 +37,6 @@ void Render3D_NotifyEnd(Instance &inst)
 {
 }
 
-void Render3D_NotifyInsert(ObjType type, int objnum)
+void Render3D_NotifyInsert(Instance &inst, ObjType type, int objnum)
 {
 }
@@ -0,0 +1,44 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 Ioan Chera
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "Benchmark.hpp"
+
+#include <chrono>
+#include <stdio.h>
+
+//
+// Runs func the given number of times, and prints and returns its average
+// time in milliseconds
+//
+double benchmark(const char *what, int rounds, const std::function<void()> &func)
+{
+	double total = 0;
+
+	for (int n = 0; n < rounds; ++n)
+	{
+		auto start = std::chrono::steady_clock::now();
+		func();
+		auto end = std::chrono::steady_clock::now();
+
+		total += std::chrono::duration<double, std::milli>(end - start).count();
+	}
+
+	double average = total / rounds;
+	printf("%s: %.1f ms\n", what, average);
+	return average;
+}
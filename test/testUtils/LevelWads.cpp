@@ -0,0 +1,97 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 Ioan Chera
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "LevelWads.hpp"
+#include "w_wad.h"
+
+//
+// Makes a wad with a single UDMF level holding the given TEXTMAP
+//
+std::shared_ptr<Wad_file> makeUDMFWad(const SString &textmap)
+{
+	auto wad = Wad_file::Open("dummy.wad", WadOpenMode::write);
+	wad->AddLevel("MAP01");
+	Lump_c &lump = wad->AddLump("TEXTMAP");
+	lump.Write(textmap.c_str(), static_cast<int>(textmap.length()));
+	wad->AddLump("ENDMAP");
+	return wad;
+}
+
+//
+// Visits the (side + 1) × (side + 1) vertices of the grid, row by row
+//
+void forEachGridVertex(int side, const std::function<void(int x, int y)> &func)
+{
+	for (int y = 0; y <= side; ++y)
+		for (int x = 0; x <= side; ++x)
+			func(x, y);
+}
+
+//
+// Visits the squares of the grid, row by row
+//
+void forEachGridSquare(int side, const std::function<void(const GridSquare &square)> &func)
+{
+	for (int y = 0; y < side; ++y)
+		for (int x = 0; x < side; ++x)
+		{
+			int v = y * (side + 1) + x;
+			const GridSquare square = { x, y, y * side + x, { v, v + 1, v + side + 2, v + side + 1, v } };
+			func(square);
+		}
+}
+
+//
+// Synthetic TEXTMAP of a grid of 64 unit squares, in the same layout as our
+// own writer produces. Each sector has four one-sided linedefs and a thing
+// in the middle.
+//
+SString makeGridTextmap(int side)
+{
+	SString text = "namespace = \"zdoom\";\n\n";
+
+	int count = 0;
+	forEachGridVertex(side, [&text, &count](int x, int y)
+	{
+		text += SString::printf("vertex // %d\n{\nx = %d.000;\ny = %d.500;\n}\n\n", count++, x * 64, y * 64);
+	});
+
+	count = 0;
+	forEachGridSquare(side, [&text, &count](const GridSquare &square)
+	{
+		for (int k = 0; k < 4; ++k)
+		{
+			text += SString::printf("linedef // %d\n{\nv1 = %d;\nv2 = %d;\nsidefront = %d;\n"
+									"blocking = true;\ndontpegbottom = true;\n}\n\n",
+									count, square.corners[k], square.corners[k + 1], count);
+			text += SString::printf("sidedef // %d\n{\nsector = %d;\noffsetx = %d;\n"
+									"texturemiddle = \"STARTAN%d\";\n}\n\n",
+									count, square.sector, k * 8, k);
+			++count;
+		}
+
+		text += SString::printf("sector // %d\n{\nheightfloor = 0;\nheightceiling = 128;\n"
+								"texturefloor = \"FLOOR0_1\";\ntextureceiling = \"CEIL1_1\";\n"
+								"lightlevel = 160;\n}\n\n", square.sector);
+		text += SString::printf("thing // %d\n{\nx = %d.000;\ny = %d.000;\nangle = 90;\ntype = 3001;\n"
+								"skill1 = true;\nskill2 = true;\nsingle = true;\n}\n\n",
+								square.sector, square.x * 64 + 32, square.y * 64 + 32);
+	});
+
+	return text;
+}
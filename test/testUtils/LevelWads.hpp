@@ -0,0 +1,46 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2026 Ioan Chera
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#ifndef LevelWads_hpp
+#define LevelWads_hpp
+
+#include "m_strings.h"
+
+#include <functional>
+#include <memory>
+
+class Wad_file;
+
+//
+// One square sector of a side × side grid. The corners go round from the
+// bottom left vertex and back to it.
+//
+struct GridSquare
+{
+	int x, y;
+	int sector;
+	int corners[5];
+};
+
+std::shared_ptr<Wad_file> makeUDMFWad(const SString &textmap);
+
+void forEachGridVertex(int side, const std::function<void(int x, int y)> &func);
+void forEachGridSquare(int side, const std::function<void(const GridSquare &square)> &func);
+SString makeGridTextmap(int side);
+
+#endif /* LevelWads_hpp */
@@ -17,6 +17,7 @@
 //------------------------------------------------------------------------
 
 #include "WadData.h"
+#include "e_basis.h"
 #include "m_game.h"
 #include "m_loadsave.h"
 #include "w_wad.h"
@@ -77,3 +78,54 @@ TEST(Texture, WadDataGetNullSprite)
     image = wadData.getSprite(config, 1234, loading, 1);
     ASSERT_FALSE(image);
 }
+
+TEST(Texture, ResolveByStringID)
+{
+    ConfigData config;
+    config.miscInfo.sky_flat = "F_SKY1";
+
+    Palette palette;
+    ImageSet images;
+    images.W_AddFlat("FLOOR0_1", Img_c(64, 64));
+    images.W_AddTexture("STARTAN3", Img_c(128, 128), false);
+
+    StringID floorID = BA_InternaliseString("FLOOR0_1");
+    StringID skyID = BA_InternaliseString("F_SKY1");
+    StringID laterID = BA_InternaliseString("FLOOR4_8");
+
+    ResolvedImage res = images.resolveFlat(config, floorID);
+    ASSERT_EQ(res.how, ImageResolve::found);
+    ASSERT_EQ(res.img, images.getFlats().find("FLOOR0_1"));
+
+    ASSERT_TRUE(images.isSkyFlat(config, skyID));
+    res = images.resolveFlat(config, skyID);
+    ASSERT_FALSE(res.img);
+
+    res = images.resolveFlat(config, laterID);
+    ASSERT_EQ(res.how, ImageResolve::unknown);
+    ASSERT_EQ(res.img, &images.IM_UnknownFlat(config));
+
+    // adding images forgets what was resolved
+    images.W_AddFlat("FLOOR4_8", Img_c(64, 64));
+    ASSERT_EQ(images.resolveFlat(config, laterID).how, ImageResolve::found);
+
+    // IDs newer than the table
+    StringID newID = BA_InternaliseString("ResolveByStringID_new");
+    ASSERT_EQ(images.resolveFlat(config, newID).how, ImageResolve::unknown);
+
+    ASSERT_EQ(images.resolveTexture(config, palette, BA_InternaliseString("STARTAN3")).how,
+              ImageResolve::found);
+    ASSERT_EQ(images.resolveTexture(config, palette, BA_InternaliseString("-")).how,
+              ImageResolve::missing);
+    ASSERT_EQ(images.resolveTexture(config, palette, BA_InternaliseString("#1234")).how,
+              ImageResolve::special);
+    ASSERT_EQ(images.resolveTexture(config, palette, BA_InternaliseString("NOSUCH")).how,
+              ImageResolve::unknown);
+
+    // a copy resolves to its own images
+    ImageSet copy = images;
+    res = copy.resolveFlat(config, floorID);
+    ASSERT_EQ(res.how, ImageResolve::found);
+    ASSERT_EQ(res.img, copy.getFlats().find("FLOOR0_1"));
+    ASSERT_NE(res.img, images.resolveFlat(config, floorID).img);
+}